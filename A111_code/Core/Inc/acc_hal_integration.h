@@ -14,4 +14,24 @@
 const acc_hal_t *acc_hal_integration_get_implementation(void);
 
 
+/**
+ * @brief Get the SPI clock frequency of the sensor interface
+ *
+ * @return The SPI clock in Hz
+ */
+uint32_t acc_hal_integration_get_spi_clock_hz(void);
+
+
+/**
+ * @brief Set the SPI clock of the sensor interface
+ *
+ * Selects the fastest SPI clock not above the given maximum at the current bus clock.
+ * Call it between transfers, after the system clock has been changed.
+ *
+ * @param[in] max_clock_hz The highest allowed SPI clock in Hz
+ * @return The SPI clock in Hz
+ */
+uint32_t acc_hal_integration_set_spi_max_clock_hz(uint32_t max_clock_hz);
+
+
 #endif
@@ -4,6 +4,10 @@
 #ifndef ACC_INTEGRATION_LOG_H_
 #define ACC_INTEGRATION_LOG_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "acc_definitions_common.h"
 #include "acc_integration.h"
 
@@ -11,7 +15,24 @@
 #error "acc_integration_log.h and acc_log_rss.h cannot coexist"
 #endif
 
-#define ACC_LOG(level, ...) acc_integration_log(level, MODULE, __VA_ARGS__)
+/**
+ * @brief Lowest severity that is compiled in
+ *
+ * Log statements with a level above this are removed by the compiler together with
+ * their format strings. Override with for example -DACC_INTEGRATION_LOG_LEVEL=ACC_LOG_LEVEL_DEBUG.
+ */
+#ifndef ACC_INTEGRATION_LOG_LEVEL
+#define ACC_INTEGRATION_LOG_LEVEL ACC_LOG_LEVEL_INFO
+#endif
+
+#define ACC_LOG(level, ...) \
+	do \
+	{ \
+		if ((level) <= ACC_INTEGRATION_LOG_LEVEL) \
+		{ \
+			acc_integration_log(level, MODULE, __VA_ARGS__); \
+		} \
+	} while (0)
 
 #define ACC_LOG_ERROR(...)   ACC_LOG(ACC_LOG_LEVEL_ERROR, __VA_ARGS__)
 #define ACC_LOG_WARNING(...) ACC_LOG(ACC_LOG_LEVEL_WARNING, __VA_ARGS__)
@@ -51,4 +72,84 @@
 void acc_integration_log(acc_log_level_t level, const char *module, const char *format, ...) PRINTF_ATTRIBUTE_CHECK(3, 4);
 
 
+/**
+ * @brief Set the runtime log level
+ *
+ * Calls to acc_integration_log with a level above this return before any formatting.
+ * Levels above ACC_INTEGRATION_LOG_LEVEL are never logged through the ACC_LOG macros.
+ * The default is ACC_INTEGRATION_LOG_LEVEL.
+ *
+ * @param[in] level The lowest severity to log
+ */
+void acc_integration_log_level_set(acc_log_level_t level);
+
+
+/**
+ * @brief Get the runtime log level
+ *
+ * @return The lowest severity that is logged
+ */
+acc_log_level_t acc_integration_log_level_get(void);
+
+
+/**
+ * @brief Function used by the deferred log backend to send log records
+ *
+ * @param[in] buffer The data to send
+ * @param[in] buffer_size The number of bytes to send
+ * @return True if the data was sent, or the transfer was started for an asynchronous output
+ */
+typedef bool (*acc_integration_log_write_func_t)(const void *buffer, size_t buffer_size);
+
+
+/**
+ * @brief Log statistics
+ */
+typedef struct
+{
+	/** Number of log records written to the log buffer */
+	uint32_t records;
+	/** Number of log records dropped because the log buffer was full */
+	uint32_t dropped;
+	/** Highest number of bytes used in the log buffer */
+	uint32_t max_used;
+} acc_integration_log_stats_t;
+
+
+/**
+ * @brief Set the output of the deferred log backend
+ *
+ * The default output is a synchronous write to stdout. An asynchronous output, for
+ * example a UART DMA transfer, must call acc_integration_log_output_complete when done.
+ *
+ * @param[in] write_func The output function, NULL for the default output
+ * @param[in] asynchronous True if write_func only starts the transfer
+ */
+void acc_integration_log_output_set(acc_integration_log_write_func_t write_func, bool asynchronous);
+
+
+/**
+ * @brief Signal that an asynchronous log output transfer is complete
+ *
+ * May be called from interrupt context.
+ */
+void acc_integration_log_output_complete(void);
+
+
+/**
+ * @brief Send buffered log records
+ *
+ * Call from idle time. Does nothing for the immediate log backend.
+ */
+void acc_integration_log_drain(void);
+
+
+/**
+ * @brief Get log statistics
+ *
+ * @param[out] stats The log statistics, all zero for the immediate log backend
+ */
+void acc_integration_log_stats_get(acc_integration_log_stats_t *stats);
+
+
 #endif
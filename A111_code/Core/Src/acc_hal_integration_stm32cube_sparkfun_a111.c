@@ -59,7 +59,7 @@ static inline void enable_interrupts(void)
 static volatile bool spi_transfer_complete;
 
 
-void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *h_spi)
+ACC_INTEGRATION_RAM_FUNC void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *h_spi)
 {
 	(void)h_spi;
 	spi_transfer_complete = true;
@@ -73,7 +73,8 @@ void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *h_spi)
 //----------------------------------------
 
 
-static void acc_hal_integration_sensor_transfer(acc_sensor_id_t sensor_id, uint8_t *buffer, size_t buffer_size)
+static ACC_INTEGRATION_RAM_FUNC void acc_hal_integration_sensor_transfer(acc_sensor_id_t sensor_id, uint8_t *buffer,
+                                                                         size_t buffer_size)
 {
 	(void)sensor_id;  // Ignore parameter sensor_id
 
@@ -194,3 +195,32 @@ const acc_hal_t *acc_hal_integration_get_implementation(void)
 {
 	return &hal;
 }
+
+
+uint32_t acc_hal_integration_get_spi_clock_hz(void)
+{
+	// SPI1 is clocked from APB2 and the other SPI peripherals from APB1
+	uint32_t bus_clock_hz = (A111_SPI_HANDLE.Instance == SPI1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+	return bus_clock_hz >> ((A111_SPI_HANDLE.Init.BaudRatePrescaler >> SPI_CR1_BR_Pos) + 1U);
+}
+
+
+uint32_t acc_hal_integration_set_spi_max_clock_hz(uint32_t max_clock_hz)
+{
+	uint32_t bus_clock_hz = (A111_SPI_HANDLE.Instance == SPI1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+	uint32_t baud_rate    = 0U;
+
+	// The prescaler is 2^(BR + 1), BR from 0 to 7
+	while (baud_rate < 7U && (bus_clock_hz >> (baud_rate + 1U)) > max_clock_hz)
+	{
+		baud_rate++;
+	}
+
+	// The baud rate must not change while the SPI is enabled, the HAL enables it again at the next transfer
+	__HAL_SPI_DISABLE(&A111_SPI_HANDLE);
+	A111_SPI_HANDLE.Init.BaudRatePrescaler = baud_rate << SPI_CR1_BR_Pos;
+	MODIFY_REG(A111_SPI_HANDLE.Instance->CR1, SPI_CR1_BR, A111_SPI_HANDLE.Init.BaudRatePrescaler);
+
+	return acc_hal_integration_get_spi_clock_hz();
+}
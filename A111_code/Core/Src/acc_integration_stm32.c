@@ -11,9 +11,24 @@
 #include "main.h"
 
 #include "acc_integration.h"
+#include "acc_integration_log.h"
 
 
+/**
+ * @brief Highest baudrate reported to the module server client
+ *
+ * At 80 MHz the USART kernel clock allows 5 Mbaud with oversampling by 16 and
+ * 10 Mbaud with oversampling by 8. The limit is set by the host side of the
+ * link, run the module_software_example.py baudrate test before raising it.
+ */
+#ifndef STM32_MAX_BAUDRATE
 #define STM32_MAX_BAUDRATE 1000000
+#endif
+
+/**
+ * @brief Baudrate error, in parts per thousand, accepted before switching to oversampling by 8
+ */
+#define UART_MAX_BAUDRATE_ERROR_PPT 10
 
 #define UART_RX_MAX_PACKET_SIZE 10
 
@@ -66,7 +81,24 @@ static inline void enable_interrupts(void)
 
 void acc_integration_sleep_ms(uint32_t time_msec)
 {
-	HAL_Delay(time_msec);
+	uint32_t start = HAL_GetTick();
+
+	// Sleeping is idle time, send any deferred log records first
+	acc_integration_log_drain();
+
+	// Sleep mode between interrupts, the SysTick interrupt wakes the core every ms
+	while (HAL_GetTick() - start < time_msec)
+	{
+		__disable_irq();
+
+		// Check again so that the SysTick did not occur in between
+		if (HAL_GetTick() - start < time_msec)
+		{
+			__WFI();
+		}
+
+		__enable_irq();
+	}
 }
 
 
@@ -74,7 +106,7 @@ void acc_integration_sleep_us(uint32_t time_usec)
 {
 	uint32_t time_msec = (time_usec / 1000) + 1;
 
-	HAL_Delay(time_msec);
+	acc_integration_sleep_ms(time_msec);
 }
 
 
@@ -172,13 +204,60 @@ uint32_t acc_integration_get_max_uart_baudrate(void)
 }
 
 
+/**
+ * @brief Get the baudrate error in parts per thousand for a given divider base
+ *
+ * @param[in] clock The UART kernel clock, multiplied by 2 for oversampling by 8
+ * @param[in] baudrate The wanted baudrate
+ * @return The error of the closest achievable baudrate
+ */
+static uint32_t uart_baudrate_error_ppt(uint32_t clock, uint32_t baudrate)
+{
+	uint32_t divider = (clock + (baudrate / 2)) / baudrate;
+
+	if (divider == 0)
+	{
+		return UINT32_MAX;
+	}
+
+	uint32_t actual = clock / divider;
+	uint32_t diff   = (actual > baudrate) ? (actual - baudrate) : (baudrate - actual);
+
+	return (uint32_t)(((uint64_t)diff * 1000) / baudrate);
+}
+
+
+/**
+ * @brief Select oversampling for a baudrate
+ *
+ * Oversampling by 16 is more tolerant to noise and clock deviation and is used
+ * as long as the divider gets close enough. Oversampling by 8 gives twice the
+ * divider resolution, and twice the max baudrate, for the high rates.
+ */
+static uint32_t uart_oversampling_get(uint32_t baudrate)
+{
+	uint32_t clock = (uart_handle.inst->Instance == USART1) ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+
+	uint32_t error_16 = (baudrate <= clock / 16) ? uart_baudrate_error_ppt(clock, baudrate) : UINT32_MAX;
+	uint32_t error_8  = uart_baudrate_error_ppt(2 * clock, baudrate);
+
+	if (error_16 <= UART_MAX_BAUDRATE_ERROR_PPT || error_16 <= error_8)
+	{
+		return UART_OVERSAMPLING_16;
+	}
+
+	return UART_OVERSAMPLING_8;
+}
+
+
 void acc_integration_uart_set_baudrate(uint32_t baudrate)
 {
 	if (baudrate <= STM32_MAX_BAUDRATE)
 	{
 		HAL_UART_AbortReceive(uart_handle.inst);
 		HAL_UART_DeInit(uart_handle.inst);
-		uart_handle.inst->Init.BaudRate = baudrate;
+		uart_handle.inst->Init.BaudRate     = baudrate;
+		uart_handle.inst->Init.OverSampling = uart_oversampling_get(baudrate);
 		if (HAL_UART_Init(uart_handle.inst) != HAL_OK)
 		{
 			Error_Handler();
@@ -283,6 +362,39 @@ uint32_t acc_integration_get_time(void)
 }
 
 
+uint32_t acc_integration_get_time_us(void)
+{
+	uint32_t tick;
+	uint32_t counter;
+
+	// Read again if the SysTick wrapped in between, the tick interrupt has then incremented the tick
+	do
+	{
+		tick    = HAL_GetTick();
+		counter = SysTick->VAL;
+	} while (tick != HAL_GetTick());
+
+	// The SysTick counts down from LOAD to 0 every tick
+	uint32_t reload = SysTick->LOAD + 1;
+
+	return (tick * 1000) + (uint32_t)(((uint64_t)(reload - 1 - counter) * 1000) / reload);
+}
+
+
+uint32_t acc_integration_get_cycle_count(void)
+{
+	// Start the DWT cycle counter at the first call
+	if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+	{
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT       = 0;
+		DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	return DWT->CYCCNT;
+}
+
+
 void *acc_integration_mem_alloc(size_t size)
 {
 	return malloc(size);
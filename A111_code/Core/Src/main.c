@@ -55,6 +55,10 @@ static void MX_SPI1_Init(void);
 static void MX_USART2_UART_Init(void);
 /* USER CODE BEGIN PFP */
 extern int acc_ref_app_rf_certification_test(int argc, char *argv[]);
+#ifdef ACC_APP_MAIN
+/* Application selected by the CMake build with ACC_APP */
+extern int ACC_APP_MAIN(int argc, char *argv[]);
+#endif
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -104,8 +108,12 @@ int main(void) {
 	MX_SPI1_Init();
 	MX_USART2_UART_Init();
 	/* USER CODE BEGIN 2 */
+#ifdef ACC_APP_MAIN
+	ACC_APP_MAIN(0, NULL);
+#else
 	acc_example_assembly_test(0, NULL);
 	acc_ref_app_rf_certification_test(0, NULL);
+#endif
 	/* USER CODE END 2 */
 
 	/* Infinite loop */
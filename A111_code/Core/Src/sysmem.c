@@ -47,11 +47,27 @@ static uint8_t *__sbrk_heap_end = NULL;
  * NOTE: If the MSP stack, at any point during execution, grows larger than the
  * reserved size, please increase the '_Min_Stack_Size'.
  *
+ * With ACC_INTEGRATION_HEAP_IN_SRAM2 defined the heap is instead placed in
+ * SRAM2, from the '_sram2_heap' linker symbol after the SRAM2 sections up to
+ * the '_eram2' linker symbol, and SRAM1 is left to the data and the stack.
+ *
  * @param incr Memory size
  * @return Pointer to allocated memory
  */
 void *_sbrk(ptrdiff_t incr)
 {
+#ifdef ACC_INTEGRATION_HEAP_IN_SRAM2
+  extern uint8_t _sram2_heap; /* Symbol defined in the linker script */
+  extern uint8_t _eram2; /* Symbol defined in the linker script */
+  const uint8_t *max_heap = &_eram2;
+  uint8_t *prev_heap_end;
+
+  /* Initialize heap end at first call */
+  if (NULL == __sbrk_heap_end)
+  {
+    __sbrk_heap_end = &_sram2_heap;
+  }
+#else
   extern uint8_t _end; /* Symbol defined in the linker script */
   extern uint8_t _estack; /* Symbol defined in the linker script */
   extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
@@ -64,6 +80,7 @@ void *_sbrk(ptrdiff_t incr)
   {
     __sbrk_heap_end = &_end;
   }
+#endif
 
   /* Protect heap from growing into the reserved MSP stack */
   if (__sbrk_heap_end + incr > max_heap)
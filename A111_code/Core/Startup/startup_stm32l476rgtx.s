@@ -44,6 +44,17 @@ defined in linker script */
 .word	_sbss
 /* end address for the .bss section. defined in linker script */
 .word	_ebss
+/* start address for the initialization values of the .ram2_text section.
+defined in linker script */
+.word	_siram2_text
+/* start address for the .ram2_text section. defined in linker script */
+.word	_sram2_text
+/* end address for the .ram2_text section. defined in linker script */
+.word	_eram2_text
+/* start address for the .ram2_bss section. defined in linker script */
+.word	_sram2_bss
+/* end address for the .ram2_bss section. defined in linker script */
+.word	_eram2_bss
 
 .equ  BootRAM,        0xF1E0F85F
 /**
@@ -95,6 +106,37 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy the RAM2 code from flash to SRAM2 */
+  ldr r0, =_sram2_text
+  ldr r1, =_eram2_text
+  ldr r2, =_siram2_text
+  movs r3, #0
+  b LoopCopyRam2TextInit
+
+CopyRam2TextInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyRam2TextInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyRam2TextInit
+
+/* Zero fill the RAM2 data */
+  ldr r2, =_sram2_bss
+  ldr r4, =_eram2_bss
+  movs r3, #0
+  b LoopFillZeroRam2bss
+
+FillZeroRam2bss:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroRam2bss:
+  cmp r2, r4
+  bcc FillZeroRam2bss
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -0,0 +1,102 @@
+# Host build of the processing libraries and benchmarks
+#
+# RSS is only available for Cortex-M4, so the host build covers the applications that
+# use the processing libraries only. acc_integration_host.c implements the integration
+# on POSIX, acc_integration_get_cycle_count returns the time in ns.
+
+set(ACC_APP_SOURCE "${ACC_EXAMPLES}/${ACC_APP}.c")
+
+if(NOT EXISTS "${ACC_APP_SOURCE}")
+	message(FATAL_ERROR "ACC_APP ${ACC_APP} not found in ${ACC_EXAMPLES}")
+endif()
+
+file(STRINGS "${ACC_APP_SOURCE}" ACC_APP_RSS_INCLUDES REGEX "#include \"acc_(rss|service|detector|hal_integration)")
+
+if(ACC_APP_RSS_INCLUDES)
+	message(FATAL_ERROR "ACC_APP ${ACC_APP} uses RSS and can only be built for the target")
+endif()
+
+add_library(acc_integration_host STATIC
+	${ACC_ROOT}/integration/acc_integration_host.c)
+
+target_link_libraries(acc_integration_host PUBLIC acc_processing m)
+target_compile_options(acc_integration_host PRIVATE ${ACC_WARNING_FLAGS})
+set_target_properties(acc_integration_host PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+
+# Host binary of an application, named as the application
+function(acc_add_host_app app)
+	add_executable(${app}
+		${ACC_ROOT}/integration/acc_integration_host_main.c
+		${ACC_EXAMPLES}/${app}.c)
+
+	target_compile_definitions(${app} PRIVATE ACC_APP_MAIN=acc_${app})
+	target_compile_options(${app} PRIVATE ${ACC_WARNING_FLAGS})
+	target_link_libraries(${app} PRIVATE acc_integration_host)
+	set_target_properties(${app} PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+endfunction()
+
+acc_add_host_app(${ACC_APP})
+
+if(NOT ACC_APP STREQUAL "example_benchmark_dsp")
+	acc_add_host_app(example_benchmark_dsp)
+endif()
+
+# %f of the module software printf, with the integer only formatter of the module build
+# and with the double formatter
+set(ACC_MODULE_SOFTWARE "${CMAKE_CURRENT_SOURCE_DIR}/stm32l476_module_software")
+
+function(acc_add_printf_benchmark name variant)
+	add_executable(${name}
+		${ACC_MODULE_SOFTWARE}/bench/printf_benchmark.c
+		${ACC_MODULE_SOFTWARE}/Src/printf.c)
+
+	target_compile_definitions(${name} PRIVATE PRINTF_DISABLE_SUPPORT_EXPONENTIAL PRINTF_BENCHMARK_VARIANT="${variant}" ${ARGN})
+	target_include_directories(${name} PRIVATE ${ACC_MODULE_SOFTWARE}/Inc)
+	target_link_libraries(${name} PRIVATE acc_integration_host)
+	set_source_files_properties(${ACC_MODULE_SOFTWARE}/bench/printf_benchmark.c PROPERTIES COMPILE_OPTIONS "${ACC_WARNING_FLAGS}")
+	set_target_properties(${name} PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+endfunction()
+
+acc_add_printf_benchmark(printf_benchmark_fixed_point "fixed point" PRINTF_DISABLE_SUPPORT_FLOAT)
+acc_add_printf_benchmark(printf_benchmark_double "double" PRINTF_DISABLE_SUPPORT_FLOAT_FIXED_POINT)
+
+# Tests of the processing kernels, run with ctest. The sparse DSP test is built with the
+# portable C kernels and with the DSP extension kernels on emulated intrinsics, both are
+# compared with a scalar reference. The sources are built into each test so that the
+# ACC_SIMD_DISABLE option of acc_processing does not apply.
+enable_testing()
+
+function(acc_add_sparse_dsp_test name kernel)
+	add_executable(${name}
+		${ACC_ROOT}/test/test_sparse_dsp.c
+		${ACC_EXAMPLES}/acc_sparse_dsp.c
+		${ACC_ROOT}/integration/acc_integration_host.c)
+
+	target_compile_definitions(${name} PRIVATE TEST_SPARSE_DSP_KERNEL="${kernel}" ${ARGN})
+	target_include_directories(${name} PRIVATE ${ACC_ROOT}/integration ${ACC_ROOT}/rss/include ${ACC_EXAMPLES})
+	target_compile_options(${name} PRIVATE ${ACC_WARNING_FLAGS})
+	target_link_libraries(${name} PRIVATE m)
+	set_target_properties(${name} PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+
+	add_test(NAME ${name} COMMAND ${name})
+endfunction()
+
+acc_add_sparse_dsp_test(test_sparse_dsp_portable "portable C" ACC_SIMD_DISABLE)
+acc_add_sparse_dsp_test(test_sparse_dsp_dsp_extension "DSP extension" __ARM_FEATURE_DSP=1)
+target_include_directories(test_sparse_dsp_dsp_extension BEFORE PRIVATE ${ACC_ROOT}/test/cmsis_emulation)
+
+add_custom_target(run_benchmarks
+	COMMAND example_benchmark_dsp
+	COMMAND printf_benchmark_fixed_point
+	COMMAND printf_benchmark_double
+	COMMENT "Benchmarking the processing libraries and the printf %f formatters"
+	USES_TERMINAL)
+
+if(Python3_Interpreter_FOUND)
+	add_custom_command(TARGET run_benchmarks POST_BUILD
+		COMMAND ${Python3_EXECUTABLE} ${ACC_SCRIPTS}/time_budget.py
+			--name "envelope 1 m" --service envelope --start 0.2 --length 1.0 --update-rate 10
+		COMMAND ${Python3_EXECUTABLE} ${ACC_SCRIPTS}/time_budget.py
+			--name "sparse 32 sweeps" --service sparse --sweeps-per-frame 32 --sweep-rate 3000 --update-rate 60
+		COMMENT "Estimating the time budget of the nominal configurations")
+endif()
@@ -0,0 +1,150 @@
+# Target build of the firmware for the STM32L476
+#
+# The board files come from the CubeMX project in ACC_BOARD_DIR, the sensor integration
+# from cortex_m4/integration. Core is the project of the Sparkfun A111 board, the other
+# integrations need the project of their board, with the pins of that board in main.h.
+# Each application is linked with its own main.c object, where ACC_APP_MAIN selects the
+# application that is run after the board initialization.
+
+set(ACC_BOARD_SOURCES
+	${ACC_BOARD_DIR}/Src/stm32l4xx_hal_msp.c
+	${ACC_BOARD_DIR}/Src/stm32l4xx_it.c
+	${ACC_BOARD_DIR}/Src/syscalls.c
+	${ACC_BOARD_DIR}/Src/sysmem.c
+	${ACC_BOARD_DIR}/Src/system_stm32l4xx.c
+	${ACC_BOARD_DIR}/Startup/startup_stm32l476rgtx.s)
+
+foreach(source ${ACC_BOARD_SOURCES})
+	if(NOT EXISTS "${source}")
+		message(FATAL_ERROR "${source} not found, ACC_BOARD_DIR must be a CubeMX project of the board")
+	endif()
+endforeach()
+
+if(NOT ACC_INTEGRATION MATCHES "sparkfun_a111$" AND ACC_BOARD_DIR STREQUAL "${CMAKE_CURRENT_SOURCE_DIR}/Core")
+	message(FATAL_ERROR "ACC_INTEGRATION ${ACC_INTEGRATION} needs ACC_BOARD_DIR set to the CubeMX project of the board")
+endif()
+
+set(ACC_DRIVER_DIR "${CMAKE_CURRENT_SOURCE_DIR}/Drivers/STM32L4xx_HAL_Driver")
+
+file(GLOB ACC_DRIVER_SOURCES "${ACC_DRIVER_DIR}/Src/*.c")
+
+set(ACC_LINKER_SCRIPT "${CMAKE_CURRENT_SOURCE_DIR}/STM32L476RGTX_FLASH.ld")
+
+# RSS and the C library are linked last, in a group as they depend on each other and on
+# the system calls of the board
+add_library(acc_rss INTERFACE)
+
+target_link_libraries(acc_rss INTERFACE
+	-Wl,--start-group
+	${ACC_ROOT}/rss/lib/libacc_detector_distance.a
+	${ACC_ROOT}/rss/lib/libacc_detector_presence.a
+	${ACC_ROOT}/rss/lib/libacc_rf_certification_test_a111.a
+	${ACC_ROOT}/rss/lib/libacconeer.a
+	-lc -lm
+	-Wl,--end-group)
+
+# The CubeMX generated code is built as in the STM32CubeIDE project
+add_library(acc_board STATIC ${ACC_BOARD_SOURCES} ${ACC_DRIVER_SOURCES})
+
+target_link_libraries(acc_board PUBLIC acc_rss)
+target_compile_definitions(acc_board PUBLIC STM32L476xx USE_HAL_DRIVER)
+target_include_directories(acc_board PUBLIC
+	${ACC_ROOT}/integration
+	${ACC_ROOT}/rss/include
+	${ACC_BOARD_DIR}/Inc
+	${ACC_DRIVER_DIR}/Inc
+	${ACC_DRIVER_DIR}/Inc/Legacy
+	${CMAKE_CURRENT_SOURCE_DIR}/Drivers/CMSIS/Device/ST/STM32L4xx/Include
+	${CMAKE_CURRENT_SOURCE_DIR}/Drivers/CMSIS/Include)
+set_target_properties(acc_board PROPERTIES C_STANDARD 99 C_EXTENSIONS ON)
+
+if(ACC_INTEGRATION_NO_RAM_PLACEMENT)
+	target_compile_definitions(acc_board PUBLIC ACC_INTEGRATION_NO_RAM_PLACEMENT)
+endif()
+
+if(ACC_INTEGRATION_LOG_DEFERRED)
+	set(ACC_INTEGRATION_LOG_SOURCE ${ACC_ROOT}/integration/acc_integration_log_deferred.c)
+else()
+	set(ACC_INTEGRATION_LOG_SOURCE ${ACC_ROOT}/integration/acc_integration_log.c)
+endif()
+
+add_library(acc_integration STATIC
+	${ACC_ROOT}/integration/acc_hal_integration_stm32cube_${ACC_INTEGRATION}.c
+	${ACC_ROOT}/integration/acc_integration_clock_stm32.c
+	${ACC_ROOT}/integration/acc_integration_crc.c
+	${ACC_ROOT}/integration/acc_integration_stm32.c
+	${ACC_ROOT}/integration/acc_integration_sweep_dump.c
+	${ACC_ROOT}/integration/acc_integration_sweep_dump_stm32.c
+	${ACC_INTEGRATION_LOG_SOURCE})
+
+target_compile_options(acc_integration PRIVATE ${ACC_WARNING_FLAGS})
+target_link_libraries(acc_integration PUBLIC acc_board)
+set_target_properties(acc_integration PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+
+# The example libraries that use RSS, in addition to acc_processing
+add_library(acc_examples STATIC
+	${ACC_EXAMPLES}/acc_cascade.c
+	${ACC_EXAMPLES}/acc_gain_controller.c
+	${ACC_EXAMPLES}/acc_presence_engine.c
+	${ACC_EXAMPLES}/acc_preset.c
+	${ACC_EXAMPLES}/acc_recovery_manager.c
+	${ACC_EXAMPLES}/acc_time_budget.c)
+
+target_compile_options(acc_examples PRIVATE ${ACC_WARNING_FLAGS})
+target_link_libraries(acc_examples PUBLIC acc_processing acc_integration)
+set_target_properties(acc_examples PROPERTIES C_STANDARD 99 C_STANDARD_REQUIRED ON C_EXTENSIONS OFF)
+
+# Firmware of an application, <app>.elf and <app>.hex, with a section size report
+function(acc_add_firmware app)
+	if(NOT EXISTS "${ACC_EXAMPLES}/${app}.c")
+		message(FATAL_ERROR "Application ${app} not found in ${ACC_EXAMPLES}")
+	endif()
+
+	add_executable(${app}
+		${ACC_BOARD_DIR}/Src/main.c
+		${ACC_EXAMPLES}/${app}.c)
+
+	set_target_properties(${app} PROPERTIES SUFFIX ".elf" C_STANDARD 99 C_EXTENSIONS ON)
+	set_source_files_properties(${ACC_EXAMPLES}/${app}.c PROPERTIES COMPILE_OPTIONS "${ACC_WARNING_FLAGS}")
+	target_compile_definitions(${app} PRIVATE ACC_APP_MAIN=acc_${app})
+
+	if(ACC_EXAMPLE_SWEEP_DUMP)
+		target_compile_definitions(${app} PRIVATE ACC_EXAMPLE_SWEEP_DUMP)
+	endif()
+	target_link_options(${app} PRIVATE
+		-T ${ACC_LINKER_SCRIPT}
+		-Wl,-Map=$<TARGET_FILE_DIR:${app}>/${app}.map)
+	target_link_libraries(${app} PRIVATE acc_examples)
+	set_property(TARGET ${app} APPEND PROPERTY LINK_DEPENDS ${ACC_LINKER_SCRIPT})
+
+	add_custom_command(TARGET ${app} POST_BUILD
+		COMMAND ${CMAKE_OBJCOPY} -O ihex $<TARGET_FILE:${app}> $<TARGET_FILE_DIR:${app}>/${app}.hex
+		COMMAND ${CMAKE_SIZE} $<TARGET_FILE:${app}>)
+
+	if(Python3_Interpreter_FOUND)
+		add_custom_command(TARGET ${app} POST_BUILD
+			COMMAND ${Python3_EXECUTABLE} ${ACC_SCRIPTS}/section_report.py $<TARGET_FILE:${app}>)
+	endif()
+endfunction()
+
+acc_add_firmware(${ACC_APP})
+
+# Firmware of the benchmark applications, flash one of them and capture its output to
+# compare the results of a change
+set(ACC_BENCHMARK_APPS
+	example_benchmark_dsp
+	example_clock_profile
+	example_envelope_preprocess
+	example_service_sparse_dsp
+	example_time_budget)
+
+add_custom_target(benchmarks)
+
+foreach(app ${ACC_BENCHMARK_APPS})
+	if(NOT app STREQUAL ACC_APP)
+		acc_add_firmware(${app})
+		set_target_properties(${app} PROPERTIES EXCLUDE_FROM_ALL ON)
+	endif()
+
+	add_dependencies(benchmarks ${app})
+endforeach()
@@ -0,0 +1,38 @@
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+
+# Toolchain for the STM32L476, Cortex-M4 with single precision FPU, with the GNU Arm
+# Embedded toolchain. Set ACC_TOOLCHAIN_PATH to its bin directory if it is not in PATH.
+#
+#   cmake -S . -B build_m4 -DCMAKE_TOOLCHAIN_FILE=cmake/toolchain_cortex_m4.cmake
+
+set(CMAKE_SYSTEM_NAME      Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(ACC_TOOLCHAIN_PATH "" CACHE PATH "Directory of the arm-none-eabi tools, empty to search PATH")
+
+if(ACC_TOOLCHAIN_PATH)
+	set(ACC_TOOLCHAIN_PREFIX "${ACC_TOOLCHAIN_PATH}/arm-none-eabi-")
+else()
+	set(ACC_TOOLCHAIN_PREFIX "arm-none-eabi-")
+endif()
+
+set(CMAKE_C_COMPILER   "${ACC_TOOLCHAIN_PREFIX}gcc")
+set(CMAKE_ASM_COMPILER "${ACC_TOOLCHAIN_PREFIX}gcc")
+set(CMAKE_AR           "${ACC_TOOLCHAIN_PREFIX}gcc-ar")
+set(CMAKE_RANLIB       "${ACC_TOOLCHAIN_PREFIX}gcc-ranlib")
+set(CMAKE_OBJCOPY      "${ACC_TOOLCHAIN_PREFIX}objcopy")
+set(CMAKE_SIZE         "${ACC_TOOLCHAIN_PREFIX}size")
+
+# The compiler checks link without the linker script of the application
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(ACC_CPU_FLAGS "-mcpu=cortex-m4 -mthumb -mfloat-abi=hard -mfpu=fpv4-sp-d16")
+
+set(CMAKE_C_FLAGS_INIT          "${ACC_CPU_FLAGS} -ffunction-sections -fdata-sections -fno-math-errno")
+set(CMAKE_ASM_FLAGS_INIT        "${ACC_CPU_FLAGS} -x assembler-with-cpp")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "${ACC_CPU_FLAGS} --specs=nano.specs --specs=nosys.specs -Wl,--gc-sections -static")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
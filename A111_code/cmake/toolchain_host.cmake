@@ -0,0 +1,11 @@
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+
+# Toolchain for host builds of the processing libraries and benchmarks with the system
+# GCC or Clang. This is also the default when no toolchain file is given.
+#
+#   cmake -S . -B build_host -DCMAKE_TOOLCHAIN_FILE=cmake/toolchain_host.cmake
+
+find_program(ACC_HOST_CC NAMES gcc clang cc REQUIRED)
+
+set(CMAKE_C_COMPILER "${ACC_HOST_CC}")
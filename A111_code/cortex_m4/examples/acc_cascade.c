@@ -0,0 +1,318 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_cascade.h"
+#include "acc_frame_scheduler.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_power_bins.h"
+
+
+#define DEFAULT_TRIGGER_RATE_HZ  2.0f
+#define DEFAULT_BASELINE_FRAMES  8
+#define DEFAULT_BASELINE_FACTOR  0.05f
+#define DEFAULT_THRESHOLD        0.5f
+#define DEFAULT_QUIET_TIMEOUT_MS 5000
+
+// Lowest baseline used for the relative deviation, avoids a division by zero
+#define MIN_BASELINE 1.0f
+
+
+static const char *stage_names[ACC_CASCADE_STAGE_COUNT] = { "Trigger", "Pipeline" };
+
+
+/**
+ * @brief Add the time since the last accounting to the active stage
+ */
+static void account(acc_cascade_t *cascade, uint32_t now)
+{
+	acc_cascade_stats_t *stats      = &cascade->stats[cascade->stage];
+	uint32_t            elapsed_ms = now - cascade->stage_start_ms;
+
+	stats->time_ms          += elapsed_ms;
+	stats->charge_uc        += cascade->config.current_ua[cascade->stage] * (float)elapsed_ms / 1000.0f;
+	cascade->stage_start_ms  = now;
+}
+
+
+static float stage_rate(const acc_cascade_t *cascade, acc_cascade_stage_t stage)
+{
+	return (stage == ACC_CASCADE_STAGE_TRIGGER) ? cascade->config.trigger_rate_hz : cascade->pipeline.rate_hz;
+}
+
+
+static bool stage_activate(acc_cascade_t *cascade, acc_cascade_stage_t stage)
+{
+	if (stage == ACC_CASCADE_STAGE_TRIGGER)
+	{
+		return acc_service_activate(cascade->power_bins);
+	}
+
+	return cascade->pipeline.activate(cascade->pipeline.client_reference);
+}
+
+
+static bool stage_deactivate(acc_cascade_t *cascade, acc_cascade_stage_t stage)
+{
+	if (stage == ACC_CASCADE_STAGE_TRIGGER)
+	{
+		return acc_service_deactivate(cascade->power_bins);
+	}
+
+	return cascade->pipeline.deactivate(cascade->pipeline.client_reference);
+}
+
+
+static bool switch_stage(acc_cascade_t *cascade, acc_cascade_stage_t stage, uint32_t now)
+{
+	if (!stage_deactivate(cascade, cascade->stage))
+	{
+		return false;
+	}
+
+	if (cascade->stage == ACC_CASCADE_STAGE_PIPELINE && !cascade->activity_seen)
+	{
+		cascade->stats[ACC_CASCADE_STAGE_PIPELINE].false_triggers++;
+	}
+
+	cascade->stage               = stage;
+	cascade->transition_pending  = true;
+	cascade->transition_start_ms = now;
+	cascade->stats[stage].entries++;
+
+	if (stage == ACC_CASCADE_STAGE_TRIGGER)
+	{
+		// The scene may have changed while the pipeline was running
+		cascade->baseline_count = 0;
+	}
+	else
+	{
+		cascade->activity_seen    = false;
+		cascade->last_activity_ms = now;
+	}
+
+	acc_frame_scheduler_rate_set(&cascade->scheduler, stage_rate(cascade, stage));
+
+	return stage_activate(cascade, stage);
+}
+
+
+/**
+ * @brief Compare a power bins frame with the baseline
+ *
+ * @return True if the pipeline should be started
+ */
+static bool trigger_update(acc_cascade_t *cascade, const uint16_t *data)
+{
+	if (cascade->baseline_count < cascade->config.baseline_frames)
+	{
+		float weight = 1.0f / (float)(cascade->baseline_count + 1);
+
+		for (uint16_t i = 0; i < cascade->bin_count; i++)
+		{
+			float baseline = (cascade->baseline_count == 0) ? 0.0f : cascade->baseline[i];
+
+			cascade->baseline[i] = baseline + (((float)data[i] - baseline) * weight);
+		}
+
+		cascade->baseline_count++;
+		cascade->deviation = 0.0f;
+
+		return false;
+	}
+
+	float deviation = 0.0f;
+
+	for (uint16_t i = 0; i < cascade->bin_count; i++)
+	{
+		float baseline   = (cascade->baseline[i] > MIN_BASELINE) ? cascade->baseline[i] : MIN_BASELINE;
+		float difference = (float)data[i] - cascade->baseline[i];
+		float relative   = ((difference < 0.0f) ? -difference : difference) / baseline;
+
+		deviation = (relative > deviation) ? relative : deviation;
+	}
+
+	cascade->deviation = deviation;
+
+	if (deviation > cascade->config.threshold)
+	{
+		return true;
+	}
+
+	for (uint16_t i = 0; i < cascade->bin_count; i++)
+	{
+		cascade->baseline[i] += ((float)data[i] - cascade->baseline[i]) * cascade->config.baseline_factor;
+	}
+
+	return false;
+}
+
+
+void acc_cascade_config_default(acc_cascade_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+
+	config->trigger_rate_hz  = DEFAULT_TRIGGER_RATE_HZ;
+	config->baseline_frames  = DEFAULT_BASELINE_FRAMES;
+	config->baseline_factor  = DEFAULT_BASELINE_FACTOR;
+	config->threshold        = DEFAULT_THRESHOLD;
+	config->quiet_timeout_ms = DEFAULT_QUIET_TIMEOUT_MS;
+}
+
+
+bool acc_cascade_create(acc_cascade_t *cascade, acc_service_configuration_t power_bins_configuration,
+                        const acc_cascade_pipeline_t *pipeline, const acc_cascade_config_t *config)
+{
+	memset(cascade, 0, sizeof(*cascade));
+
+	cascade->config   = *config;
+	cascade->pipeline = *pipeline;
+	cascade->stage    = ACC_CASCADE_STAGE_TRIGGER;
+
+	// Allow the power bins service next to the pipeline on the same sensor, only one is active at a time
+	acc_rss_override_sensor_id_check_at_creation(true);
+
+	cascade->power_bins = acc_service_create(power_bins_configuration);
+
+	// The override is global in RSS, other services and detectors get the normal check again
+	acc_rss_override_sensor_id_check_at_creation(false);
+
+	if (cascade->power_bins == NULL)
+	{
+		return false;
+	}
+
+	acc_service_power_bins_metadata_t metadata = { 0 };
+	acc_service_power_bins_get_metadata(cascade->power_bins, &metadata);
+
+	cascade->bin_count = (metadata.bin_count < ACC_CASCADE_MAX_BINS) ? metadata.bin_count : ACC_CASCADE_MAX_BINS;
+
+	acc_frame_scheduler_init(&cascade->scheduler, config->trigger_rate_hz);
+
+	if (!acc_service_activate(cascade->power_bins))
+	{
+		acc_service_destroy(&cascade->power_bins);
+		return false;
+	}
+
+	cascade->stats[ACC_CASCADE_STAGE_TRIGGER].entries = 1;
+	cascade->stage_start_ms                           = acc_integration_get_time();
+
+	return true;
+}
+
+
+void acc_cascade_destroy(acc_cascade_t *cascade)
+{
+	if (cascade->power_bins == NULL)
+	{
+		return;
+	}
+
+	stage_deactivate(cascade, cascade->stage);
+	acc_service_destroy(&cascade->power_bins);
+}
+
+
+bool acc_cascade_update(acc_cascade_t *cascade, acc_cascade_stage_t *stage, bool *activity)
+{
+	acc_frame_scheduler_wait(&cascade->scheduler);
+
+	*activity = false;
+
+	if (cascade->stage == ACC_CASCADE_STAGE_TRIGGER)
+	{
+		uint16_t                             *data;
+		acc_service_power_bins_result_info_t result_info;
+
+		if (!acc_service_power_bins_get_next_by_reference(cascade->power_bins, &data, &result_info))
+		{
+			return false;
+		}
+
+		*activity = trigger_update(cascade, data);
+	}
+	else if (!cascade->pipeline.get_next(cascade->pipeline.client_reference, activity))
+	{
+		return false;
+	}
+
+	uint32_t            now    = acc_integration_get_time();
+	acc_cascade_stats_t *stats = &cascade->stats[cascade->stage];
+
+	if (cascade->transition_pending)
+	{
+		uint32_t latency = now - cascade->transition_start_ms;
+
+		stats->last_latency_ms      = latency;
+		stats->max_latency_ms       = (latency > stats->max_latency_ms) ? latency : stats->max_latency_ms;
+		cascade->transition_pending = false;
+	}
+
+	stats->frames++;
+	account(cascade, now);
+
+	*stage = cascade->stage;
+
+	if (cascade->stage == ACC_CASCADE_STAGE_TRIGGER)
+	{
+		return *activity ? switch_stage(cascade, ACC_CASCADE_STAGE_PIPELINE, now) : true;
+	}
+
+	if (*activity)
+	{
+		cascade->activity_seen    = true;
+		cascade->last_activity_ms = now;
+	}
+	else if (now - cascade->last_activity_ms >= cascade->config.quiet_timeout_ms)
+	{
+		return switch_stage(cascade, ACC_CASCADE_STAGE_TRIGGER, now);
+	}
+
+	return true;
+}
+
+
+const acc_cascade_stats_t *acc_cascade_stats_get(const acc_cascade_t *cascade, acc_cascade_stage_t stage)
+{
+	return &cascade->stats[stage];
+}
+
+
+void acc_cascade_stats_print(const acc_cascade_t *cascade)
+{
+	uint32_t total_ms = 0;
+	float    total_uc = 0.0f;
+
+	for (acc_cascade_stage_t stage = 0; stage < ACC_CASCADE_STAGE_COUNT; stage++)
+	{
+		const acc_cascade_stats_t *stats = &cascade->stats[stage];
+
+		printf("%s: %u entries, %u frames, %u ms, %u uC, latency %u ms (max %u ms), %u false triggers\n",
+		       stage_names[stage],
+		       (unsigned int)stats->entries,
+		       (unsigned int)stats->frames,
+		       (unsigned int)stats->time_ms,
+		       (unsigned int)stats->charge_uc,
+		       (unsigned int)stats->last_latency_ms,
+		       (unsigned int)stats->max_latency_ms,
+		       (unsigned int)stats->false_triggers);
+
+		total_ms += stats->time_ms;
+		total_uc += stats->charge_uc;
+	}
+
+	if (total_ms > 0)
+	{
+		printf("Average current: %u uA\n", (unsigned int)(total_uc * 1000.0f / (float)total_ms));
+	}
+}
@@ -0,0 +1,208 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_CASCADE_H_
+#define ACC_CASCADE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "acc_frame_scheduler.h"
+#include "acc_service.h"
+
+
+/**
+ * Power bins cascade controller
+ *
+ * The controller runs the power bins service at a low rate with a few bins as a trigger
+ * stage. A baseline of each bin is learned over the first frames and then follows slow
+ * changes. When a bin deviates from its baseline by more than the threshold, the trigger
+ * stage is deactivated and an expensive pipeline, for example the distance or presence
+ * detector, is activated. When the pipeline has reported no activity for the quiet
+ * timeout, the controller drops back to the trigger stage and learns a new baseline.
+ *
+ * The pipeline is any service or detector created by the caller, with
+ * acc_service_create or acc_detector_*_create, wrapped in acc_cascade_pipeline_t. The
+ * pipeline must be created on the same sensor before the cascade and must be inactive.
+ * Both stages are created up front, with the sensor id check at creation overridden, so
+ * a transition is only a deactivate and an activate.
+ *
+ * The frames of each stage are paced with the frame scheduler at the rate of the stage.
+ * The time and frames spent in each stage and the latency from the triggering frame to
+ * the first pipeline result are accounted. The charge is estimated from the average
+ * current of each stage given in the configuration, as it can not be measured in
+ * software.
+ */
+
+
+#define ACC_CASCADE_MAX_BINS 8
+
+
+/**
+ * @brief Stage of the cascade
+ */
+typedef enum
+{
+	ACC_CASCADE_STAGE_TRIGGER,
+	ACC_CASCADE_STAGE_PIPELINE,
+	ACC_CASCADE_STAGE_COUNT
+} acc_cascade_stage_t;
+
+
+/**
+ * @brief The expensive pipeline started by the trigger stage
+ */
+typedef struct
+{
+	/** Activate the pipeline */
+	bool  (*activate)(void *client_reference);
+	/** Deactivate the pipeline */
+	bool  (*deactivate)(void *client_reference);
+	/** Wait for and process the next frame of the pipeline, set activity if something was detected */
+	bool  (*get_next)(void *client_reference, bool *activity);
+	/** Passed to the functions above */
+	void  *client_reference;
+	/** Frame rate of the pipeline */
+	float rate_hz;
+} acc_cascade_pipeline_t;
+
+
+/**
+ * @brief Cascade configuration
+ */
+typedef struct
+{
+	/** Frame rate of the trigger stage */
+	float    trigger_rate_hz;
+	/** Number of frames averaged into a new baseline */
+	uint16_t baseline_frames;
+	/** Weight of a new frame in the baseline after it has been learned, 0 keeps the baseline fixed */
+	float    baseline_factor;
+	/** Relative deviation of a bin from its baseline that starts the pipeline */
+	float    threshold;
+	/** Time without activity in the pipeline before returning to the trigger stage in ms */
+	uint32_t quiet_timeout_ms;
+	/** Average current of each stage in uA, used for the charge estimate */
+	float    current_ua[ACC_CASCADE_STAGE_COUNT];
+} acc_cascade_config_t;
+
+
+/**
+ * @brief Cascade statistics, per stage
+ */
+typedef struct
+{
+	/** Number of times the stage was entered */
+	uint32_t entries;
+	/** Number of frames in the stage */
+	uint32_t frames;
+	/** Time spent in the stage in ms */
+	uint32_t time_ms;
+	/** Estimated charge used in the stage in uC */
+	float    charge_uc;
+	/** Time from the frame that switched to the stage to the first frame of the stage in ms */
+	uint32_t last_latency_ms;
+	/** Highest latency in ms */
+	uint32_t max_latency_ms;
+	/** Number of times the stage was left without any activity, only used for the pipeline */
+	uint32_t false_triggers;
+} acc_cascade_stats_t;
+
+
+/**
+ * @brief Cascade controller
+ */
+typedef struct
+{
+	acc_cascade_config_t   config;
+	acc_cascade_pipeline_t pipeline;
+	acc_service_handle_t   power_bins;
+	uint16_t               bin_count;
+	float                  baseline[ACC_CASCADE_MAX_BINS];
+	uint16_t               baseline_count;
+	float                  deviation;
+	acc_cascade_stage_t    stage;
+	bool                   activity_seen;
+	bool                   transition_pending;
+	uint32_t               transition_start_ms;
+	uint32_t               stage_start_ms;
+	uint32_t               last_activity_ms;
+	acc_frame_scheduler_t  scheduler;
+
+	acc_cascade_stats_t stats[ACC_CASCADE_STAGE_COUNT];
+} acc_cascade_t;
+
+
+/**
+ * @brief Set default configuration values
+ *
+ * Trigger stage at 2 Hz, a baseline of 8 frames with a factor of 0.05, a threshold of
+ * 0.5 and a quiet timeout of 5 s. The currents are 0 and must be set for a charge
+ * estimate.
+ *
+ * @param[out] config The configuration
+ */
+void acc_cascade_config_default(acc_cascade_config_t *config);
+
+
+/**
+ * @brief Create the cascade and activate it in the trigger stage
+ *
+ * The power bins configuration is only used during the call. At most
+ * ACC_CASCADE_MAX_BINS bins are used.
+ *
+ * @param[out] cascade The cascade to create
+ * @param[in] power_bins_configuration The power bins configuration of the trigger stage
+ * @param[in] pipeline The pipeline started by the trigger stage
+ * @param[in] config The cascade configuration
+ * @return True if successful
+ */
+bool acc_cascade_create(acc_cascade_t *cascade, acc_service_configuration_t power_bins_configuration,
+                        const acc_cascade_pipeline_t *pipeline, const acc_cascade_config_t *config);
+
+
+/**
+ * @brief Deactivate the active stage and destroy the power bins service
+ *
+ * The pipeline is left inactive and is destroyed by the caller.
+ *
+ * @param[in] cascade The cascade
+ */
+void acc_cascade_destroy(acc_cascade_t *cascade);
+
+
+/**
+ * @brief Wait for and process the next frame of the active stage
+ *
+ * A triggering frame or a quiet timeout switches the stage before returning, so the next
+ * call processes the first frame of the new stage.
+ *
+ * @param[in] cascade The cascade
+ * @param[out] stage The stage the frame was processed in
+ * @param[out] activity True if the frame triggered the pipeline or the pipeline reported activity
+ * @return True if successful
+ */
+bool acc_cascade_update(acc_cascade_t *cascade, acc_cascade_stage_t *stage, bool *activity);
+
+
+/**
+ * @brief Get statistics for a stage
+ *
+ * The time and charge of the active stage are accounted up to its last frame.
+ *
+ * @param[in] cascade The cascade
+ * @param[in] stage The stage
+ * @return The statistics
+ */
+const acc_cascade_stats_t *acc_cascade_stats_get(const acc_cascade_t *cascade, acc_cascade_stage_t stage);
+
+
+/**
+ * @brief Print the statistics of both stages and the average current
+ *
+ * @param[in] cascade The cascade
+ */
+void acc_cascade_stats_print(const acc_cascade_t *cascade);
+
+
+#endif
@@ -0,0 +1,232 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_envelope_peaks.h"
+#include "acc_integration.h"
+
+
+#define DEFAULT_CFAR_GUARD     4
+#define DEFAULT_CFAR_WINDOW    16
+#define DEFAULT_CFAR_FACTOR    1.5f
+#define DEFAULT_CFAR_OFFSET    100
+#define DEFAULT_MERGE_DISTANCE 4
+
+
+/**
+ * @brief Running sums of the CFAR windows on each side of a sample
+ */
+typedef struct
+{
+	uint32_t left_sum;
+	uint16_t left_count;
+	uint32_t right_sum;
+	uint16_t right_count;
+} cfar_windows_t;
+
+
+static void cfar_init(cfar_windows_t *windows, const acc_envelope_peaks_config_t *config, const uint16_t *envelope,
+                      uint16_t length)
+{
+	memset(windows, 0, sizeof(*windows));
+
+	for (uint32_t i = (uint32_t)config->cfar_guard + 1; i <= (uint32_t)config->cfar_guard + config->cfar_window && i < length; i++)
+	{
+		windows->right_sum += envelope[i];
+		windows->right_count++;
+	}
+}
+
+
+/**
+ * @brief Move the CFAR windows from sample index to sample index + 1
+ */
+static void cfar_advance(cfar_windows_t *windows, const acc_envelope_peaks_config_t *config, const uint16_t *envelope,
+                         uint16_t length, uint16_t index)
+{
+	int32_t guard  = config->cfar_guard;
+	int32_t window = config->cfar_window;
+	int32_t enter  = (int32_t)index - guard;
+	int32_t leave  = (int32_t)index - guard - window;
+
+	if (enter >= 0 && enter < length)
+	{
+		windows->left_sum += envelope[enter];
+		windows->left_count++;
+	}
+
+	if (leave >= 0)
+	{
+		windows->left_sum -= envelope[leave];
+		windows->left_count--;
+	}
+
+	leave = (int32_t)index + guard + 1;
+	enter = (int32_t)index + guard + window + 1;
+
+	if (leave < length)
+	{
+		windows->right_sum -= envelope[leave];
+		windows->right_count--;
+	}
+
+	if (enter < length)
+	{
+		windows->right_sum += envelope[enter];
+		windows->right_count++;
+	}
+}
+
+
+static float threshold_at(const acc_envelope_peaks_config_t *config, const cfar_windows_t *windows, uint16_t index)
+{
+	switch (config->threshold_type)
+	{
+		case ACC_ENVELOPE_PEAKS_THRESHOLD_FIXED:
+			return (float)config->fixed_threshold;
+		case ACC_ENVELOPE_PEAKS_THRESHOLD_RECORDED:
+			return (float)config->recorded_threshold[index] + (float)config->recorded_margin;
+		case ACC_ENVELOPE_PEAKS_THRESHOLD_CFAR:
+		{
+			uint16_t count = windows->left_count + windows->right_count;
+
+			if (count == 0)
+			{
+				return (float)UINT16_MAX;
+			}
+
+			float mean = (float)(windows->left_sum + windows->right_sum) / (float)count;
+
+			return (config->cfar_factor * mean) + (float)config->cfar_offset;
+		}
+	}
+
+	return (float)UINT16_MAX;
+}
+
+
+static void interpolate(const uint16_t *envelope, uint16_t index, acc_envelope_peak_t *peak)
+{
+	float left   = (float)envelope[index - 1];
+	float center = (float)envelope[index];
+	float right  = (float)envelope[index + 1];
+	float curve  = left - (2.0f * center) + right;
+	float offset = (curve < 0.0f) ? 0.5f * (left - right) / curve : 0.0f;
+
+	peak->position  = (float)index + offset;
+	peak->amplitude = center - (0.25f * (left - right) * offset);
+}
+
+
+static uint16_t add_peak(const acc_envelope_peak_t *peak, acc_envelope_peak_t *peaks, uint16_t count, uint16_t max_peaks,
+                         float merge_distance)
+{
+	if (count > 0 && peak->position - peaks[count - 1].position < merge_distance)
+	{
+		if (peak->amplitude > peaks[count - 1].amplitude)
+		{
+			peaks[count - 1] = *peak;
+		}
+
+		return count;
+	}
+
+	if (count < max_peaks)
+	{
+		peaks[count] = *peak;
+		return count + 1;
+	}
+
+	uint16_t weakest = 0;
+
+	for (uint16_t i = 1; i < count; i++)
+	{
+		if (peaks[i].amplitude < peaks[weakest].amplitude)
+		{
+			weakest = i;
+		}
+	}
+
+	if (peak->amplitude > peaks[weakest].amplitude)
+	{
+		memmove(&peaks[weakest], &peaks[weakest + 1], (size_t)(count - weakest - 1) * sizeof(*peaks));
+		peaks[count - 1] = *peak;
+	}
+
+	return count;
+}
+
+
+void acc_envelope_peaks_config_default(acc_envelope_peaks_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+
+	config->threshold_type = ACC_ENVELOPE_PEAKS_THRESHOLD_CFAR;
+	config->cfar_guard     = DEFAULT_CFAR_GUARD;
+	config->cfar_window    = DEFAULT_CFAR_WINDOW;
+	config->cfar_factor    = DEFAULT_CFAR_FACTOR;
+	config->cfar_offset    = DEFAULT_CFAR_OFFSET;
+	config->merge_distance = DEFAULT_MERGE_DISTANCE;
+}
+
+
+ACC_INTEGRATION_RAM_FUNC uint16_t acc_envelope_peaks_find(const acc_envelope_peaks_config_t *config,
+                                                          const uint16_t *envelope, uint16_t length,
+                                                          acc_envelope_peak_t *peaks, uint16_t max_peaks)
+{
+	cfar_windows_t windows;
+	uint16_t       count = 0;
+	bool           cfar  = config->threshold_type == ACC_ENVELOPE_PEAKS_THRESHOLD_CFAR;
+
+	if (length < 3 || max_peaks == 0)
+	{
+		return 0;
+	}
+
+	if (cfar)
+	{
+		cfar_init(&windows, config, envelope, length);
+		cfar_advance(&windows, config, envelope, length, 0);
+	}
+
+	// The first and last samples can not be interpolated and are not peaks
+	for (uint16_t i = 1; i + 1 < length; i++)
+	{
+		if (envelope[i] >= envelope[i - 1] && envelope[i] > envelope[i + 1])
+		{
+			float threshold = threshold_at(config, &windows, i);
+
+			if ((float)envelope[i] > threshold)
+			{
+				acc_envelope_peak_t peak;
+
+				interpolate(envelope, i, &peak);
+				peak.threshold = threshold;
+
+				count = add_peak(&peak, peaks, count, max_peaks, (float)config->merge_distance);
+			}
+		}
+
+		if (cfar)
+		{
+			cfar_advance(&windows, config, envelope, length, i);
+		}
+	}
+
+	return count;
+}
+
+
+void acc_envelope_peaks_record(uint16_t *recorded, const uint16_t *envelope, uint16_t length)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		recorded[i] = (envelope[i] > recorded[i]) ? envelope[i] : recorded[i];
+	}
+}
@@ -0,0 +1,123 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_ENVELOPE_PEAKS_H_
+#define ACC_ENVELOPE_PEAKS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Envelope peak finder
+ *
+ * Finds peaks in uint16_t envelope sweeps, for example from
+ * acc_service_envelope_get_next_by_reference or from the service data callback of the
+ * distance detector, without running the distance detector.
+ *
+ * A peak is a local maximum above the threshold. The threshold is one of:
+ *   - Fixed, the same amplitude for all samples
+ *   - Recorded, a recorded background plus a margin, see acc_envelope_peaks_record
+ *   - CFAR, the mean of the samples in a window on each side of the sample, leaving out
+ *     a guard interval next to it, times a factor plus an offset. The window means are
+ *     kept as running sums, so the cost is the same for any window size. Near the ends of
+ *     the sweep only the window on the available side is used.
+ *
+ * The peak position and amplitude are interpolated with a parabola through the peak
+ * sample and its neighbours. Peaks closer than the merge distance are merged into the
+ * strongest of them.
+ */
+
+
+/**
+ * @brief Threshold types
+ */
+typedef enum
+{
+	ACC_ENVELOPE_PEAKS_THRESHOLD_FIXED,
+	ACC_ENVELOPE_PEAKS_THRESHOLD_RECORDED,
+	ACC_ENVELOPE_PEAKS_THRESHOLD_CFAR
+} acc_envelope_peaks_threshold_t;
+
+
+/**
+ * @brief Peak finder configuration
+ */
+typedef struct
+{
+	acc_envelope_peaks_threshold_t threshold_type;
+	/** Threshold amplitude for the fixed threshold */
+	uint16_t                       fixed_threshold;
+	/** Recorded background for the recorded threshold, one value per sample, owned by the caller */
+	const uint16_t                 *recorded_threshold;
+	/** Amplitude added to the recorded background */
+	uint16_t                       recorded_margin;
+	/** Number of samples on each side of a sample left out of the CFAR windows */
+	uint16_t                       cfar_guard;
+	/** Number of samples in each CFAR window */
+	uint16_t                       cfar_window;
+	/** Factor applied to the CFAR window mean */
+	float                          cfar_factor;
+	/** Amplitude added to the CFAR threshold */
+	uint16_t                       cfar_offset;
+	/** Peaks closer than this number of samples are merged */
+	uint16_t                       merge_distance;
+} acc_envelope_peaks_config_t;
+
+
+/**
+ * @brief A peak
+ */
+typedef struct
+{
+	/** Interpolated position in samples from the start of the sweep */
+	float position;
+	/** Interpolated amplitude */
+	float amplitude;
+	/** Threshold at the peak sample */
+	float threshold;
+} acc_envelope_peak_t;
+
+
+/**
+ * @brief Set default configuration values
+ *
+ * CFAR threshold with a guard of 4 samples, a window of 16 samples, a factor of 1.5 and an
+ * offset of 100, and a merge distance of 4 samples.
+ *
+ * @param[out] config The configuration
+ */
+void acc_envelope_peaks_config_default(acc_envelope_peaks_config_t *config);
+
+
+/**
+ * @brief Find the peaks in an envelope sweep
+ *
+ * When more than max_peaks peaks are found, the strongest are kept. The peaks are
+ * returned in position order.
+ *
+ * @param[in] config The configuration
+ * @param[in] envelope The envelope sweep
+ * @param[in] length The number of samples in the sweep
+ * @param[out] peaks The peaks found
+ * @param[in] max_peaks The maximum number of peaks
+ * @return The number of peaks found
+ */
+uint16_t acc_envelope_peaks_find(const acc_envelope_peaks_config_t *config, const uint16_t *envelope, uint16_t length,
+                                 acc_envelope_peak_t *peaks, uint16_t max_peaks);
+
+
+/**
+ * @brief Add an envelope sweep to a recorded background
+ *
+ * The background is the highest amplitude of each sample over the recorded sweeps. Clear
+ * the background to 0 before the first sweep.
+ *
+ * @param[in, out] recorded The recorded background
+ * @param[in] envelope The envelope sweep
+ * @param[in] length The number of samples in the sweep
+ */
+void acc_envelope_peaks_record(uint16_t *recorded, const uint16_t *envelope, uint16_t length);
+
+
+#endif
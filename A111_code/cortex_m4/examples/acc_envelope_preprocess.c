@@ -0,0 +1,207 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_envelope_preprocess.h"
+#include "acc_integration.h"
+#include "acc_simd.h"
+
+
+#define FACTOR_Q15_MAX 32767
+
+// The halved difference times the Q15 factor is scaled back with this shift, with rounding
+#define AVERAGE_SHIFT    14
+#define AVERAGE_ROUNDING (1 << (AVERAGE_SHIFT - 1))
+
+
+/**
+ * @brief Pack two 16 bit results of wrapping arithmetic
+ */
+static inline uint32_t pack_wrapped(int32_t low, int32_t high)
+{
+	return ((uint32_t)low & 0xffff) | ((uint32_t)high << 16);
+}
+
+
+/**
+ * @brief Running average of two samples
+ *
+ * sweep + factor * (average - sweep), where (average - sweep) / 2 is taken with a halving
+ * subtraction. The result is between the sweep and the average, so the final addition can
+ * wrap at 16 bits.
+ */
+static inline uint32_t average_x2(uint32_t sweep, uint32_t average, uint32_t factor_low, uint32_t factor_high)
+{
+	uint32_t half_difference = acc_simd_uhsub16(average, sweep);
+	int32_t  low             = (acc_simd_smuad(half_difference, factor_low) + AVERAGE_ROUNDING) >> AVERAGE_SHIFT;
+	int32_t  high            = (acc_simd_smuad(half_difference, factor_high) + AVERAGE_ROUNDING) >> AVERAGE_SHIFT;
+
+	return acc_simd_add16(sweep, pack_wrapped(low, high));
+}
+
+
+static uint16_t average_x1(uint16_t sweep, uint16_t average, uint16_t factor_q15)
+{
+	int32_t half_difference = ((int32_t)average - sweep) >> 1;
+
+	return (uint16_t)(sweep + (((half_difference * factor_q15) + AVERAGE_ROUNDING) >> AVERAGE_SHIFT));
+}
+
+
+bool acc_envelope_preprocess_create(acc_envelope_preprocess_t *preprocess, uint16_t data_length,
+                                    float running_average_factor)
+{
+	memset(preprocess, 0, sizeof(*preprocess));
+
+	if (data_length == 0 || running_average_factor < 0.0f)
+	{
+		return false;
+	}
+
+	float factor_q15 = (running_average_factor * 32768.0f) + 0.5f;
+
+	preprocess->data_length = data_length;
+	preprocess->factor_q15  = (factor_q15 > (float)FACTOR_Q15_MAX) ? FACTOR_Q15_MAX : (uint16_t)factor_q15;
+	preprocess->average     = acc_integration_mem_calloc(data_length, sizeof(*preprocess->average));
+	preprocess->background  = acc_integration_mem_calloc(data_length, sizeof(*preprocess->background));
+
+	if (preprocess->average == NULL || preprocess->background == NULL)
+	{
+		acc_envelope_preprocess_destroy(preprocess);
+		return false;
+	}
+
+	return true;
+}
+
+
+void acc_envelope_preprocess_destroy(acc_envelope_preprocess_t *preprocess)
+{
+	acc_integration_mem_free(preprocess->average);
+	acc_integration_mem_free(preprocess->background);
+
+	memset(preprocess, 0, sizeof(*preprocess));
+}
+
+
+void acc_envelope_preprocess_average_reset(acc_envelope_preprocess_t *preprocess)
+{
+	preprocess->average_valid = false;
+}
+
+
+ACC_INTEGRATION_RAM_FUNC void acc_envelope_preprocess_background_record(acc_envelope_preprocess_t *preprocess,
+                                                                        const uint16_t *data)
+{
+	uint16_t *background = preprocess->background;
+	uint16_t i           = 0;
+
+	if (!preprocess->background_valid)
+	{
+		memcpy(background, data, preprocess->data_length * sizeof(*data));
+		preprocess->background_valid = true;
+		return;
+	}
+
+	for (; i + 1 < preprocess->data_length; i += 2)
+	{
+		uint32_t sweep    = acc_simd_read_x2(&data[i]);
+		uint32_t recorded = acc_simd_read_x2(&background[i]);
+
+		// max(sweep, recorded) = sweep + max(recorded - sweep, 0)
+		acc_simd_write_x2(&background[i], acc_simd_add16(sweep, acc_simd_uqsub16(recorded, sweep)));
+	}
+
+	if (i < preprocess->data_length)
+	{
+		background[i] = (data[i] > background[i]) ? data[i] : background[i];
+	}
+}
+
+
+void acc_envelope_preprocess_background_set(acc_envelope_preprocess_t *preprocess, const uint16_t *background)
+{
+	memcpy(preprocess->background, background, preprocess->data_length * sizeof(*background));
+	preprocess->background_valid = true;
+}
+
+
+void acc_envelope_preprocess_background_clear(acc_envelope_preprocess_t *preprocess)
+{
+	preprocess->background_valid = false;
+}
+
+
+ACC_INTEGRATION_RAM_FUNC void acc_envelope_preprocess_process(acc_envelope_preprocess_t *preprocess, uint16_t *data)
+{
+	uint16_t       length      = preprocess->data_length;
+	uint16_t       *average    = preprocess->average;
+	const uint16_t *background = preprocess->background;
+	bool           averaging   = preprocess->factor_q15 > 0;
+	bool           subtract    = preprocess->background_valid;
+	uint16_t       i           = 0;
+
+	if (averaging && !preprocess->average_valid)
+	{
+		memcpy(average, data, length * sizeof(*data));
+		preprocess->average_valid = true;
+		averaging                 = false;
+	}
+
+	if (!averaging && !subtract)
+	{
+		return;
+	}
+
+	uint32_t factor_low  = acc_simd_pack((int16_t)preprocess->factor_q15, 0);
+	uint32_t factor_high = acc_simd_pack(0, (int16_t)preprocess->factor_q15);
+
+	for (; i + 1 < length; i += 2)
+	{
+		uint32_t sweep = acc_simd_read_x2(&data[i]);
+
+		if (averaging)
+		{
+			sweep = average_x2(sweep, acc_simd_read_x2(&average[i]), factor_low, factor_high);
+			acc_simd_write_x2(&average[i], sweep);
+		}
+
+		if (subtract)
+		{
+			sweep = acc_simd_uqsub16(sweep, acc_simd_read_x2(&background[i]));
+		}
+
+		acc_simd_write_x2(&data[i], sweep);
+	}
+
+	if (i < length)
+	{
+		uint16_t sweep = data[i];
+
+		if (averaging)
+		{
+			sweep      = average_x1(sweep, average[i], preprocess->factor_q15);
+			average[i] = sweep;
+		}
+
+		if (subtract)
+		{
+			sweep = (sweep > background[i]) ? sweep - background[i] : 0;
+		}
+
+		data[i] = sweep;
+	}
+}
+
+
+size_t acc_envelope_preprocess_memory_size(uint16_t data_length)
+{
+	return (size_t)data_length * 2 * sizeof(uint16_t);
+}
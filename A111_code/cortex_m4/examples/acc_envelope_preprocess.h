@@ -0,0 +1,123 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_ENVELOPE_PREPROCESS_H_
+#define ACC_ENVELOPE_PREPROCESS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * Envelope preprocessing
+ *
+ * Processes envelope sweeps in place, typically the buffer returned by
+ * acc_service_envelope_get_next_by_reference, in two steps:
+ *   - An exponential running average over sweeps, the same filter as the running average
+ *     factor of the envelope service: average = factor * average + (1 - factor) * sweep
+ *   - Subtraction of a stored background profile with the result clamped at zero
+ *
+ * All processing is in uint16_t with the factor in Q15, two samples at a time with the
+ * SIMD helpers in acc_simd.h. The difference between the sweep and the average is taken
+ * with a halving subtraction so that it fits 16 bits for any amplitudes, and the
+ * background subtraction is a saturating unsigned subtraction.
+ *
+ * The background is recorded as the highest amplitude of each sample over a number of
+ * sweeps, or set from a profile computed by the application, for example a direct
+ * leakage model.
+ */
+
+
+/**
+ * @brief Envelope preprocessing state
+ */
+typedef struct
+{
+	uint16_t *average;
+	uint16_t *background;
+	uint16_t data_length;
+	uint16_t factor_q15;
+	bool     average_valid;
+	bool     background_valid;
+} acc_envelope_preprocess_t;
+
+
+/**
+ * @brief Create the envelope preprocessing
+ *
+ * @param[out] preprocess The preprocessing to create
+ * @param[in] data_length The number of samples in a sweep
+ * @param[in] running_average_factor The weight of the previous average, 0 disables the running average
+ * @return True if successful
+ */
+bool acc_envelope_preprocess_create(acc_envelope_preprocess_t *preprocess, uint16_t data_length,
+                                    float running_average_factor);
+
+
+/**
+ * @brief Destroy the envelope preprocessing
+ *
+ * @param[in] preprocess The preprocessing
+ */
+void acc_envelope_preprocess_destroy(acc_envelope_preprocess_t *preprocess);
+
+
+/**
+ * @brief Restart the running average from the next sweep
+ *
+ * @param[in] preprocess The preprocessing
+ */
+void acc_envelope_preprocess_average_reset(acc_envelope_preprocess_t *preprocess);
+
+
+/**
+ * @brief Add a sweep to the recorded background
+ *
+ * The background is the highest amplitude of each sample over the sweeps added since it
+ * was cleared. Background subtraction starts with the first added sweep.
+ *
+ * @param[in] preprocess The preprocessing
+ * @param[in] data The sweep
+ */
+void acc_envelope_preprocess_background_record(acc_envelope_preprocess_t *preprocess, const uint16_t *data);
+
+
+/**
+ * @brief Set the background profile
+ *
+ * @param[in] preprocess The preprocessing
+ * @param[in] background The background, one value per sample
+ */
+void acc_envelope_preprocess_background_set(acc_envelope_preprocess_t *preprocess, const uint16_t *background);
+
+
+/**
+ * @brief Clear the background and stop background subtraction
+ *
+ * @param[in] preprocess The preprocessing
+ */
+void acc_envelope_preprocess_background_clear(acc_envelope_preprocess_t *preprocess);
+
+
+/**
+ * @brief Process a sweep in place
+ *
+ * The sweep is replaced by its running average minus the background, clamped at zero.
+ *
+ * @param[in] preprocess The preprocessing
+ * @param[in, out] data The sweep
+ */
+void acc_envelope_preprocess_process(acc_envelope_preprocess_t *preprocess, uint16_t *data);
+
+
+/**
+ * @brief Get the RAM used by the preprocessing state
+ *
+ * @param[in] data_length The number of samples in a sweep
+ * @return The number of bytes
+ */
+size_t acc_envelope_preprocess_memory_size(uint16_t data_length);
+
+
+#endif
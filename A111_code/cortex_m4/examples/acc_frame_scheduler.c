@@ -0,0 +1,124 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_frame_scheduler.h"
+#include "acc_integration.h"
+
+
+static void deadline_advance(acc_frame_scheduler_t *scheduler)
+{
+	scheduler->deadline_ms          += scheduler->period_ms;
+	scheduler->deadline_us_fraction += scheduler->period_us_fraction;
+
+	if (scheduler->deadline_us_fraction >= 1000)
+	{
+		scheduler->deadline_ms++;
+		scheduler->deadline_us_fraction -= 1000;
+	}
+}
+
+
+void acc_frame_scheduler_init(acc_frame_scheduler_t *scheduler, float rate_hz)
+{
+	memset(scheduler, 0, sizeof(*scheduler));
+
+	acc_frame_scheduler_rate_set(scheduler, rate_hz);
+}
+
+
+void acc_frame_scheduler_rate_set(acc_frame_scheduler_t *scheduler, float rate_hz)
+{
+	uint32_t period_us = (rate_hz > 0.0f) ? (uint32_t)(1000000.0f / rate_hz + 0.5f) : 0;
+
+	scheduler->period_ms          = period_us / 1000;
+	scheduler->period_us_fraction = period_us % 1000;
+	scheduler->started            = false;
+}
+
+
+uint32_t acc_frame_scheduler_wait(acc_frame_scheduler_t *scheduler)
+{
+	acc_frame_scheduler_stats_t *stats   = &scheduler->stats;
+	uint32_t                    skipped = 0;
+	uint32_t                    now     = acc_integration_get_time();
+
+	if (!scheduler->started)
+	{
+		scheduler->started              = true;
+		scheduler->deadline_ms          = now;
+		scheduler->deadline_us_fraction = 0;
+
+		if (stats->frames == 0)
+		{
+			scheduler->first_frame_ms = now;
+		}
+	}
+	else if ((int32_t)(scheduler->deadline_ms - now) > 0)
+	{
+		do
+		{
+			acc_integration_sleep_ms(scheduler->deadline_ms - now);
+			now = acc_integration_get_time();
+		} while ((int32_t)(scheduler->deadline_ms - now) > 0);
+	}
+	else if ((int32_t)(now - scheduler->deadline_ms) > 0)
+	{
+		// Waking up exactly at the deadline is on time
+		stats->late++;
+
+		while (scheduler->period_ms > 0 && now - scheduler->deadline_ms >= scheduler->period_ms)
+		{
+			deadline_advance(scheduler);
+			skipped++;
+		}
+
+		stats->skipped += skipped;
+	}
+
+	uint32_t jitter = now - scheduler->deadline_ms;
+
+	stats->frames++;
+	stats->last_jitter_ms   = jitter;
+	stats->total_jitter_ms += jitter;
+	stats->max_jitter_ms    = (jitter > stats->max_jitter_ms) ? jitter : stats->max_jitter_ms;
+
+	scheduler->last_frame_ms = now;
+
+	deadline_advance(scheduler);
+
+	return skipped;
+}
+
+
+void acc_frame_scheduler_stats_get(const acc_frame_scheduler_t *scheduler, acc_frame_scheduler_stats_t *stats)
+{
+	*stats = scheduler->stats;
+
+	uint32_t elapsed_ms = scheduler->last_frame_ms - scheduler->first_frame_ms;
+
+	stats->rate_hz = (stats->frames > 1 && elapsed_ms > 0) ? (float)(stats->frames - 1) * 1000.0f / (float)elapsed_ms : 0.0f;
+}
+
+
+void acc_frame_scheduler_stats_print(const acc_frame_scheduler_t *scheduler)
+{
+	acc_frame_scheduler_stats_t stats;
+
+	acc_frame_scheduler_stats_get(scheduler, &stats);
+
+	printf("Frames: %u, rate: %u mHz, jitter avg: %u ms, max: %u ms, late: %u, skipped: %u\n",
+	       (unsigned int)stats.frames,
+	       (unsigned int)(stats.rate_hz * 1000.0f + 0.5f),
+	       (unsigned int)((stats.frames > 0) ? stats.total_jitter_ms / stats.frames : 0),
+	       (unsigned int)stats.max_jitter_ms,
+	       (unsigned int)stats.late,
+	       (unsigned int)stats.skipped);
+}
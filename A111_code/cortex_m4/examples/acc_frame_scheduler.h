@@ -0,0 +1,116 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_FRAME_SCHEDULER_H_
+#define ACC_FRAME_SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Fixed rate frame scheduler
+ *
+ * Frames are scheduled against absolute deadlines, start + n * period, so the time
+ * spent in get_next and in the processing of a frame does not add to the period and
+ * errors do not accumulate. Periods that are not a whole number of milliseconds are
+ * kept exact over time, for example 12.5 ms at 80 Hz.
+ *
+ * A frame that is late by less than a period is started directly and the schedule is
+ * kept. If one or more whole periods were missed, those frames are skipped instead of
+ * being run back to back, and the schedule continues from the next deadline.
+ *
+ * The time until the deadline is spent in acc_integration_sleep_ms, which sleeps in the
+ * lowest power state available to the integration.
+ */
+
+
+/**
+ * @brief Frame scheduler statistics
+ */
+typedef struct
+{
+	/** Number of frames started */
+	uint32_t frames;
+	/** Number of frames started after their deadline */
+	uint32_t late;
+	/** Number of frames skipped because whole periods were missed */
+	uint32_t skipped;
+	/** Time from deadline to start of the last frame in ms */
+	uint32_t last_jitter_ms;
+	/** Highest time from deadline to start of a frame in ms */
+	uint32_t max_jitter_ms;
+	/** Sum of the times from deadline to start of all frames in ms */
+	uint32_t total_jitter_ms;
+	/** Achieved frame rate since the first frame */
+	float    rate_hz;
+} acc_frame_scheduler_stats_t;
+
+
+/**
+ * @brief Frame scheduler
+ */
+typedef struct
+{
+	uint32_t period_ms;
+	uint32_t period_us_fraction;
+	uint32_t deadline_ms;
+	uint32_t deadline_us_fraction;
+	uint32_t first_frame_ms;
+	uint32_t last_frame_ms;
+	bool     started;
+
+	acc_frame_scheduler_stats_t stats;
+} acc_frame_scheduler_t;
+
+
+/**
+ * @brief Initialize a frame scheduler
+ *
+ * The first call to acc_frame_scheduler_wait returns directly and starts the schedule.
+ *
+ * @param[out] scheduler The frame scheduler to initialize
+ * @param[in] rate_hz The frame rate
+ */
+void acc_frame_scheduler_init(acc_frame_scheduler_t *scheduler, float rate_hz);
+
+
+/**
+ * @brief Change the frame rate
+ *
+ * The statistics are kept and the new schedule starts at the next call to
+ * acc_frame_scheduler_wait.
+ *
+ * @param[in] scheduler The frame scheduler
+ * @param[in] rate_hz The new frame rate
+ */
+void acc_frame_scheduler_rate_set(acc_frame_scheduler_t *scheduler, float rate_hz);
+
+
+/**
+ * @brief Sleep until the deadline of the next frame
+ *
+ * @param[in] scheduler The frame scheduler
+ * @return The number of frames skipped since the previous call
+ */
+uint32_t acc_frame_scheduler_wait(acc_frame_scheduler_t *scheduler);
+
+
+/**
+ * @brief Get frame scheduler statistics
+ *
+ * @param[in] scheduler The frame scheduler
+ * @param[out] stats The frame scheduler statistics
+ */
+void acc_frame_scheduler_stats_get(const acc_frame_scheduler_t *scheduler, acc_frame_scheduler_stats_t *stats);
+
+
+/**
+ * @brief Print frame scheduler statistics on one line
+ *
+ * @param[in] scheduler The frame scheduler
+ */
+void acc_frame_scheduler_stats_print(const acc_frame_scheduler_t *scheduler);
+
+
+#endif
@@ -0,0 +1,307 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_definitions_common.h"
+#include "acc_detector_distance.h"
+#include "acc_gain_controller.h"
+#include "acc_service.h"
+
+
+#define DEFAULT_TARGET_LEVEL 0.5f
+#define DEFAULT_HYSTERESIS   0.2f
+
+// A gain of 0.0 gives no usable signal
+#define DEFAULT_MIN_STEP 1
+
+
+typedef enum
+{
+	LEVEL_LOW,
+	LEVEL_OK,
+	LEVEL_HIGH
+} level_t;
+
+
+static uint16_t gain_to_step(float gain)
+{
+	if (gain <= 0.0f)
+	{
+		return 0;
+	}
+
+	if (gain >= 1.0f)
+	{
+		return ACC_GAIN_CONTROLLER_STEPS;
+	}
+
+	return (uint16_t)(gain * ACC_GAIN_CONTROLLER_STEPS + 0.5f);
+}
+
+
+static void search_start(acc_gain_controller_t *controller)
+{
+	controller->searching  = true;
+	controller->low        = controller->min_step;
+	controller->high       = controller->max_step;
+	controller->best_valid = false;
+}
+
+
+static level_t classify(const acc_gain_controller_t *controller, bool saturated, uint16_t peak)
+{
+	if (saturated)
+	{
+		return LEVEL_HIGH;
+	}
+
+	if (controller->full_scale == 0)
+	{
+		// Saturation only, search for the highest gain without saturation
+		return controller->searching ? LEVEL_LOW : LEVEL_OK;
+	}
+
+	float full_scale = controller->full_scale;
+
+	if (peak > (controller->target_level + controller->hysteresis) * full_scale)
+	{
+		return LEVEL_HIGH;
+	}
+
+	if (peak < (controller->target_level - controller->hysteresis) * full_scale)
+	{
+		return LEVEL_LOW;
+	}
+
+	return LEVEL_OK;
+}
+
+
+static bool settle(acc_gain_controller_t *controller, uint16_t step, bool peak_valid, uint16_t peak)
+{
+	bool changed = step != controller->step;
+
+	controller->searching          = false;
+	controller->step               = step;
+	controller->settled_peak       = peak;
+	controller->settled_peak_valid = peak_valid;
+
+	return changed;
+}
+
+
+void acc_gain_controller_init(acc_gain_controller_t *controller, float gain, uint16_t full_scale)
+{
+	memset(controller, 0, sizeof(*controller));
+
+	controller->full_scale   = full_scale;
+	controller->target_level = DEFAULT_TARGET_LEVEL;
+	controller->hysteresis   = DEFAULT_HYSTERESIS;
+	controller->min_step     = DEFAULT_MIN_STEP;
+	controller->max_step     = ACC_GAIN_CONTROLLER_STEPS;
+	controller->step         = gain_to_step(gain);
+
+	if (controller->step < controller->min_step)
+	{
+		controller->step = controller->min_step;
+	}
+}
+
+
+void acc_gain_controller_limits_set(acc_gain_controller_t *controller, float min_gain, float max_gain)
+{
+	controller->min_step = gain_to_step(min_gain);
+	controller->max_step = gain_to_step(max_gain);
+
+	if (controller->max_step < controller->min_step)
+	{
+		controller->max_step = controller->min_step;
+	}
+
+	if (controller->step < controller->min_step)
+	{
+		controller->step = controller->min_step;
+	}
+	else if (controller->step > controller->max_step)
+	{
+		controller->step = controller->max_step;
+	}
+
+	controller->searching          = false;
+	controller->settled_peak_valid = false;
+}
+
+
+bool acc_gain_controller_update(acc_gain_controller_t *controller, bool saturated, uint16_t peak)
+{
+	controller->updates++;
+
+	if (!controller->searching)
+	{
+		if (classify(controller, saturated, peak) == LEVEL_OK)
+		{
+			if (!controller->settled_peak_valid)
+			{
+				controller->settled_peak       = peak;
+				controller->settled_peak_valid = true;
+			}
+
+			return false;
+		}
+
+		if (!saturated && controller->settled_peak_valid)
+		{
+			int32_t moved = (int32_t)peak - (int32_t)controller->settled_peak;
+
+			if (moved < 0)
+			{
+				moved = -moved;
+			}
+
+			if (moved <= controller->hysteresis * (float)controller->full_scale)
+			{
+				return false;
+			}
+		}
+
+		search_start(controller);
+	}
+
+	level_t  level = classify(controller, saturated, peak);
+	uint16_t step  = controller->step;
+
+	if (level == LEVEL_OK)
+	{
+		return settle(controller, step, true, peak);
+	}
+
+	if (!saturated && (!controller->best_valid || step > controller->best_step))
+	{
+		controller->best_step  = step;
+		controller->best_peak  = peak;
+		controller->best_valid = true;
+	}
+
+	bool exhausted;
+
+	if (level == LEVEL_HIGH)
+	{
+		exhausted = step <= controller->low;
+
+		if (!exhausted)
+		{
+			controller->high = step - 1;
+		}
+	}
+	else
+	{
+		exhausted = step >= controller->high;
+
+		if (!exhausted)
+		{
+			controller->low = step + 1;
+		}
+	}
+
+	if (exhausted || controller->low > controller->high)
+	{
+		// No gain gives a peak within the band, use the highest gain without saturation
+		if (controller->best_valid)
+		{
+			return settle(controller, controller->best_step, true, controller->best_peak);
+		}
+
+		return settle(controller, controller->low, false, 0);
+	}
+
+	controller->step = (uint16_t)((controller->low + controller->high + 1) / 2);
+
+	return true;
+}
+
+
+float acc_gain_controller_gain_get(const acc_gain_controller_t *controller)
+{
+	return (float)controller->step / ACC_GAIN_CONTROLLER_STEPS;
+}
+
+
+bool acc_gain_controller_searching(const acc_gain_controller_t *controller)
+{
+	return controller->searching;
+}
+
+
+void acc_gain_controller_service_apply(const acc_gain_controller_t *controller, acc_service_configuration_t configuration)
+{
+	acc_service_receiver_gain_set(configuration, acc_gain_controller_gain_get(controller));
+}
+
+
+void acc_gain_controller_distance_apply(const acc_gain_controller_t *controller,
+                                        acc_detector_distance_configuration_t configuration)
+{
+	acc_detector_distance_configuration_receiver_gain_set(configuration, acc_gain_controller_gain_get(controller));
+}
+
+
+uint16_t acc_gain_controller_peak_uint16(const uint16_t *data, uint16_t data_length)
+{
+	uint16_t peak = 0;
+
+	for (uint16_t i = 0; i < data_length; i++)
+	{
+		if (data[i] > peak)
+		{
+			peak = data[i];
+		}
+	}
+
+	return peak;
+}
+
+
+uint16_t acc_gain_controller_peak_complex(const acc_int16_complex_t *data, uint16_t data_length)
+{
+	uint16_t peak = 0;
+
+	for (uint16_t i = 0; i < data_length; i++)
+	{
+		uint16_t real = (uint16_t)((data[i].real < 0) ? -data[i].real : data[i].real);
+		uint16_t imag = (uint16_t)((data[i].imag < 0) ? -data[i].imag : data[i].imag);
+
+		if (real > peak)
+		{
+			peak = real;
+		}
+
+		if (imag > peak)
+		{
+			peak = imag;
+		}
+	}
+
+	return peak;
+}
+
+
+uint16_t acc_gain_controller_peak_distance(const acc_detector_distance_result_t *results, uint16_t result_count)
+{
+	uint16_t peak = 0;
+
+	for (uint16_t i = 0; i < result_count; i++)
+	{
+		if (results[i].amplitude > peak)
+		{
+			peak = results[i].amplitude;
+		}
+	}
+
+	return peak;
+}
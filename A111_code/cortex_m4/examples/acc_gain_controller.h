@@ -0,0 +1,166 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_GAIN_CONTROLLER_H_
+#define ACC_GAIN_CONTROLLER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "acc_definitions_common.h"
+#include "acc_detector_distance.h"
+#include "acc_service.h"
+
+
+/**
+ * Closed loop receiver gain controller
+ *
+ * The gain is searched by bisection over the gain steps, so a new operating point is
+ * found after at most log2(ACC_GAIN_CONTROLLER_STEPS + 1) updates, about five, instead
+ * of one update per step. The controller works in one of two modes:
+ *   - Saturation only (full scale 0), the highest gain without data saturation is searched
+ *   - Level, the gain is searched so that the peak amplitude is within
+ *     target_level +/- hysteresis of full scale
+ *
+ * A search is started on data saturation, or in level mode when the peak amplitude is
+ * outside the band. When the search has settled, a new search in level mode is only
+ * started when the peak amplitude has moved more than the hysteresis from where it
+ * settled, so a signal at the edge of the band does not toggle the gain between two
+ * steps. After a saturation, gains above the saturated one are not tried again until
+ * the next search.
+ *
+ * The controller only calculates the gain. The caller applies it to the configuration,
+ * see acc_gain_controller_service_apply and acc_gain_controller_distance_apply, and
+ * reconfigures or recreates the service or detector when acc_gain_controller_update
+ * returns true.
+ */
+
+
+/**
+ * @brief Number of gain steps between 0.0 and 1.0
+ */
+#define ACC_GAIN_CONTROLLER_STEPS 22
+
+
+/**
+ * @brief Gain controller
+ *
+ * The configuration fields may be changed after acc_gain_controller_init.
+ */
+typedef struct
+{
+	/** Full scale of the peak amplitude, 0 to only use the saturation indication */
+	uint16_t full_scale;
+	/** Target peak amplitude as a fraction of full scale */
+	float    target_level;
+	/** Accepted deviation from target_level as a fraction of full scale */
+	float    hysteresis;
+
+	uint16_t min_step;
+	uint16_t max_step;
+	uint16_t step;
+	uint16_t low;
+	uint16_t high;
+	uint16_t best_step;
+	uint16_t best_peak;
+	bool     best_valid;
+	uint16_t settled_peak;
+	bool     settled_peak_valid;
+	bool     searching;
+	uint32_t updates;
+} acc_gain_controller_t;
+
+
+/**
+ * @brief Initialize a gain controller
+ *
+ * The controller starts from the given gain with all gains between 0.0 and 1.0 allowed.
+ *
+ * @param[out] controller The gain controller to initialize
+ * @param[in] gain The gain currently set in the configuration
+ * @param[in] full_scale Full scale of the peak amplitude, 0 to only use the saturation indication
+ */
+void acc_gain_controller_init(acc_gain_controller_t *controller, float gain, uint16_t full_scale);
+
+
+/**
+ * @brief Limit the gains used by the controller
+ *
+ * For example the gain used when a background was recorded can be set as the maximum
+ * gain. The current gain is clamped to the limits, apply it to the configuration
+ * after this call.
+ *
+ * @param[in] controller The gain controller
+ * @param[in] min_gain The lowest gain to use
+ * @param[in] max_gain The highest gain to use
+ */
+void acc_gain_controller_limits_set(acc_gain_controller_t *controller, float min_gain, float max_gain);
+
+
+/**
+ * @brief Update the controller with the result of a measurement made with the current gain
+ *
+ * @param[in] controller The gain controller
+ * @param[in] saturated The data_saturated indication from the result info
+ * @param[in] peak The peak amplitude of the result, ignored in saturation only mode
+ * @return True if the gain was changed and should be applied
+ */
+bool acc_gain_controller_update(acc_gain_controller_t *controller, bool saturated, uint16_t peak);
+
+
+/**
+ * @brief Get the current gain
+ *
+ * @param[in] controller The gain controller
+ * @return The gain
+ */
+float acc_gain_controller_gain_get(const acc_gain_controller_t *controller);
+
+
+/**
+ * @brief Check if the controller is searching for a new gain
+ *
+ * @param[in] controller The gain controller
+ * @return True if the controller is searching
+ */
+bool acc_gain_controller_searching(const acc_gain_controller_t *controller);
+
+
+/**
+ * @brief Set the current gain in a service configuration
+ *
+ * @param[in] controller The gain controller
+ * @param[in] configuration The service configuration
+ */
+void acc_gain_controller_service_apply(const acc_gain_controller_t *controller, acc_service_configuration_t configuration);
+
+
+/**
+ * @brief Set the current gain in a distance detector configuration
+ *
+ * @param[in] controller The gain controller
+ * @param[in] configuration The distance detector configuration
+ */
+void acc_gain_controller_distance_apply(const acc_gain_controller_t *controller,
+                                        acc_detector_distance_configuration_t configuration);
+
+
+/**
+ * @brief Get the peak amplitude of envelope, power bins or recorded background data
+ */
+uint16_t acc_gain_controller_peak_uint16(const uint16_t *data, uint16_t data_length);
+
+
+/**
+ * @brief Get the peak amplitude of IQ data, the largest absolute value of the real and imaginary parts
+ */
+uint16_t acc_gain_controller_peak_complex(const acc_int16_complex_t *data, uint16_t data_length);
+
+
+/**
+ * @brief Get the peak amplitude of distance detector results
+ */
+uint16_t acc_gain_controller_peak_distance(const acc_detector_distance_result_t *results, uint16_t result_count);
+
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_gesture_engine.h"
+
+
+static bool condition_met(const acc_gesture_transition_t *transition, float score, uint32_t time_in_state_us)
+{
+	switch (transition->condition)
+	{
+		case ACC_GESTURE_CONDITION_SCORE_ABOVE:
+			return score >= transition->score;
+		case ACC_GESTURE_CONDITION_SCORE_BELOW:
+			return score < transition->score;
+		case ACC_GESTURE_CONDITION_TIME_IN_STATE:
+			return time_in_state_us >= transition->time_us;
+	}
+
+	return false;
+}
+
+
+static const acc_gesture_transition_t *find_transition(const acc_gesture_engine_t *engine, float score, uint32_t time_in_state_us)
+{
+	for (uint16_t i = 0; i < engine->transition_count; i++)
+	{
+		const acc_gesture_transition_t *transition = &engine->transitions[i];
+
+		if (transition->state == engine->state && condition_met(transition, score, time_in_state_us))
+		{
+			return transition;
+		}
+	}
+
+	return NULL;
+}
+
+
+void acc_gesture_engine_init(acc_gesture_engine_t *engine, const acc_gesture_transition_t *transitions, uint16_t transition_count,
+                             acc_gesture_event_callback_t callback, void *client_reference)
+{
+	memset(engine, 0, sizeof(*engine));
+
+	engine->transitions      = transitions;
+	engine->transition_count = transition_count;
+	engine->callback         = callback;
+	engine->client_reference = client_reference;
+
+	acc_gesture_engine_reset(engine);
+}
+
+
+void acc_gesture_engine_reset(acc_gesture_engine_t *engine)
+{
+	engine->state   = ACC_GESTURE_STATE_TRIGGER;
+	engine->started = false;
+}
+
+
+acc_gesture_event_t acc_gesture_engine_update(acc_gesture_engine_t *engine, float score, uint32_t time_us)
+{
+	acc_gesture_event_t last_event = ACC_GESTURE_EVENT_NONE;
+
+	if (!engine->started)
+	{
+		engine->started        = true;
+		engine->state_start_us = time_us;
+	}
+
+	engine->frames++;
+
+	// Limit the chain of transitions in one frame, a table with a loop of met conditions would otherwise never end
+	for (uint16_t chained = 0; chained < ACC_GESTURE_STATE_COUNT; chained++)
+	{
+		uint32_t                       time_in_state_us = time_us - engine->state_start_us;
+		const acc_gesture_transition_t *transition      = find_transition(engine, score, time_in_state_us);
+
+		if (transition == NULL)
+		{
+			break;
+		}
+
+		acc_gesture_state_t state = engine->state;
+
+		engine->state          = transition->next_state;
+		engine->state_start_us = time_us;
+
+		if (transition->event != ACC_GESTURE_EVENT_NONE)
+		{
+			last_event = transition->event;
+
+			if (engine->callback != NULL)
+			{
+				acc_gesture_event_info_t info =
+				{
+					.time_us          = time_us,
+					.score            = score,
+					.state            = state,
+					.time_in_state_us = time_in_state_us,
+				};
+
+				engine->callback(transition->event, &info, engine->client_reference);
+			}
+		}
+	}
+
+	return last_event;
+}
+
+
+acc_gesture_state_t acc_gesture_engine_state_get(const acc_gesture_engine_t *engine)
+{
+	return engine->state;
+}
+
+
+const char *acc_gesture_engine_event_name(acc_gesture_event_t event)
+{
+	switch (event)
+	{
+		case ACC_GESTURE_EVENT_NONE:
+			return "none";
+		case ACC_GESTURE_EVENT_DETECTED:
+			return "detected";
+		case ACC_GESTURE_EVENT_RELEASED:
+			return "released";
+		case ACC_GESTURE_EVENT_REARMED:
+			return "rearmed";
+	}
+
+	return "unknown";
+}
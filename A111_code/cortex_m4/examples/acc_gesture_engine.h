@@ -0,0 +1,187 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_GESTURE_ENGINE_H_
+#define ACC_GESTURE_ENGINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Table driven gesture engine
+ *
+ * The engine runs a state machine on the presence score of each frame. The state machine
+ * is given as a table of transitions. Each transition has a from state, a condition, the
+ * state to go to and the event to report. The transitions are tried in table order and
+ * the first one with a true condition is taken. After a transition the transitions of the
+ * new state are tried on the same frame, so a chain of transitions with met conditions,
+ * for example a refractory time of 0, completes in one frame.
+ *
+ * The times are in microseconds from the frame timestamps given to the engine, taken for
+ * example with acc_integration_get_time_us when get_next returns. A recording of scores and
+ * timestamps can be replayed with the same result as live, see example_gesture_latency.c.
+ *
+ * The events are reported to a callback with the timestamp of the frame and the score.
+ */
+
+
+/**
+ * @brief Gesture engine states
+ */
+typedef enum
+{
+	/** Waiting for a gesture */
+	ACC_GESTURE_STATE_TRIGGER,
+	/** Gesture triggered, waiting for the score to fall */
+	ACC_GESTURE_STATE_COOLDOWN,
+	/** Score has fallen, waiting for a minimum time before the next gesture */
+	ACC_GESTURE_STATE_REFRACTORY,
+	ACC_GESTURE_STATE_COUNT
+} acc_gesture_state_t;
+
+
+/**
+ * @brief Gesture engine events
+ */
+typedef enum
+{
+	ACC_GESTURE_EVENT_NONE,
+	/** A gesture was detected */
+	ACC_GESTURE_EVENT_DETECTED,
+	/** The score has fallen after a gesture */
+	ACC_GESTURE_EVENT_RELEASED,
+	/** A new gesture can be detected */
+	ACC_GESTURE_EVENT_REARMED
+} acc_gesture_event_t;
+
+
+/**
+ * @brief Transition conditions
+ */
+typedef enum
+{
+	/** The score is at or above the transition score */
+	ACC_GESTURE_CONDITION_SCORE_ABOVE,
+	/** The score is below the transition score */
+	ACC_GESTURE_CONDITION_SCORE_BELOW,
+	/** The time in the state is at least the transition time */
+	ACC_GESTURE_CONDITION_TIME_IN_STATE
+} acc_gesture_condition_t;
+
+
+/**
+ * @brief A state machine transition
+ */
+typedef struct
+{
+	acc_gesture_state_t     state;
+	acc_gesture_condition_t condition;
+	/** Score for the score conditions */
+	float                   score;
+	/** Time in us for the time condition */
+	uint32_t                time_us;
+	acc_gesture_state_t     next_state;
+	/** Event reported when the transition is taken, ACC_GESTURE_EVENT_NONE for no event */
+	acc_gesture_event_t     event;
+} acc_gesture_transition_t;
+
+
+/**
+ * @brief Information passed with an event
+ */
+typedef struct
+{
+	/** Timestamp of the frame that caused the event in us */
+	uint32_t            time_us;
+	/** Score of the frame that caused the event */
+	float               score;
+	/** State before the transition */
+	acc_gesture_state_t state;
+	/** Time spent in the state before the transition in us */
+	uint32_t            time_in_state_us;
+} acc_gesture_event_info_t;
+
+
+/**
+ * @brief Event callback
+ *
+ * @param[in] event The event
+ * @param[in] info Information about the event
+ * @param[in] client_reference The client reference given to acc_gesture_engine_init
+ */
+typedef void (*acc_gesture_event_callback_t)(acc_gesture_event_t event, const acc_gesture_event_info_t *info, void *client_reference);
+
+
+/**
+ * @brief Gesture engine
+ */
+typedef struct
+{
+	const acc_gesture_transition_t *transitions;
+	uint16_t                       transition_count;
+	acc_gesture_event_callback_t   callback;
+	void                           *client_reference;
+
+	acc_gesture_state_t state;
+	uint32_t            state_start_us;
+	bool                started;
+	uint32_t            frames;
+} acc_gesture_engine_t;
+
+
+/**
+ * @brief Initialize a gesture engine in the trigger state
+ *
+ * The transition table is not copied and must be valid as long as the engine is used.
+ *
+ * @param[out] engine The gesture engine to initialize
+ * @param[in] transitions The transition table
+ * @param[in] transition_count The number of transitions in the table
+ * @param[in] callback The event callback, can be NULL
+ * @param[in] client_reference Pointer passed to the callback
+ */
+void acc_gesture_engine_init(acc_gesture_engine_t *engine, const acc_gesture_transition_t *transitions, uint16_t transition_count,
+                             acc_gesture_event_callback_t callback, void *client_reference);
+
+
+/**
+ * @brief Return the engine to the trigger state
+ *
+ * The time in the trigger state starts at the next update.
+ *
+ * @param[in] engine The gesture engine
+ */
+void acc_gesture_engine_reset(acc_gesture_engine_t *engine);
+
+
+/**
+ * @brief Update the engine with the presence score of a frame
+ *
+ * @param[in] engine The gesture engine
+ * @param[in] score The presence score of the frame
+ * @param[in] time_us The timestamp of the frame in us
+ * @return The last event reported for the frame, ACC_GESTURE_EVENT_NONE if none
+ */
+acc_gesture_event_t acc_gesture_engine_update(acc_gesture_engine_t *engine, float score, uint32_t time_us);
+
+
+/**
+ * @brief Get the current state
+ *
+ * @param[in] engine The gesture engine
+ * @return The current state
+ */
+acc_gesture_state_t acc_gesture_engine_state_get(const acc_gesture_engine_t *engine);
+
+
+/**
+ * @brief Get the name of an event
+ *
+ * @param[in] event The event
+ * @return The name of the event
+ */
+const char *acc_gesture_engine_event_name(acc_gesture_event_t event);
+
+
+#endif
@@ -0,0 +1,276 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_definitions_common.h"
+#include "acc_integration.h"
+#include "acc_iq_q15.h"
+#include "acc_simd.h"
+
+
+#define CORDIC_ITERATIONS 15
+
+// The CORDIC gain compensation, the product of 1 / sqrt(1 + 2^(-2i)) over the iterations, Q15
+#define CORDIC_GAIN_Q15 19898
+
+// Scaling of 16 bit inputs into the CORDIC, keeps the gain of up to 2.33 within 32 bits
+#define CORDIC_INPUT_SHIFT 14
+
+// Range the 32 bit CORDIC inputs are normalized to
+#define CORDIC_INPUT_MIN (1 << 27)
+#define CORDIC_INPUT_MAX (1 << 29)
+
+// Smoothing of the power used to select the tracked point, a new power has the weight 2^-shift
+#define POWER_SMOOTHING_SHIFT 3
+
+// The tracked point is only changed when another point has this many times more power
+#define TRACKED_POINT_SWITCH_RATIO 2
+
+
+/**
+ * @brief atan(2^-i) as Q15 binary angles
+ */
+static const int16_t cordic_angles[CORDIC_ITERATIONS] =
+{
+	8192, 4836, 2555, 1297, 651, 326, 163, 81, 41, 20, 10, 5, 3, 1, 1
+};
+
+
+/**
+ * @brief Rotate a vector to the positive real axis with CORDIC
+ *
+ * @param[in] x The real part, |x| and |y| must be below CORDIC_INPUT_MAX
+ * @param[in] y The imaginary part
+ * @param[out] magnitude The magnitude times the CORDIC gain, can be NULL
+ * @return The angle of the vector as a binary angle, wrapping at 16 bits
+ */
+static int32_t cordic_vector(int32_t x, int32_t y, int32_t *magnitude)
+{
+	int32_t angle = 0;
+
+	if (x < 0)
+	{
+		x     = -x;
+		y     = -y;
+		angle = ACC_IQ_Q15_HALF_TURN;
+	}
+
+	for (uint16_t i = 0; i < CORDIC_ITERATIONS; i++)
+	{
+		int32_t x_shifted = x >> i;
+		int32_t y_shifted = y >> i;
+
+		if (y > 0)
+		{
+			x     += y_shifted;
+			y     -= x_shifted;
+			angle += cordic_angles[i];
+		}
+		else
+		{
+			x     -= y_shifted;
+			y     += x_shifted;
+			angle -= cordic_angles[i];
+		}
+	}
+
+	if (magnitude != NULL)
+	{
+		*magnitude = x;
+	}
+
+	return angle;
+}
+
+
+static int16_t binary_angle(int32_t angle)
+{
+	return (int16_t)(uint16_t)((uint32_t)angle & 0xffff);
+}
+
+
+/**
+ * @brief Scale a 64 bit vector into the CORDIC input range, keeping the angle
+ *
+ * @param[in] x The real part
+ * @param[in] y The imaginary part
+ * @param[out] cordic_x The scaled real part
+ * @param[out] cordic_y The scaled imaginary part
+ */
+static void normalize(int64_t x, int64_t y, int32_t *cordic_x, int32_t *cordic_y)
+{
+	int64_t abs_x = (x < 0) ? -x : x;
+	int64_t abs_y = (y < 0) ? -y : y;
+	int64_t bits  = abs_x | abs_y;
+
+	if (bits != 0)
+	{
+		while (bits >= CORDIC_INPUT_MAX)
+		{
+			bits >>= 1;
+			x    >>= 1;
+			y    >>= 1;
+		}
+
+		while (bits < CORDIC_INPUT_MIN)
+		{
+			bits <<= 1;
+			x     *= 2;
+			y     *= 2;
+		}
+	}
+
+	*cordic_x = (int32_t)x;
+	*cordic_y = (int32_t)y;
+}
+
+
+int16_t acc_iq_q15_phase(acc_int16_complex_t value)
+{
+	return binary_angle(cordic_vector((int32_t)value.real * (1 << CORDIC_INPUT_SHIFT),
+	                                  (int32_t)value.imag * (1 << CORDIC_INPUT_SHIFT), NULL));
+}
+
+
+uint16_t acc_iq_q15_magnitude(acc_int16_complex_t value)
+{
+	int32_t magnitude;
+
+	cordic_vector((int32_t)value.real * (1 << CORDIC_INPUT_SHIFT), (int32_t)value.imag * (1 << CORDIC_INPUT_SHIFT), &magnitude);
+
+	int64_t compensated = ((int64_t)magnitude * CORDIC_GAIN_Q15) >> (15 + CORDIC_INPUT_SHIFT);
+
+	return (compensated > UINT16_MAX) ? UINT16_MAX : (uint16_t)compensated;
+}
+
+
+ACC_INTEGRATION_RAM_FUNC void acc_iq_q15_polar(const acc_int16_complex_t *data, uint16_t length, uint16_t *magnitude,
+                                               int16_t *phase)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		int32_t cordic_magnitude;
+		int32_t angle = cordic_vector((int32_t)data[i].real * (1 << CORDIC_INPUT_SHIFT),
+		                              (int32_t)data[i].imag * (1 << CORDIC_INPUT_SHIFT), &cordic_magnitude);
+
+		int64_t compensated = ((int64_t)cordic_magnitude * CORDIC_GAIN_Q15) >> (15 + CORDIC_INPUT_SHIFT);
+
+		magnitude[i] = (compensated > UINT16_MAX) ? UINT16_MAX : (uint16_t)compensated;
+		phase[i]     = binary_angle(angle);
+	}
+}
+
+
+bool acc_iq_q15_tracker_create(acc_iq_q15_tracker_t *tracker, uint16_t data_length, int16_t filter_q15)
+{
+	memset(tracker, 0, sizeof(*tracker));
+
+	tracker->data_length = data_length;
+	tracker->filter_q15  = filter_q15;
+
+	if (data_length == 0)
+	{
+		return false;
+	}
+
+	tracker->previous = acc_integration_mem_calloc(data_length, sizeof(*tracker->previous));
+	tracker->power    = acc_integration_mem_calloc(data_length, sizeof(*tracker->power));
+
+	if (tracker->previous == NULL || tracker->power == NULL)
+	{
+		acc_iq_q15_tracker_destroy(tracker);
+		return false;
+	}
+
+	return true;
+}
+
+
+void acc_iq_q15_tracker_destroy(acc_iq_q15_tracker_t *tracker)
+{
+	acc_integration_mem_free(tracker->previous);
+	acc_integration_mem_free(tracker->power);
+
+	memset(tracker, 0, sizeof(*tracker));
+}
+
+
+ACC_INTEGRATION_RAM_FUNC void acc_iq_q15_tracker_update(acc_iq_q15_tracker_t *tracker, const acc_int16_complex_t *data)
+{
+	uint16_t strongest_point = 0;
+	int32_t  strongest_power = -1;
+
+	for (uint16_t point = 0; point < tracker->data_length; point++)
+	{
+		uint32_t value = acc_simd_read_x2(&data[point]);
+
+		// |z|^2 / 2, so that the full scale square fits in a signed 32 bit value
+		int32_t power = (int32_t)((uint32_t)acc_simd_smuad(value, value) >> 1);
+
+		if (tracker->frames > 0)
+		{
+			power = tracker->power[point] + ((power - tracker->power[point]) / (1 << POWER_SMOOTHING_SHIFT));
+		}
+
+		tracker->power[point] = power;
+
+		if (power > strongest_power)
+		{
+			strongest_power = power;
+			strongest_point = point;
+		}
+	}
+
+	if (tracker->frames == 0 ||
+	    (int64_t)strongest_power > (int64_t)tracker->power[tracker->tracked_point] * TRACKED_POINT_SWITCH_RATIO)
+	{
+		tracker->tracked_point = strongest_point;
+	}
+
+	if (tracker->frames > 0)
+	{
+		acc_int16_complex_t current  = data[tracker->tracked_point];
+		acc_int16_complex_t previous = tracker->previous[tracker->tracked_point];
+
+		// current * conj(previous), in 64 bits as the real part of two full scale samples is 2^31
+		int64_t real = ((int64_t)current.real * previous.real) + ((int64_t)current.imag * previous.imag);
+		int64_t imag = ((int64_t)current.imag * previous.real) - ((int64_t)current.real * previous.imag);
+		int32_t cordic_real;
+		int32_t cordic_imag;
+
+		normalize(real, imag, &cordic_real, &cordic_imag);
+
+		tracker->unwrapped_phase += binary_angle(cordic_vector(cordic_real, cordic_imag, NULL));
+	}
+
+	memcpy(tracker->previous, data, tracker->data_length * sizeof(*data));
+
+	tracker->displacement_um = (int32_t)(((int64_t)tracker->unwrapped_phase * ACC_IQ_Q15_WAVELENGTH_UM) /
+	                                     (4 * ACC_IQ_Q15_HALF_TURN));
+
+	if (tracker->frames == 0)
+	{
+		tracker->filtered_displacement_um = tracker->displacement_um;
+	}
+	else
+	{
+		int64_t difference = (int64_t)tracker->displacement_um - tracker->filtered_displacement_um;
+
+		tracker->filtered_displacement_um += (int32_t)((difference * tracker->filter_q15) / (1 << 15));
+	}
+
+	tracker->frames++;
+}
+
+
+size_t acc_iq_q15_tracker_memory_size(uint16_t data_length)
+{
+	return (size_t)data_length * (sizeof(acc_int16_complex_t) + sizeof(int32_t));
+}
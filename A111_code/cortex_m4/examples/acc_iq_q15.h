@@ -0,0 +1,138 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_IQ_Q15_H_
+#define ACC_IQ_Q15_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "acc_definitions_common.h"
+
+
+/**
+ * Fixed point IQ processing
+ *
+ * The processing works directly on the acc_int16_complex_t data returned by
+ * acc_service_iq_get_next_by_reference, with the IQ service configured for
+ * ACC_SERVICE_IQ_OUTPUT_FORMAT_INT16_COMPLEX. No float complex copy of the frame is made.
+ *
+ * Phases are binary angles in Q15, where 32768 is half a turn, so that the phase wraps
+ * naturally in 16 bit arithmetic. Phases and magnitudes are calculated with CORDIC.
+ *
+ * The micro-motion tracker follows the phase of the strongest point over frames. The phase
+ * change between frames is the angle of the point times the conjugate of the same point
+ * in the previous frame, calculated in 64 bits as the product of two full scale samples
+ * does not fit in 32 bits. The power used to select the point is one dual multiply,
+ * __SMUAD. The phase changes are accumulated into an unwrapped phase, which is converted
+ * to a radial displacement, for example the movement of a chest when breathing.
+ */
+
+
+/**
+ * @brief Wavelength of the A111 radar at 60.5 GHz in um
+ */
+#define ACC_IQ_Q15_WAVELENGTH_UM 4955
+
+
+/**
+ * @brief Half a turn as a Q15 binary angle
+ */
+#define ACC_IQ_Q15_HALF_TURN 32768
+
+
+/**
+ * @brief Micro-motion tracker
+ */
+typedef struct
+{
+	uint16_t data_length;
+	/** Weight of a new displacement in the displacement filter, Q15 */
+	int16_t  filter_q15;
+
+	acc_int16_complex_t *previous;
+	int32_t             *power;
+
+	/** Point whose phase is tracked */
+	uint16_t tracked_point;
+	/** Accumulated phase change of the tracked point, Q15 half turns */
+	int32_t  unwrapped_phase;
+	/** Displacement since the first frame in um, positive for an increasing phase */
+	int32_t  displacement_um;
+	/** Low pass filtered displacement in um */
+	int32_t  filtered_displacement_um;
+	uint32_t frames;
+} acc_iq_q15_tracker_t;
+
+
+/**
+ * @brief Calculate the phase of an IQ value
+ *
+ * @param[in] value The IQ value
+ * @return The phase as a Q15 binary angle
+ */
+int16_t acc_iq_q15_phase(acc_int16_complex_t value);
+
+
+/**
+ * @brief Calculate the magnitude of an IQ value
+ *
+ * @param[in] value The IQ value
+ * @return The magnitude
+ */
+uint16_t acc_iq_q15_magnitude(acc_int16_complex_t value);
+
+
+/**
+ * @brief Calculate the magnitude and phase of a frame
+ *
+ * @param[in] data The IQ frame
+ * @param[in] length The number of values in the frame
+ * @param[out] magnitude The magnitudes, length values
+ * @param[out] phase The phases as Q15 binary angles, length values
+ */
+void acc_iq_q15_polar(const acc_int16_complex_t *data, uint16_t length, uint16_t *magnitude, int16_t *phase);
+
+
+/**
+ * @brief Create a micro-motion tracker
+ *
+ * @param[out] tracker The tracker to create
+ * @param[in] data_length The data length from the IQ metadata
+ * @param[in] filter_q15 Weight of a new displacement in the displacement filter, Q15
+ * @return True if successful, false if memory could not be allocated
+ */
+bool acc_iq_q15_tracker_create(acc_iq_q15_tracker_t *tracker, uint16_t data_length, int16_t filter_q15);
+
+
+/**
+ * @brief Destroy a micro-motion tracker
+ *
+ * @param[in] tracker The tracker to destroy
+ */
+void acc_iq_q15_tracker_destroy(acc_iq_q15_tracker_t *tracker);
+
+
+/**
+ * @brief Update the tracker with an IQ frame
+ *
+ * The frame is not kept, so it can be the memory returned by
+ * acc_service_iq_get_next_by_reference.
+ *
+ * @param[in] tracker The tracker
+ * @param[in] data The IQ frame, data_length values
+ */
+void acc_iq_q15_tracker_update(acc_iq_q15_tracker_t *tracker, const acc_int16_complex_t *data);
+
+
+/**
+ * @brief Get the RAM used by a tracker
+ *
+ * @param[in] data_length The data length from the IQ metadata
+ * @return The number of bytes allocated by acc_iq_q15_tracker_create
+ */
+size_t acc_iq_q15_tracker_memory_size(uint16_t data_length);
+
+
+#endif
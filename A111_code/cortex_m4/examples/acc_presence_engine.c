@@ -0,0 +1,178 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_detector_presence.h"
+#include "acc_frame_scheduler.h"
+#include "acc_integration.h"
+#include "acc_presence_engine.h"
+#include "acc_rss.h"
+
+
+static acc_detector_presence_handle_t *active_handle(acc_presence_engine_t *engine)
+{
+	return engine->pre_created ? &engine->handle[engine->stage] : &engine->handle[ACC_PRESENCE_ENGINE_STAGE_WAKEUP];
+}
+
+
+static bool switch_stage(acc_presence_engine_t *engine, acc_presence_engine_stage_t stage)
+{
+	acc_detector_presence_handle_t *handle = active_handle(engine);
+
+	if (!acc_detector_presence_deactivate(*handle))
+	{
+		return false;
+	}
+
+	engine->stage = stage;
+
+	if (engine->pre_created)
+	{
+		handle = active_handle(engine);
+	}
+	else if (!acc_detector_presence_reconfigure(handle, engine->configuration[stage]))
+	{
+		return false;
+	}
+
+	acc_frame_scheduler_rate_set(&engine->scheduler, acc_detector_presence_configuration_update_rate_get(engine->configuration[stage]));
+
+	return acc_detector_presence_activate(*handle);
+}
+
+
+bool acc_presence_engine_create(acc_presence_engine_t                 *engine,
+                                acc_detector_presence_configuration_t wakeup_configuration,
+                                acc_detector_presence_configuration_t tracking_configuration)
+{
+	memset(engine, 0, sizeof(*engine));
+
+	engine->configuration[ACC_PRESENCE_ENGINE_STAGE_WAKEUP]   = wakeup_configuration;
+	engine->configuration[ACC_PRESENCE_ENGINE_STAGE_TRACKING] = tracking_configuration;
+	engine->stage                                             = ACC_PRESENCE_ENGINE_STAGE_WAKEUP;
+
+	// Allow one detector per configuration on the same sensor, only one is active at a time
+	acc_rss_override_sensor_id_check_at_creation(true);
+
+	engine->handle[ACC_PRESENCE_ENGINE_STAGE_WAKEUP] = acc_detector_presence_create(wakeup_configuration);
+
+	if (engine->handle[ACC_PRESENCE_ENGINE_STAGE_WAKEUP] == NULL)
+	{
+		acc_rss_override_sensor_id_check_at_creation(false);
+		return false;
+	}
+
+	engine->handle[ACC_PRESENCE_ENGINE_STAGE_TRACKING] = acc_detector_presence_create(tracking_configuration);
+	engine->pre_created                                = engine->handle[ACC_PRESENCE_ENGINE_STAGE_TRACKING] != NULL;
+
+	// The override is global in RSS, other services and detectors get the normal check again
+	acc_rss_override_sensor_id_check_at_creation(false);
+
+	acc_frame_scheduler_init(&engine->scheduler, acc_detector_presence_configuration_update_rate_get(wakeup_configuration));
+
+	if (!acc_detector_presence_activate(*active_handle(engine)))
+	{
+		acc_presence_engine_destroy(engine);
+		return false;
+	}
+
+	return true;
+}
+
+
+void acc_presence_engine_destroy(acc_presence_engine_t *engine)
+{
+	acc_detector_presence_deactivate(*active_handle(engine));
+
+	for (acc_presence_engine_stage_t stage = 0; stage < ACC_PRESENCE_ENGINE_STAGE_COUNT; stage++)
+	{
+		if (engine->handle[stage] != NULL)
+		{
+			acc_detector_presence_destroy(&engine->handle[stage]);
+		}
+	}
+}
+
+
+bool acc_presence_engine_get_next(acc_presence_engine_t *engine, acc_detector_presence_result_t *result,
+                                  acc_presence_engine_stage_t *stage)
+{
+	return acc_presence_engine_distance_point_vector_get_next(engine, NULL, NULL, result, stage);
+}
+
+
+bool acc_presence_engine_distance_point_vector_get_next(acc_presence_engine_t          *engine,
+                                                        uint16_t                       *distance_point_vector_length,
+                                                        float                          **distance_point_vector,
+                                                        acc_detector_presence_result_t *result,
+                                                        acc_presence_engine_stage_t    *stage)
+{
+	acc_frame_scheduler_wait(&engine->scheduler);
+
+	bool success;
+
+	if (distance_point_vector != NULL &&
+	    acc_detector_presence_configuration_vector_output_mode_get(engine->configuration[engine->stage]))
+	{
+		success = acc_detector_presence_distance_point_vector_get_next(*active_handle(engine), distance_point_vector_length,
+		                                                               distance_point_vector, result);
+	}
+	else
+	{
+		if (distance_point_vector != NULL)
+		{
+			*distance_point_vector        = NULL;
+			*distance_point_vector_length = 0;
+		}
+
+		success = acc_detector_presence_get_next(*active_handle(engine), result);
+	}
+
+	if (!success)
+	{
+		return false;
+	}
+
+	uint32_t now = acc_integration_get_time();
+
+	*stage = engine->stage;
+
+	if (engine->transition_pending)
+	{
+		acc_presence_engine_stats_t *stats   = &engine->stats[engine->stage];
+		uint32_t                    latency = now - engine->transition_start_ms;
+
+		stats->last_latency_ms   = latency;
+		stats->total_latency_ms += latency;
+		stats->max_latency_ms    = (latency > stats->max_latency_ms) ? latency : stats->max_latency_ms;
+
+		engine->transition_pending = false;
+	}
+
+	acc_presence_engine_stage_t next_stage = result->presence_detected ? ACC_PRESENCE_ENGINE_STAGE_TRACKING :
+	                                         ACC_PRESENCE_ENGINE_STAGE_WAKEUP;
+
+	if (next_stage != engine->stage)
+	{
+		engine->stats[next_stage].transitions++;
+		engine->transition_pending  = true;
+		engine->transition_start_ms = now;
+
+		return switch_stage(engine, next_stage);
+	}
+
+	return true;
+}
+
+
+const acc_presence_engine_stats_t *acc_presence_engine_stats_get(const acc_presence_engine_t *engine,
+                                                                 acc_presence_engine_stage_t stage)
+{
+	return &engine->stats[stage];
+}
@@ -0,0 +1,146 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_PRESENCE_ENGINE_H_
+#define ACC_PRESENCE_ENGINE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "acc_detector_presence.h"
+#include "acc_frame_scheduler.h"
+
+
+/**
+ * Two stage presence engine
+ *
+ * The engine runs a low power wakeup configuration until presence is detected, then a
+ * tracking configuration until presence is no longer detected, and back.
+ *
+ * Both presence detectors are created up front, with the sensor id check at creation
+ * overridden, so a transition is only a deactivate and an activate. No memory is
+ * allocated and no detector state is rebuilt. If the second detector can not be
+ * created, for example because of too little memory, the engine falls back to one
+ * detector that is reconfigured on every transition.
+ *
+ * The frames are paced with the frame scheduler at the update rate of the active
+ * configuration. The schedule restarts at a transition, so the first frame of the new
+ * stage is fetched directly.
+ */
+
+
+/**
+ * @brief Stage of the presence engine
+ */
+typedef enum
+{
+	ACC_PRESENCE_ENGINE_STAGE_WAKEUP,
+	ACC_PRESENCE_ENGINE_STAGE_TRACKING,
+	ACC_PRESENCE_ENGINE_STAGE_COUNT
+} acc_presence_engine_stage_t;
+
+
+/**
+ * @brief Transition statistics, per stage transitioned to
+ */
+typedef struct
+{
+	/** Number of transitions to the stage */
+	uint32_t transitions;
+	/** Time from the frame that triggered the last transition to the first frame of the stage in ms */
+	uint32_t last_latency_ms;
+	/** Highest transition latency in ms */
+	uint32_t max_latency_ms;
+	/** Sum of all transition latencies in ms */
+	uint32_t total_latency_ms;
+} acc_presence_engine_stats_t;
+
+
+/**
+ * @brief Presence engine
+ */
+typedef struct
+{
+	acc_detector_presence_configuration_t configuration[ACC_PRESENCE_ENGINE_STAGE_COUNT];
+	acc_detector_presence_handle_t        handle[ACC_PRESENCE_ENGINE_STAGE_COUNT];
+	bool                                  pre_created;
+	acc_presence_engine_stage_t           stage;
+	bool                                  transition_pending;
+	uint32_t                              transition_start_ms;
+	acc_frame_scheduler_t                 scheduler;
+
+	acc_presence_engine_stats_t stats[ACC_PRESENCE_ENGINE_STAGE_COUNT];
+} acc_presence_engine_t;
+
+
+/**
+ * @brief Create the presence engine and activate it in the wakeup stage
+ *
+ * The configurations must not be destroyed before the engine.
+ *
+ * @param[out] engine The presence engine to create
+ * @param[in] wakeup_configuration The configuration used until presence is detected
+ * @param[in] tracking_configuration The configuration used while presence is detected
+ * @return True if successful
+ */
+bool acc_presence_engine_create(acc_presence_engine_t                 *engine,
+                                acc_detector_presence_configuration_t wakeup_configuration,
+                                acc_detector_presence_configuration_t tracking_configuration);
+
+
+/**
+ * @brief Deactivate and destroy the presence engine
+ *
+ * @param[in] engine The presence engine
+ */
+void acc_presence_engine_destroy(acc_presence_engine_t *engine);
+
+
+/**
+ * @brief Wait for and get the next result from the active stage
+ *
+ * A change of presence_detected in the result switches the stage before returning, so
+ * the next call returns the first frame of the new stage.
+ *
+ * @param[in] engine The presence engine
+ * @param[out] result The presence result
+ * @param[out] stage The stage the result was produced in
+ * @return True if successful
+ */
+bool acc_presence_engine_get_next(acc_presence_engine_t *engine, acc_detector_presence_result_t *result,
+                                  acc_presence_engine_stage_t *stage);
+
+
+/**
+ * @brief Wait for and get the next result and distance point vector from the active stage
+ *
+ * The vector is only fetched in a stage whose configuration has vector output mode
+ * enabled, in other stages the vector is set to NULL with length 0. The memory of the
+ * vector is owned by the detector. See acc_presence_engine_get_next.
+ *
+ * @param[in] engine The presence engine
+ * @param[out] distance_point_vector_length The number of elements in the distance point vector
+ * @param[out] distance_point_vector The distance point vector
+ * @param[out] result The presence result
+ * @param[out] stage The stage the result was produced in
+ * @return True if successful
+ */
+bool acc_presence_engine_distance_point_vector_get_next(acc_presence_engine_t          *engine,
+                                                        uint16_t                       *distance_point_vector_length,
+                                                        float                          **distance_point_vector,
+                                                        acc_detector_presence_result_t *result,
+                                                        acc_presence_engine_stage_t    *stage);
+
+
+/**
+ * @brief Get transition statistics for a stage
+ *
+ * @param[in] engine The presence engine
+ * @param[in] stage The stage transitioned to
+ * @return The transition statistics
+ */
+const acc_presence_engine_stats_t *acc_presence_engine_stats_get(const acc_presence_engine_t *engine,
+                                                                 acc_presence_engine_stage_t stage);
+
+
+#endif
@@ -0,0 +1,205 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_presence_zones.h"
+
+
+#define NO_ZONE 0xff
+
+// Margin for rounding of the distance of points on the range and zone limits
+#define LIMIT_MARGIN_M 0.001f
+
+
+static void bin_points(acc_presence_zones_t *zones, uint16_t length)
+{
+	uint16_t points = (length < ACC_PRESENCE_ZONES_MAX_POINTS) ? length : ACC_PRESENCE_ZONES_MAX_POINTS;
+	uint16_t zone   = 0;
+
+	// The points and the limits are both in increasing order, so the zone only moves forward
+	for (uint16_t point = 0; point < points; point++)
+	{
+		float distance_m = zones->start_m;
+
+		if (length > 1)
+		{
+			distance_m += zones->length_m * (float)point / (float)(length - 1);
+		}
+
+		while (zone + 1 < zones->zone_count && distance_m >= zones->zone_limits_m[zone + 1])
+		{
+			zone++;
+		}
+
+		if (distance_m >= zones->zone_limits_m[zone] - LIMIT_MARGIN_M &&
+		    distance_m <= zones->zone_limits_m[zone + 1] + LIMIT_MARGIN_M)
+		{
+			zones->point_zone[point] = (uint8_t)zone;
+		}
+		else
+		{
+			zones->point_zone[point] = NO_ZONE;
+		}
+	}
+
+	zones->point_count = length;
+}
+
+
+static void update_occupancy(acc_presence_zone_t *zone, float threshold, uint32_t hold_ms, uint32_t time_ms)
+{
+	if (zone->score >= threshold)
+	{
+		zone->detections++;
+		zone->last_detection_ms = time_ms;
+
+		if (!zone->occupied)
+		{
+			zone->occupied          = true;
+			zone->occupied_start_ms = time_ms;
+		}
+	}
+
+	if (!zone->occupied)
+	{
+		return;
+	}
+
+	if (time_ms - zone->last_detection_ms > hold_ms)
+	{
+		zone->occupied           = false;
+		zone->occupied_ms        = zone->last_detection_ms - zone->occupied_start_ms;
+		zone->total_occupied_ms += zone->occupied_ms;
+	}
+	else
+	{
+		zone->occupied_ms = time_ms - zone->occupied_start_ms;
+	}
+}
+
+
+bool acc_presence_zones_init(acc_presence_zones_t *zones, float start_m, float length_m, const float *zone_limits_m,
+                             uint16_t zone_count, float threshold)
+{
+	if (zone_count == 0 || zone_count > ACC_PRESENCE_ZONES_MAX)
+	{
+		return false;
+	}
+
+	for (uint16_t zone = 0; zone < zone_count; zone++)
+	{
+		if (zone_limits_m[zone + 1] <= zone_limits_m[zone])
+		{
+			return false;
+		}
+	}
+
+	memset(zones, 0, sizeof(*zones));
+
+	zones->start_m    = start_m;
+	zones->length_m   = length_m;
+	zones->threshold  = threshold;
+	zones->zone_count = zone_count;
+
+	memcpy(zones->zone_limits_m, zone_limits_m, (zone_count + 1) * sizeof(*zone_limits_m));
+
+	return true;
+}
+
+
+bool acc_presence_zones_uniform_init(acc_presence_zones_t *zones, float start_m, float length_m, uint16_t zone_count,
+                                     float threshold)
+{
+	float zone_limits_m[ACC_PRESENCE_ZONES_MAX + 1];
+
+	if (zone_count == 0 || zone_count > ACC_PRESENCE_ZONES_MAX)
+	{
+		return false;
+	}
+
+	for (uint16_t limit = 0; limit <= zone_count; limit++)
+	{
+		zone_limits_m[limit] = start_m + length_m * (float)limit / (float)zone_count;
+	}
+
+	return acc_presence_zones_init(zones, start_m, length_m, zone_limits_m, zone_count, threshold);
+}
+
+
+void acc_presence_zones_hold_time_set(acc_presence_zones_t *zones, uint32_t hold_ms)
+{
+	zones->hold_ms = hold_ms;
+}
+
+
+bool acc_presence_zones_update(acc_presence_zones_t *zones, const float *vector, uint16_t length, uint32_t time_ms)
+{
+	// The zones of the points are kept over updates without a vector
+	if (length > 0 && length != zones->point_count)
+	{
+		bin_points(zones, length);
+	}
+
+	for (uint16_t zone = 0; zone < zones->zone_count; zone++)
+	{
+		zones->zone[zone].score = 0.0f;
+	}
+
+	uint16_t points = (length < ACC_PRESENCE_ZONES_MAX_POINTS) ? length : ACC_PRESENCE_ZONES_MAX_POINTS;
+
+	for (uint16_t point = 0; point < points; point++)
+	{
+		uint8_t zone = zones->point_zone[point];
+
+		if (zone != NO_ZONE && vector[point] > zones->zone[zone].score)
+		{
+			zones->zone[zone].score = vector[point];
+		}
+	}
+
+	bool occupied = false;
+
+	for (uint16_t zone = 0; zone < zones->zone_count; zone++)
+	{
+		update_occupancy(&zones->zone[zone], zones->threshold, zones->hold_ms, time_ms);
+
+		occupied = occupied || zones->zone[zone].occupied;
+	}
+
+	zones->updates++;
+
+	return occupied;
+}
+
+
+const acc_presence_zone_t *acc_presence_zones_get(const acc_presence_zones_t *zones, uint16_t zone)
+{
+	return &zones->zone[zone];
+}
+
+
+void acc_presence_zones_print(const acc_presence_zones_t *zones)
+{
+	printf("Zones:");
+
+	for (uint16_t zone = 0; zone < zones->zone_count; zone++)
+	{
+		const acc_presence_zone_t *state = &zones->zone[zone];
+
+		printf(" %u: %d", (unsigned int)zone, (int)(state->score * 1000.0f));
+
+		if (state->occupied)
+		{
+			printf(" (%u ms)", (unsigned int)state->occupied_ms);
+		}
+	}
+
+	printf("\n");
+}
@@ -0,0 +1,153 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_PRESENCE_ZONES_H_
+#define ACC_PRESENCE_ZONES_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Multi-zone presence output
+ *
+ * The distance point vector of the presence detector, enabled with
+ * acc_detector_presence_configuration_vector_output_mode_set, holds one presence score
+ * per distance point over the measured range. The zones bin the vector into a number
+ * of configurable distance intervals, with the highest score in each zone as the zone
+ * score. A zone is occupied while its score is at or above the threshold, and for the
+ * hold time after it last was.
+ *
+ * The zone of each distance point is calculated once, when the length of the vector
+ * changes, so an update is one pass over the vector with a table lookup per point.
+ */
+
+
+/**
+ * @brief Maximum number of zones
+ */
+#define ACC_PRESENCE_ZONES_MAX 8
+
+
+/**
+ * @brief Maximum number of distance points binned, points above are ignored
+ */
+#define ACC_PRESENCE_ZONES_MAX_POINTS 128
+
+
+/**
+ * @brief State of one zone
+ */
+typedef struct
+{
+	/** Highest presence score in the zone in the last update */
+	float    score;
+	/** True while the zone is occupied */
+	bool     occupied;
+	/** Time when the zone became occupied in ms */
+	uint32_t occupied_start_ms;
+	/** Time when the score last was at or above the threshold in ms */
+	uint32_t last_detection_ms;
+	/** Time the zone has been occupied, or was occupied the last time, in ms */
+	uint32_t occupied_ms;
+	/** Total time the zone has been occupied in ms, not counting the current occupancy */
+	uint32_t total_occupied_ms;
+	/** Number of updates with the score at or above the threshold */
+	uint32_t detections;
+} acc_presence_zone_t;
+
+
+/**
+ * @brief Presence zones
+ */
+typedef struct
+{
+	float    start_m;
+	float    length_m;
+	float    threshold;
+	uint32_t hold_ms;
+	uint16_t zone_count;
+	float    zone_limits_m[ACC_PRESENCE_ZONES_MAX + 1];
+	uint16_t point_count;
+	uint8_t  point_zone[ACC_PRESENCE_ZONES_MAX_POINTS];
+	uint32_t updates;
+
+	acc_presence_zone_t zone[ACC_PRESENCE_ZONES_MAX];
+} acc_presence_zones_t;
+
+
+/**
+ * @brief Initialize presence zones
+ *
+ * Zone i covers the distances from zone_limits_m[i] up to zone_limits_m[i + 1]. Distance
+ * points outside all zones are ignored. The hold time is 0.
+ *
+ * @param[out] zones The presence zones to initialize
+ * @param[in] start_m The start of the presence detector range in m
+ * @param[in] length_m The length of the presence detector range in m
+ * @param[in] zone_limits_m The zone limits in m, zone_count + 1 values in increasing order
+ * @param[in] zone_count The number of zones, at most ACC_PRESENCE_ZONES_MAX
+ * @param[in] threshold The presence score threshold for a zone to be occupied
+ * @return True if successful, false if the zone count or limits are invalid
+ */
+bool acc_presence_zones_init(acc_presence_zones_t *zones, float start_m, float length_m, const float *zone_limits_m,
+                             uint16_t zone_count, float threshold);
+
+
+/**
+ * @brief Initialize presence zones of equal length covering the presence detector range
+ *
+ * @param[out] zones The presence zones to initialize
+ * @param[in] start_m The start of the presence detector range in m
+ * @param[in] length_m The length of the presence detector range in m
+ * @param[in] zone_count The number of zones, at most ACC_PRESENCE_ZONES_MAX
+ * @param[in] threshold The presence score threshold for a zone to be occupied
+ * @return True if successful, false if the zone count is invalid
+ */
+bool acc_presence_zones_uniform_init(acc_presence_zones_t *zones, float start_m, float length_m, uint16_t zone_count,
+                                     float threshold);
+
+
+/**
+ * @brief Set the time a zone stays occupied after its score drops below the threshold
+ *
+ * @param[in] zones The presence zones
+ * @param[in] hold_ms The hold time in ms
+ */
+void acc_presence_zones_hold_time_set(acc_presence_zones_t *zones, uint32_t hold_ms);
+
+
+/**
+ * @brief Update the zones with a distance point vector
+ *
+ * A vector of length 0, for example when the presence detector runs without vector output,
+ * gives all zones the score 0 so that the occupancies time out.
+ *
+ * @param[in] zones The presence zones
+ * @param[in] vector The distance point vector, can be NULL if length is 0
+ * @param[in] length The number of elements in the vector
+ * @param[in] time_ms The time of the vector in ms
+ * @return True if any zone is occupied
+ */
+bool acc_presence_zones_update(acc_presence_zones_t *zones, const float *vector, uint16_t length, uint32_t time_ms);
+
+
+/**
+ * @brief Get the state of a zone
+ *
+ * @param[in] zones The presence zones
+ * @param[in] zone The zone index
+ * @return The zone state
+ */
+const acc_presence_zone_t *acc_presence_zones_get(const acc_presence_zones_t *zones, uint16_t zone);
+
+
+/**
+ * @brief Print the score and occupancy of all zones on one line
+ *
+ * @param[in] zones The presence zones
+ */
+void acc_presence_zones_print(const acc_presence_zones_t *zones);
+
+
+#endif
@@ -0,0 +1,342 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "acc_definitions_a111.h"
+#include "acc_definitions_common.h"
+#include "acc_detector_distance.h"
+#include "acc_detector_presence.h"
+#include "acc_integration_crc.h"
+#include "acc_preset.h"
+#include "acc_service.h"
+
+
+static bool apply_service(acc_service_configuration_t configuration, const acc_preset_entry_t *entry)
+{
+	int32_t i = entry->value.i;
+	float   f = entry->value.f;
+
+	switch (entry->parameter)
+	{
+		case ACC_PRESET_SENSOR:
+			acc_service_sensor_set(configuration, (acc_sensor_id_t)i);
+			break;
+		case ACC_PRESET_START_M:
+			acc_service_requested_start_set(configuration, f);
+			break;
+		case ACC_PRESET_LENGTH_M:
+			acc_service_requested_length_set(configuration, f);
+			break;
+		case ACC_PRESET_PROFILE:
+			acc_service_profile_set(configuration, (acc_service_profile_t)i);
+			break;
+		case ACC_PRESET_HWAAS:
+			acc_service_hw_accelerated_average_samples_set(configuration, (uint8_t)i);
+			break;
+		case ACC_PRESET_RECEIVER_GAIN:
+			acc_service_receiver_gain_set(configuration, f);
+			break;
+		case ACC_PRESET_POWER_SAVE_MODE:
+			acc_service_power_save_mode_set(configuration, (acc_power_save_mode_t)i);
+			break;
+		case ACC_PRESET_ASYNCHRONOUS_MEASUREMENT:
+			acc_service_asynchronous_measurement_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION:
+			acc_service_maximize_signal_attenuation_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_MUR:
+			acc_service_mur_set(configuration, (acc_service_mur_t)i);
+			break;
+		case ACC_PRESET_STREAMING_UPDATE_RATE_HZ:
+			acc_service_repetition_mode_streaming_set(configuration, f);
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool apply_distance(acc_detector_distance_configuration_t configuration, const acc_preset_entry_t *entry)
+{
+	int32_t i = entry->value.i;
+	float   f = entry->value.f;
+
+	switch (entry->parameter)
+	{
+		case ACC_PRESET_SENSOR:
+			acc_detector_distance_configuration_sensor_set(configuration, (acc_sensor_id_t)i);
+			break;
+		case ACC_PRESET_START_M:
+			acc_detector_distance_configuration_requested_start_set(configuration, f);
+			break;
+		case ACC_PRESET_LENGTH_M:
+			acc_detector_distance_configuration_requested_length_set(configuration, f);
+			break;
+		case ACC_PRESET_PROFILE:
+			acc_detector_distance_configuration_service_profile_set(configuration, (acc_service_profile_t)i);
+			break;
+		case ACC_PRESET_HWAAS:
+			acc_detector_distance_configuration_hw_accelerated_average_samples_set(configuration, (uint8_t)i);
+			break;
+		case ACC_PRESET_RECEIVER_GAIN:
+			acc_detector_distance_configuration_receiver_gain_set(configuration, f);
+			break;
+		case ACC_PRESET_POWER_SAVE_MODE:
+			acc_detector_distance_configuration_power_save_mode_set(configuration, (acc_power_save_mode_t)i);
+			break;
+		case ACC_PRESET_ASYNCHRONOUS_MEASUREMENT:
+			acc_detector_distance_configuration_asynchronous_measurement_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_DOWNSAMPLING_FACTOR:
+			acc_detector_distance_configuration_downsampling_factor_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION:
+			acc_detector_distance_configuration_maximize_signal_attenuation_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_MUR:
+			acc_detector_distance_configuration_mur_set(configuration, (acc_service_mur_t)i);
+			break;
+		case ACC_PRESET_SWEEP_AVERAGING:
+			acc_detector_distance_configuration_sweep_averaging_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_THRESHOLD_TYPE:
+			acc_detector_distance_configuration_threshold_type_set(configuration, (acc_detector_distance_threshold_type_t)i);
+			break;
+		case ACC_PRESET_FIXED_THRESHOLD:
+			acc_detector_distance_configuration_fixed_threshold_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_THRESHOLD_SENSITIVITY:
+			acc_detector_distance_configuration_threshold_sensitivity_set(configuration, f);
+			break;
+		case ACC_PRESET_RECORD_BACKGROUND_SWEEPS:
+			acc_detector_distance_configuration_record_background_sweeps_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_CFAR_GUARD_M:
+			acc_detector_distance_configuration_cfar_threshold_guard_set(configuration, f);
+			break;
+		case ACC_PRESET_CFAR_WINDOW_M:
+			acc_detector_distance_configuration_cfar_threshold_window_set(configuration, f);
+			break;
+		case ACC_PRESET_CFAR_ONLY_LOWER_DISTANCE:
+			acc_detector_distance_configuration_cfar_threshold_only_lower_distance_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_PEAK_SORTING:
+			acc_detector_distance_configuration_peak_sorting_set(configuration, (acc_detector_distance_peak_sorting_t)i);
+			break;
+		case ACC_PRESET_PEAK_MERGE_LIMIT_M:
+			acc_detector_distance_configuration_peak_merge_limit_set(configuration, f);
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+
+static bool apply_presence_filter(acc_detector_presence_configuration_t configuration, const acc_preset_entry_t *entry)
+{
+	acc_detector_presence_configuration_filter_parameters_t filter = acc_detector_presence_configuration_filter_parameters_get(
+		configuration);
+
+	switch (entry->parameter)
+	{
+		case ACC_PRESET_INTER_FRAME_DEVIATION_TIME_CONST:
+			filter.inter_frame_deviation_time_const = entry->value.f;
+			break;
+		case ACC_PRESET_INTER_FRAME_FAST_CUTOFF:
+			filter.inter_frame_fast_cutoff = entry->value.f;
+			break;
+		case ACC_PRESET_INTER_FRAME_SLOW_CUTOFF:
+			filter.inter_frame_slow_cutoff = entry->value.f;
+			break;
+		case ACC_PRESET_INTRA_FRAME_TIME_CONST:
+			filter.intra_frame_time_const = entry->value.f;
+			break;
+		case ACC_PRESET_INTRA_FRAME_WEIGHT:
+			filter.intra_frame_weight = entry->value.f;
+			break;
+		case ACC_PRESET_OUTPUT_TIME_CONST:
+			filter.output_time_const = entry->value.f;
+			break;
+		default:
+			return false;
+	}
+
+	acc_detector_presence_configuration_filter_parameters_set(configuration, &filter);
+
+	return true;
+}
+
+
+static bool apply_presence(acc_detector_presence_configuration_t configuration, const acc_preset_entry_t *entry)
+{
+	int32_t i = entry->value.i;
+	float   f = entry->value.f;
+
+	switch (entry->parameter)
+	{
+		case ACC_PRESET_SENSOR:
+			acc_detector_presence_configuration_sensor_set(configuration, (acc_sensor_id_t)i);
+			break;
+		case ACC_PRESET_START_M:
+			acc_detector_presence_configuration_start_set(configuration, f);
+			break;
+		case ACC_PRESET_LENGTH_M:
+			acc_detector_presence_configuration_length_set(configuration, f);
+			break;
+		case ACC_PRESET_PROFILE:
+			acc_detector_presence_configuration_service_profile_set(configuration, (acc_service_profile_t)i);
+			break;
+		case ACC_PRESET_HWAAS:
+			acc_detector_presence_configuration_hw_accelerated_average_samples_set(configuration, (uint8_t)i);
+			break;
+		case ACC_PRESET_RECEIVER_GAIN:
+			acc_detector_presence_configuration_receiver_gain_set(configuration, f);
+			break;
+		case ACC_PRESET_POWER_SAVE_MODE:
+			acc_detector_presence_configuration_power_save_mode_set(configuration, (acc_power_save_mode_t)i);
+			break;
+		case ACC_PRESET_ASYNCHRONOUS_MEASUREMENT:
+			acc_detector_presence_configuration_asynchronous_measurement_set(configuration, i != 0);
+			break;
+		case ACC_PRESET_DOWNSAMPLING_FACTOR:
+			acc_detector_presence_configuration_downsampling_factor_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_UPDATE_RATE_HZ:
+			acc_detector_presence_configuration_update_rate_set(configuration, f);
+			break;
+		case ACC_PRESET_SWEEPS_PER_FRAME:
+			acc_detector_presence_configuration_sweeps_per_frame_set(configuration, (uint16_t)i);
+			break;
+		case ACC_PRESET_SWEEP_RATE_HZ:
+			acc_detector_presence_configuration_sweep_rate_set(configuration, f);
+			break;
+		case ACC_PRESET_DETECTION_THRESHOLD:
+			acc_detector_presence_configuration_detection_threshold_set(configuration, f);
+			break;
+		case ACC_PRESET_NBR_REMOVED_PC:
+			acc_detector_presence_configuration_nbr_removed_pc_set(configuration, (uint8_t)i);
+			break;
+		case ACC_PRESET_VECTOR_OUTPUT_MODE:
+			acc_detector_presence_configuration_vector_output_mode_set(configuration, i != 0);
+			break;
+		default:
+			return apply_presence_filter(configuration, entry);
+	}
+
+	return true;
+}
+
+
+bool acc_preset_apply(const acc_preset_t *preset, void *configuration)
+{
+	bool supported = true;
+
+	for (uint16_t i = 0; i < preset->entry_count; i++)
+	{
+		const acc_preset_entry_t *entry = &preset->entries[i];
+		bool                     applied;
+
+		switch (preset->target)
+		{
+			case ACC_PRESET_TARGET_SERVICE:
+				applied = apply_service(configuration, entry);
+				break;
+			case ACC_PRESET_TARGET_DETECTOR_DISTANCE:
+				applied = apply_distance(configuration, entry);
+				break;
+			case ACC_PRESET_TARGET_DETECTOR_PRESENCE:
+				applied = apply_presence(configuration, entry);
+				break;
+			default:
+				applied = false;
+				break;
+		}
+
+		supported = supported && applied;
+	}
+
+	return supported;
+}
+
+
+bool acc_preset_value_get(const acc_preset_t *preset, acc_preset_parameter_t parameter, acc_preset_value_t *value)
+{
+	bool found = false;
+
+	for (uint16_t i = 0; i < preset->entry_count; i++)
+	{
+		if (preset->entries[i].parameter == parameter)
+		{
+			*value = preset->entries[i].value;
+			found  = true;
+		}
+	}
+
+	return found;
+}
+
+
+uint32_t acc_preset_checksum(const acc_preset_t *preset, const void *extra, size_t extra_size)
+{
+	uint32_t crc    = 0;
+	uint32_t target = (uint32_t)preset->target;
+
+	crc = acc_integration_crc32_update(crc, &target, sizeof(target));
+
+	for (uint16_t i = 0; i < preset->entry_count; i++)
+	{
+		uint32_t parameter = (uint32_t)preset->entries[i].parameter;
+		int32_t  value     = preset->entries[i].value.i;
+
+		crc = acc_integration_crc32_update(crc, &parameter, sizeof(parameter));
+		crc = acc_integration_crc32_update(crc, &value, sizeof(value));
+	}
+
+	if (extra != NULL)
+	{
+		crc = acc_integration_crc32_update(crc, extra, extra_size);
+	}
+
+	return crc;
+}
+
+
+bool acc_preset_changed(acc_preset_state_t *state, uint32_t checksum)
+{
+	bool changed = !state->valid || state->checksum != checksum;
+
+	if (changed)
+	{
+		state->applied++;
+	}
+	else
+	{
+		state->skipped++;
+	}
+
+	return changed;
+}
+
+
+void acc_preset_state_set(acc_preset_state_t *state, uint32_t checksum)
+{
+	state->checksum = checksum;
+	state->valid    = true;
+}
+
+
+void acc_preset_state_invalidate(acc_preset_state_t *state)
+{
+	state->valid = false;
+}
@@ -0,0 +1,253 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_PRESET_H_
+#define ACC_PRESET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * Configuration presets
+ *
+ * A preset is a const table of parameter values, kept in flash, that is applied to a
+ * service, distance detector or presence detector configuration by acc_preset_apply. Only
+ * the parameters in the table are set, others keep their values in the configuration.
+ *
+ * The checksum of a preset covers its target and parameter values, and optionally extra
+ * data for parameters changed outside the preset, such as the gain set by a gain
+ * controller. An application keeps an acc_preset_state_t per handle with the checksum of
+ * the configuration the handle was last created or reconfigured with, and skips
+ * acc_*_reconfigure when the checksum of the next configuration is the same.
+ *
+ * Example:
+ *
+ *     static const acc_preset_entry_t far_range_entries[] =
+ *     {
+ *         ACC_PRESET_FLOAT(ACC_PRESET_START_M, 0.19f),
+ *         ACC_PRESET_FLOAT(ACC_PRESET_LENGTH_M, 1.3f),
+ *         ACC_PRESET_INT(ACC_PRESET_PROFILE, ACC_SERVICE_PROFILE_2),
+ *     };
+ *
+ *     static const acc_preset_t far_range_preset =
+ *     {
+ *         "far range", ACC_PRESET_TARGET_DETECTOR_DISTANCE, far_range_entries, ACC_PRESET_ENTRY_COUNT(far_range_entries)
+ *     };
+ */
+
+
+/**
+ * @brief Number of entries in a preset entry table
+ */
+#define ACC_PRESET_ENTRY_COUNT(entries) ((uint16_t)(sizeof(entries) / sizeof((entries)[0])))
+
+/**
+ * @brief Preset entry with an integer, boolean or enum value
+ */
+#define ACC_PRESET_INT(parameter, value) { (parameter), { .i = (int32_t)(value) } }
+
+/**
+ * @brief Preset entry with a float value
+ */
+#define ACC_PRESET_FLOAT(parameter, value) { (parameter), { .f = (value) } }
+
+
+/**
+ * @brief The type of configuration a preset is applied to
+ */
+typedef enum
+{
+	/** acc_service_configuration_t of any service */
+	ACC_PRESET_TARGET_SERVICE,
+	/** acc_detector_distance_configuration_t */
+	ACC_PRESET_TARGET_DETECTOR_DISTANCE,
+	/** acc_detector_presence_configuration_t */
+	ACC_PRESET_TARGET_DETECTOR_PRESENCE
+} acc_preset_target_t;
+
+
+/**
+ * @brief Preset parameters
+ *
+ * The type of the value is given for each parameter, along with the targets that support it.
+ */
+typedef enum
+{
+	/** Sensor id, int, all */
+	ACC_PRESET_SENSOR,
+	/** Start in m, float, all */
+	ACC_PRESET_START_M,
+	/** Length in m, float, all */
+	ACC_PRESET_LENGTH_M,
+	/** acc_service_profile_t, int, all */
+	ACC_PRESET_PROFILE,
+	/** Hardware accelerated average samples, int, all */
+	ACC_PRESET_HWAAS,
+	/** Receiver gain, float, all */
+	ACC_PRESET_RECEIVER_GAIN,
+	/** acc_power_save_mode_t, int, all */
+	ACC_PRESET_POWER_SAVE_MODE,
+	/** Asynchronous measurement, bool, all */
+	ACC_PRESET_ASYNCHRONOUS_MEASUREMENT,
+	/** Downsampling factor, int, distance and presence detector */
+	ACC_PRESET_DOWNSAMPLING_FACTOR,
+	/** Maximize signal attenuation, bool, service and distance detector */
+	ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION,
+	/** acc_service_mur_t, int, service and distance detector */
+	ACC_PRESET_MUR,
+	/** Streaming repetition mode at this update rate in Hz, float, service */
+	ACC_PRESET_STREAMING_UPDATE_RATE_HZ,
+	/** Sweep averaging, int, distance detector */
+	ACC_PRESET_SWEEP_AVERAGING,
+	/** acc_detector_distance_threshold_type_t, int, distance detector */
+	ACC_PRESET_THRESHOLD_TYPE,
+	/** Fixed threshold, int, distance detector */
+	ACC_PRESET_FIXED_THRESHOLD,
+	/** Threshold sensitivity, float, distance detector */
+	ACC_PRESET_THRESHOLD_SENSITIVITY,
+	/** Number of sweeps to record the background over, int, distance detector */
+	ACC_PRESET_RECORD_BACKGROUND_SWEEPS,
+	/** CFAR guard in m, float, distance detector */
+	ACC_PRESET_CFAR_GUARD_M,
+	/** CFAR window in m, float, distance detector */
+	ACC_PRESET_CFAR_WINDOW_M,
+	/** CFAR threshold only from lower distances, bool, distance detector */
+	ACC_PRESET_CFAR_ONLY_LOWER_DISTANCE,
+	/** acc_detector_distance_peak_sorting_t, int, distance detector */
+	ACC_PRESET_PEAK_SORTING,
+	/** Peak merge limit in m, float, distance detector */
+	ACC_PRESET_PEAK_MERGE_LIMIT_M,
+	/** Update rate in Hz, float, presence detector */
+	ACC_PRESET_UPDATE_RATE_HZ,
+	/** Sweeps per frame, int, presence detector */
+	ACC_PRESET_SWEEPS_PER_FRAME,
+	/** Sweep rate in Hz, float, presence detector */
+	ACC_PRESET_SWEEP_RATE_HZ,
+	/** Detection threshold, float, presence detector */
+	ACC_PRESET_DETECTION_THRESHOLD,
+	/** Number of removed principal components, int, presence detector */
+	ACC_PRESET_NBR_REMOVED_PC,
+	/** Vector output mode, bool, presence detector */
+	ACC_PRESET_VECTOR_OUTPUT_MODE,
+	/** Filter parameters, float, presence detector */
+	ACC_PRESET_INTER_FRAME_DEVIATION_TIME_CONST,
+	ACC_PRESET_INTER_FRAME_FAST_CUTOFF,
+	ACC_PRESET_INTER_FRAME_SLOW_CUTOFF,
+	ACC_PRESET_INTRA_FRAME_TIME_CONST,
+	ACC_PRESET_INTRA_FRAME_WEIGHT,
+	ACC_PRESET_OUTPUT_TIME_CONST
+} acc_preset_parameter_t;
+
+
+/**
+ * @brief Preset parameter value
+ */
+typedef union
+{
+	int32_t i;
+	float   f;
+} acc_preset_value_t;
+
+
+/**
+ * @brief Preset entry, one parameter value
+ */
+typedef struct
+{
+	acc_preset_parameter_t parameter;
+	acc_preset_value_t     value;
+} acc_preset_entry_t;
+
+
+/**
+ * @brief Preset
+ */
+typedef struct
+{
+	const char               *name;
+	acc_preset_target_t      target;
+	const acc_preset_entry_t *entries;
+	uint16_t                 entry_count;
+} acc_preset_t;
+
+
+/**
+ * @brief Checksum of the configuration a handle was last created or reconfigured with
+ */
+typedef struct
+{
+	uint32_t checksum;
+	bool     valid;
+	/** Number of reconfigurations done */
+	uint32_t applied;
+	/** Number of reconfigurations skipped because the checksum was unchanged */
+	uint32_t skipped;
+} acc_preset_state_t;
+
+
+/**
+ * @brief Apply a preset to a configuration
+ *
+ * All entries are applied, also after an entry that is not supported by the target.
+ *
+ * @param[in] preset The preset
+ * @param[in] configuration The configuration of the preset target type
+ * @return True if all entries are supported by the target
+ */
+bool acc_preset_apply(const acc_preset_t *preset, void *configuration);
+
+
+/**
+ * @brief Get the value of a parameter in a preset
+ *
+ * @param[in] preset The preset
+ * @param[in] parameter The parameter
+ * @param[out] value The value of the last entry of the parameter
+ * @return True if the preset has an entry for the parameter
+ */
+bool acc_preset_value_get(const acc_preset_t *preset, acc_preset_parameter_t parameter, acc_preset_value_t *value);
+
+
+/**
+ * @brief Calculate the checksum of a preset
+ *
+ * @param[in] preset The preset
+ * @param[in] extra Data for parameters set outside the preset, can be NULL
+ * @param[in] extra_size The size of the extra data
+ * @return CRC-32 of the preset and the extra data
+ */
+uint32_t acc_preset_checksum(const acc_preset_t *preset, const void *extra, size_t extra_size);
+
+
+/**
+ * @brief Check if a handle needs to be reconfigured
+ *
+ * Counts the result in the state.
+ *
+ * @param[in] state The state of the handle
+ * @param[in] checksum The checksum of the next configuration
+ * @return True if the checksum differs from the last configuration of the handle
+ */
+bool acc_preset_changed(acc_preset_state_t *state, uint32_t checksum);
+
+
+/**
+ * @brief Record the checksum of the configuration a handle was created or reconfigured with
+ *
+ * @param[in] state The state of the handle
+ * @param[in] checksum The checksum of the configuration
+ */
+void acc_preset_state_set(acc_preset_state_t *state, uint32_t checksum);
+
+
+/**
+ * @brief Forget the configuration of a handle, for example when it is destroyed
+ *
+ * @param[in] state The state of the handle
+ */
+void acc_preset_state_invalidate(acc_preset_state_t *state);
+
+
+#endif
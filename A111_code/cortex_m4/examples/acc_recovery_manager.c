@@ -0,0 +1,521 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_detector_presence.h"
+#include "acc_integration.h"
+#include "acc_recovery_manager.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+
+
+#define DEFAULT_ATTEMPTS_PER_ACTION 2
+#define DEFAULT_BACKOFF_INITIAL_MS  10
+#define DEFAULT_BACKOFF_MAX_MS      200
+
+
+#define ACTION_BIT(action) (1U << (action))
+
+
+/**
+ * The actions used for each cause, in order of cost
+ */
+static const uint8_t cause_actions[ACC_RECOVERY_CAUSE_COUNT] =
+{
+	[ACC_RECOVERY_CAUSE_SENSOR_COMMUNICATION_ERROR] = ACTION_BIT(ACC_RECOVERY_ACTION_RECREATE) |
+	                                                  ACTION_BIT(ACC_RECOVERY_ACTION_RECALIBRATE),
+	[ACC_RECOVERY_CAUSE_DATA_SATURATED] = ACTION_BIT(ACC_RECOVERY_ACTION_RECONFIGURE) |
+	                                      ACTION_BIT(ACC_RECOVERY_ACTION_RECREATE) |
+	                                      ACTION_BIT(ACC_RECOVERY_ACTION_RECALIBRATE),
+	[ACC_RECOVERY_CAUSE_DATA_QUALITY_WARNING] = ACTION_BIT(ACC_RECOVERY_ACTION_RETRY) |
+	                                            ACTION_BIT(ACC_RECOVERY_ACTION_RECALIBRATE),
+	[ACC_RECOVERY_CAUSE_MISSED_DATA] = ACTION_BIT(ACC_RECOVERY_ACTION_RETRY) |
+	                                   ACTION_BIT(ACC_RECOVERY_ACTION_RECREATE) |
+	                                   ACTION_BIT(ACC_RECOVERY_ACTION_RECALIBRATE),
+};
+
+
+static bool service_create(void *target)
+{
+	acc_recovery_service_t *service = target;
+
+	service->handle = acc_service_create(service->configuration);
+
+	return service->handle != NULL;
+}
+
+
+static void service_destroy(void *target)
+{
+	acc_recovery_service_t *service = target;
+
+	if (service->handle != NULL)
+	{
+		acc_service_destroy(&service->handle);
+	}
+}
+
+
+static bool service_activate(void *target)
+{
+	acc_recovery_service_t *service = target;
+
+	return acc_service_activate(service->handle);
+}
+
+
+static bool service_deactivate(void *target)
+{
+	acc_recovery_service_t *service = target;
+
+	return acc_service_deactivate(service->handle);
+}
+
+
+static float service_gain_get(void *target)
+{
+	acc_recovery_service_t *service = target;
+
+	return acc_service_receiver_gain_get(service->configuration);
+}
+
+
+static void service_gain_set(void *target, float gain)
+{
+	acc_recovery_service_t *service = target;
+
+	acc_service_receiver_gain_set(service->configuration, gain);
+}
+
+
+const acc_recovery_target_ops_t acc_recovery_service_ops =
+{
+	.create      = service_create,
+	.destroy     = service_destroy,
+	.activate    = service_activate,
+	.deactivate  = service_deactivate,
+	.reconfigure = NULL,
+	.gain_get    = service_gain_get,
+	.gain_set    = service_gain_set,
+};
+
+
+static bool presence_create(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	presence->handle = acc_detector_presence_create(presence->configuration);
+
+	return presence->handle != NULL;
+}
+
+
+static void presence_destroy(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	if (presence->handle != NULL)
+	{
+		acc_detector_presence_destroy(&presence->handle);
+	}
+}
+
+
+static bool presence_activate(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	return acc_detector_presence_activate(presence->handle);
+}
+
+
+static bool presence_deactivate(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	return acc_detector_presence_deactivate(presence->handle);
+}
+
+
+static bool presence_reconfigure(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	return acc_detector_presence_reconfigure(&presence->handle, presence->configuration);
+}
+
+
+static float presence_gain_get(void *target)
+{
+	acc_recovery_presence_t *presence = target;
+
+	return acc_detector_presence_configuration_receiver_gain_get(presence->configuration);
+}
+
+
+static void presence_gain_set(void *target, float gain)
+{
+	acc_recovery_presence_t *presence = target;
+
+	acc_detector_presence_configuration_receiver_gain_set(presence->configuration, gain);
+}
+
+
+const acc_recovery_target_ops_t acc_recovery_presence_ops =
+{
+	.create      = presence_create,
+	.destroy     = presence_destroy,
+	.activate    = presence_activate,
+	.deactivate  = presence_deactivate,
+	.reconfigure = presence_reconfigure,
+	.gain_get    = presence_gain_get,
+	.gain_set    = presence_gain_set,
+};
+
+
+static acc_recovery_action_t next_action(acc_recovery_cause_t cause, acc_recovery_action_t action)
+{
+	do
+	{
+		action++;
+	} while (action < ACC_RECOVERY_ACTION_FAILED && (cause_actions[cause] & ACTION_BIT(action)) == 0);
+
+	return action;
+}
+
+
+static void save_calibration_context(acc_recovery_manager_t *manager)
+{
+	manager->calibration_context_valid = acc_rss_calibration_context_get(manager->sensor_id, &manager->calibration_context);
+}
+
+
+/**
+ * @brief Destroy and create the target, with the saved calibration unless recalibrate is set
+ */
+static bool recreate(acc_recovery_manager_t *manager, bool recalibrate)
+{
+	manager->ops->destroy(manager->target);
+
+	if (recalibrate || !manager->calibration_context_valid)
+	{
+		manager->calibration_context_valid = false;
+		acc_rss_calibration_reset(manager->sensor_id);
+	}
+	else if (!acc_rss_calibration_context_set(manager->sensor_id, &manager->calibration_context))
+	{
+		manager->calibration_context_valid = false;
+	}
+
+	if (!manager->ops->create(manager->target))
+	{
+		return false;
+	}
+
+	if (!manager->calibration_context_valid)
+	{
+		save_calibration_context(manager);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Set the gain from the gain controller and reconfigure the target
+ */
+static bool apply_gain(acc_recovery_manager_t *manager)
+{
+	const acc_recovery_target_ops_t *ops = manager->ops;
+
+	ops->gain_set(manager->target, acc_gain_controller_gain_get(&manager->gain_controller));
+	ops->deactivate(manager->target);
+
+	bool success = (ops->reconfigure != NULL) ? ops->reconfigure(manager->target) : recreate(manager, false);
+
+	return success && ops->activate(manager->target);
+}
+
+
+static bool perform(acc_recovery_manager_t *manager, acc_recovery_action_t action)
+{
+	const acc_recovery_target_ops_t *ops     = manager->ops;
+	bool                            success = false;
+
+	switch (action)
+	{
+		case ACC_RECOVERY_ACTION_RETRY:
+			return true;
+		case ACC_RECOVERY_ACTION_RECONFIGURE:
+			if (ops->gain_set == NULL || !acc_gain_controller_update(&manager->gain_controller, true, 0))
+			{
+				return false;
+			}
+
+			return apply_gain(manager);
+		case ACC_RECOVERY_ACTION_RECREATE:
+			ops->deactivate(manager->target);
+			success = recreate(manager, false);
+			break;
+		case ACC_RECOVERY_ACTION_RECALIBRATE:
+			ops->deactivate(manager->target);
+			success = recreate(manager, true);
+			break;
+		default:
+			break;
+	}
+
+	return success && ops->activate(manager->target);
+}
+
+
+static acc_recovery_cause_t get_cause(const acc_recovery_indications_t *indications)
+{
+	if (indications->sensor_communication_error)
+	{
+		return ACC_RECOVERY_CAUSE_SENSOR_COMMUNICATION_ERROR;
+	}
+
+	if (indications->data_saturated)
+	{
+		return ACC_RECOVERY_CAUSE_DATA_SATURATED;
+	}
+
+	if (indications->data_quality_warning)
+	{
+		return ACC_RECOVERY_CAUSE_DATA_QUALITY_WARNING;
+	}
+
+	if (indications->missed_data)
+	{
+		return ACC_RECOVERY_CAUSE_MISSED_DATA;
+	}
+
+	return ACC_RECOVERY_CAUSE_COUNT;
+}
+
+
+void acc_recovery_manager_init(acc_recovery_manager_t *manager, const acc_recovery_target_ops_t *ops, void *target,
+                               acc_sensor_id_t sensor_id)
+{
+	memset(manager, 0, sizeof(*manager));
+
+	manager->attempts_per_action = DEFAULT_ATTEMPTS_PER_ACTION;
+	manager->backoff_initial_ms  = DEFAULT_BACKOFF_INITIAL_MS;
+	manager->backoff_max_ms      = DEFAULT_BACKOFF_MAX_MS;
+	manager->ops                 = ops;
+	manager->target              = target;
+	manager->sensor_id           = sensor_id;
+
+	if (ops->gain_get != NULL)
+	{
+		acc_gain_controller_init(&manager->gain_controller, ops->gain_get(target), 0);
+	}
+
+	save_calibration_context(manager);
+}
+
+
+acc_recovery_action_t acc_recovery_manager_handle(acc_recovery_manager_t *manager, const acc_recovery_indications_t *indications)
+{
+	acc_recovery_cause_t cause = get_cause(indications);
+
+	if (cause == ACC_RECOVERY_CAUSE_COUNT)
+	{
+		if (manager->active)
+		{
+			acc_recovery_stats_t *stats   = &manager->stats[manager->cause];
+			uint32_t             latency = acc_integration_get_time() - manager->start_time_ms;
+
+			stats->recovered++;
+			stats->last_latency_ms   = latency;
+			stats->total_latency_ms += latency;
+			stats->max_latency_ms    = (latency > stats->max_latency_ms) ? latency : stats->max_latency_ms;
+			manager->active          = false;
+		}
+
+		if (manager->ops->gain_set != NULL &&
+		    acc_gain_controller_update(&manager->gain_controller, false, indications->peak))
+		{
+			// A failed reconfigure shows up in the next result and is recovered then
+			manager->stats[ACC_RECOVERY_CAUSE_DATA_SATURATED].actions[ACC_RECOVERY_ACTION_RECONFIGURE]++;
+			apply_gain(manager);
+		}
+
+		return ACC_RECOVERY_ACTION_NONE;
+	}
+
+	if (!manager->active || cause != manager->cause)
+	{
+		if (!manager->active)
+		{
+			manager->start_time_ms = acc_integration_get_time();
+		}
+
+		manager->active   = true;
+		manager->cause    = cause;
+		manager->action   = next_action(cause, ACC_RECOVERY_ACTION_NONE);
+		manager->attempts = 0;
+		manager->stats[cause].recoveries++;
+	}
+	else if (manager->attempts >= manager->attempts_per_action && manager->action != ACC_RECOVERY_ACTION_RECONFIGURE)
+	{
+		// Reconfigure is repeated as long as the gain can be lowered
+		manager->action   = next_action(cause, manager->action);
+		manager->attempts = 0;
+	}
+
+	while (manager->action != ACC_RECOVERY_ACTION_FAILED)
+	{
+		if (manager->attempts > 0)
+		{
+			uint32_t backoff_ms = (uint32_t)manager->backoff_initial_ms << (manager->attempts - 1);
+
+			acc_integration_sleep_ms((backoff_ms < manager->backoff_max_ms) ? backoff_ms : manager->backoff_max_ms);
+		}
+
+		manager->attempts++;
+		manager->stats[cause].actions[manager->action]++;
+
+		if (perform(manager, manager->action))
+		{
+			return manager->action;
+		}
+
+		manager->action   = next_action(cause, manager->action);
+		manager->attempts = 0;
+	}
+
+	manager->stats[cause].actions[ACC_RECOVERY_ACTION_FAILED]++;
+	manager->stats[cause].failures++;
+	manager->active = false;
+
+	return ACC_RECOVERY_ACTION_FAILED;
+}
+
+
+const acc_recovery_stats_t *acc_recovery_manager_stats_get(const acc_recovery_manager_t *manager, acc_recovery_cause_t cause)
+{
+	return &manager->stats[cause];
+}
+
+
+const char *acc_recovery_cause_name(acc_recovery_cause_t cause)
+{
+	static const char *names[ACC_RECOVERY_CAUSE_COUNT] =
+	{
+		[ACC_RECOVERY_CAUSE_SENSOR_COMMUNICATION_ERROR] = "sensor communication error",
+		[ACC_RECOVERY_CAUSE_DATA_SATURATED]             = "data saturated",
+		[ACC_RECOVERY_CAUSE_DATA_QUALITY_WARNING]       = "data quality warning",
+		[ACC_RECOVERY_CAUSE_MISSED_DATA]                = "missed data",
+	};
+
+	return (cause < ACC_RECOVERY_CAUSE_COUNT) ? names[cause] : "unknown";
+}
+
+
+const char *acc_recovery_action_name(acc_recovery_action_t action)
+{
+	static const char *names[ACC_RECOVERY_ACTION_COUNT] =
+	{
+		[ACC_RECOVERY_ACTION_NONE]        = "none",
+		[ACC_RECOVERY_ACTION_RETRY]       = "retry",
+		[ACC_RECOVERY_ACTION_RECONFIGURE] = "reconfigure",
+		[ACC_RECOVERY_ACTION_RECREATE]    = "recreate",
+		[ACC_RECOVERY_ACTION_RECALIBRATE] = "recalibrate",
+		[ACC_RECOVERY_ACTION_FAILED]      = "failed",
+	};
+
+	return (action < ACC_RECOVERY_ACTION_COUNT) ? names[action] : "unknown";
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_envelope(const acc_service_envelope_result_info_t *result_info)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = result_info->missed_data,
+		.sensor_communication_error = result_info->sensor_communication_error,
+		.data_saturated             = result_info->data_saturated,
+		.data_quality_warning       = result_info->data_quality_warning,
+	};
+
+	return indications;
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_iq(const acc_service_iq_result_info_t *result_info)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = result_info->missed_data,
+		.sensor_communication_error = result_info->sensor_communication_error,
+		.data_saturated             = result_info->data_saturated,
+		.data_quality_warning       = result_info->data_quality_warning,
+	};
+
+	return indications;
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_power_bins(const acc_service_power_bins_result_info_t *result_info)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = result_info->missed_data,
+		.sensor_communication_error = result_info->sensor_communication_error,
+		.data_saturated             = result_info->data_saturated,
+		.data_quality_warning       = result_info->data_quality_warning,
+	};
+
+	return indications;
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_sparse(const acc_service_sparse_result_info_t *result_info)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = result_info->missed_data,
+		.sensor_communication_error = result_info->sensor_communication_error,
+		.data_saturated             = result_info->data_saturated,
+		.data_quality_warning       = false,
+	};
+
+	return indications;
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_distance(const acc_detector_distance_result_info_t *result_info)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = result_info->missed_data,
+		.sensor_communication_error = result_info->sensor_communication_error,
+		.data_saturated             = result_info->data_saturated,
+		.data_quality_warning       = result_info->data_quality_warning,
+	};
+
+	return indications;
+}
+
+
+acc_recovery_indications_t acc_recovery_indications_presence(const acc_detector_presence_result_t *result)
+{
+	acc_recovery_indications_t indications =
+	{
+		.missed_data                = false,
+		.sensor_communication_error = result->sensor_communication_error,
+		.data_saturated             = result->data_saturated,
+		.data_quality_warning       = false,
+	};
+
+	return indications;
+}
@@ -0,0 +1,259 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_RECOVERY_MANAGER_H_
+#define ACC_RECOVERY_MANAGER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "acc_definitions_a111.h"
+#include "acc_definitions_common.h"
+#include "acc_detector_distance.h"
+#include "acc_detector_presence.h"
+#include "acc_gain_controller.h"
+#include "acc_service.h"
+#include "acc_service_envelope.h"
+#include "acc_service_iq.h"
+#include "acc_service_power_bins.h"
+#include "acc_service_sparse.h"
+
+
+/**
+ * Recovery manager for indications in result info
+ *
+ * Each indication is handled with the cheapest action first and escalated when the
+ * indication remains:
+ *   - Retry, just get the next result again (missed data, data quality warning)
+ *   - Reconfigure, lower the receiver gain and reconfigure (data saturated). The gain is
+ *     searched by a gain controller, which keeps raising it again on results without
+ *     saturation until the highest gain without saturation is found. Targets without a
+ *     reconfigure operation are destroyed and created instead, with the saved calibration.
+ *     RSS has no reconfigure for services, so for acc_recovery_service_ops this step is a
+ *     recreate. The presence detector is reconfigured in place.
+ *   - Recreate, destroy and create the target reusing the sensor calibration
+ *     (all except data quality warning)
+ *   - Recalibrate, destroy and create the target with a new sensor calibration
+ *
+ * A recovery ends at the first result without indications. The time from the first
+ * indication to that result is recorded as the recovery latency of the cause.
+ */
+
+
+/**
+ * @brief Cause of a recovery, in order of severity
+ */
+typedef enum
+{
+	ACC_RECOVERY_CAUSE_SENSOR_COMMUNICATION_ERROR,
+	ACC_RECOVERY_CAUSE_DATA_SATURATED,
+	ACC_RECOVERY_CAUSE_DATA_QUALITY_WARNING,
+	ACC_RECOVERY_CAUSE_MISSED_DATA,
+	ACC_RECOVERY_CAUSE_COUNT
+} acc_recovery_cause_t;
+
+
+/**
+ * @brief Recovery action, in order of cost
+ */
+typedef enum
+{
+	ACC_RECOVERY_ACTION_NONE,
+	ACC_RECOVERY_ACTION_RETRY,
+	ACC_RECOVERY_ACTION_RECONFIGURE,
+	ACC_RECOVERY_ACTION_RECREATE,
+	ACC_RECOVERY_ACTION_RECALIBRATE,
+	ACC_RECOVERY_ACTION_FAILED,
+	ACC_RECOVERY_ACTION_COUNT
+} acc_recovery_action_t;
+
+
+/**
+ * @brief Indications from a result info, common to all services and detectors
+ */
+typedef struct
+{
+	bool     missed_data;
+	bool     sensor_communication_error;
+	bool     data_saturated;
+	bool     data_quality_warning;
+	/** Peak amplitude of the result, only used if the gain controller has a full scale */
+	uint16_t peak;
+} acc_recovery_indications_t;
+
+
+/**
+ * @brief Operations on the target of the recovery, for example a service or a detector
+ *
+ * The create operation creates the target from its current configuration and may
+ * not activate it. reconfigure may be NULL, the target is then destroyed and created.
+ * gain_get and gain_set access the receiver gain in the configuration and may both be
+ * NULL if the gain should not be controlled.
+ */
+typedef struct
+{
+	bool (*create)(void *target);
+	void (*destroy)(void *target);
+	bool (*activate)(void *target);
+	bool (*deactivate)(void *target);
+	bool (*reconfigure)(void *target);
+	float (*gain_get)(void *target);
+	void (*gain_set)(void *target, float gain);
+} acc_recovery_target_ops_t;
+
+
+/**
+ * @brief Recovery target for a service
+ */
+typedef struct
+{
+	acc_service_handle_t        handle;
+	acc_service_configuration_t configuration;
+} acc_recovery_service_t;
+
+
+/**
+ * @brief Operations for an acc_recovery_service_t target
+ *
+ * Services can not be reconfigured, a new gain is applied by destroying and creating
+ * the service with the saved calibration.
+ */
+extern const acc_recovery_target_ops_t acc_recovery_service_ops;
+
+
+/**
+ * @brief Recovery target for a presence detector
+ */
+typedef struct
+{
+	acc_detector_presence_handle_t        handle;
+	acc_detector_presence_configuration_t configuration;
+} acc_recovery_presence_t;
+
+
+/**
+ * @brief Operations for an acc_recovery_presence_t target, with reconfigure
+ */
+extern const acc_recovery_target_ops_t acc_recovery_presence_ops;
+
+
+/**
+ * @brief Recovery statistics per cause
+ */
+typedef struct
+{
+	/** Number of recoveries started */
+	uint32_t recoveries;
+	/** Number of recoveries that ended with a result without indications */
+	uint32_t recovered;
+	/** Number of recoveries that failed */
+	uint32_t failures;
+	/** Number of times each action was taken */
+	uint32_t actions[ACC_RECOVERY_ACTION_COUNT];
+	/** Latency of the last successful recovery in ms */
+	uint32_t last_latency_ms;
+	/** Highest latency of a successful recovery in ms */
+	uint32_t max_latency_ms;
+	/** Sum of the latencies of all successful recoveries in ms */
+	uint32_t total_latency_ms;
+} acc_recovery_stats_t;
+
+
+/**
+ * @brief Recovery manager
+ *
+ * The configuration fields may be changed after acc_recovery_manager_init.
+ */
+typedef struct
+{
+	/** Number of attempts of an action before escalating to the next action */
+	uint16_t attempts_per_action;
+	/** Delay before the second attempt of an action, doubled for every further attempt */
+	uint16_t backoff_initial_ms;
+	/** Maximum delay between attempts */
+	uint16_t backoff_max_ms;
+
+	/** Receiver gain controller, full_scale may be set to also control the peak level */
+	acc_gain_controller_t gain_controller;
+
+	const acc_recovery_target_ops_t *ops;
+	void                            *target;
+	acc_sensor_id_t                 sensor_id;
+
+	acc_calibration_context_t calibration_context;
+	bool                      calibration_context_valid;
+
+	bool                  active;
+	acc_recovery_cause_t  cause;
+	acc_recovery_action_t action;
+	uint16_t              attempts;
+	uint32_t              start_time_ms;
+
+	acc_recovery_stats_t stats[ACC_RECOVERY_CAUSE_COUNT];
+} acc_recovery_manager_t;
+
+
+/**
+ * @brief Initialize a recovery manager
+ *
+ * The target must be created. The calibration context of the sensor is saved so that
+ * a recreate does not have to recalibrate.
+ *
+ * @param[out] manager The recovery manager to initialize
+ * @param[in] ops The operations on the target
+ * @param[in] target The target, passed to the operations
+ * @param[in] sensor_id The sensor used by the target
+ */
+void acc_recovery_manager_init(acc_recovery_manager_t *manager, const acc_recovery_target_ops_t *ops, void *target,
+                               acc_sensor_id_t sensor_id);
+
+
+/**
+ * @brief Handle the indications from the last result
+ *
+ * Results without indications are passed to the gain controller. If it changes the
+ * gain the target is reconfigured, the result is still valid.
+ *
+ * @param[in] manager The recovery manager
+ * @param[in] indications The indications from the result info
+ * @return The action taken. ACC_RECOVERY_ACTION_NONE means the result is valid,
+ *         ACC_RECOVERY_ACTION_FAILED that the target could not be recovered and
+ *         any other action that the result should be discarded and fetched again.
+ */
+acc_recovery_action_t acc_recovery_manager_handle(acc_recovery_manager_t *manager, const acc_recovery_indications_t *indications);
+
+
+/**
+ * @brief Get recovery statistics for a cause
+ *
+ * @param[in] manager The recovery manager
+ * @param[in] cause The cause
+ * @return The statistics of the cause
+ */
+const acc_recovery_stats_t *acc_recovery_manager_stats_get(const acc_recovery_manager_t *manager, acc_recovery_cause_t cause);
+
+
+/**
+ * @brief Get the name of a cause
+ */
+const char *acc_recovery_cause_name(acc_recovery_cause_t cause);
+
+
+/**
+ * @brief Get the name of an action
+ */
+const char *acc_recovery_action_name(acc_recovery_action_t action);
+
+
+/**
+ * @brief Get the indications from a service or detector result info
+ */
+acc_recovery_indications_t acc_recovery_indications_envelope(const acc_service_envelope_result_info_t *result_info);
+acc_recovery_indications_t acc_recovery_indications_iq(const acc_service_iq_result_info_t *result_info);
+acc_recovery_indications_t acc_recovery_indications_power_bins(const acc_service_power_bins_result_info_t *result_info);
+acc_recovery_indications_t acc_recovery_indications_sparse(const acc_service_sparse_result_info_t *result_info);
+acc_recovery_indications_t acc_recovery_indications_distance(const acc_detector_distance_result_info_t *result_info);
+acc_recovery_indications_t acc_recovery_indications_presence(const acc_detector_presence_result_t *result);
+
+
+#endif
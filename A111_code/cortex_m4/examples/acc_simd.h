@@ -0,0 +1,241 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_SIMD_H_
+#define ACC_SIMD_H_
+
+#include <stdint.h>
+#include <string.h>
+
+
+/**
+ * SIMD helpers for packed 16 bit data
+ *
+ * On a core with the DSP extension, such as the Cortex-M4, the helpers map to the CMSIS
+ * intrinsics. Elsewhere, or when ACC_SIMD_DISABLE is defined, portable C with the same
+ * results is used, so that the kernels built on the helpers can be run and compared on a
+ * host.
+ *
+ * Two 16 bit values are packed in a uint32_t with the first value, the one at the lower
+ * address, in the lower half word.
+ */
+
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && !defined(ACC_SIMD_DISABLE)
+#include "cmsis_compiler.h"
+#define ACC_SIMD_DSP 1
+#else
+#define ACC_SIMD_DSP 0
+#endif
+
+
+/**
+ * @brief Read two 16 bit values as one packed word
+ *
+ * @param[in] data Pointer to the first value, no alignment needed
+ * @return The packed values
+ */
+static inline uint32_t acc_simd_read_x2(const void *data)
+{
+	uint32_t packed;
+
+	memcpy(&packed, data, sizeof(packed));
+	return packed;
+}
+
+
+/**
+ * @brief Write one packed word as two 16 bit values
+ *
+ * @param[out] data Pointer to the first value, no alignment needed
+ * @param[in] packed The packed values
+ */
+static inline void acc_simd_write_x2(void *data, uint32_t packed)
+{
+	memcpy(data, &packed, sizeof(packed));
+}
+
+
+/**
+ * @brief Pack two signed 16 bit values
+ *
+ * @param[in] low The value in the lower half word
+ * @param[in] high The value in the upper half word
+ * @return The packed values
+ */
+static inline uint32_t acc_simd_pack(int16_t low, int16_t high)
+{
+	return (uint32_t)(uint16_t)low | ((uint32_t)(uint16_t)high << 16);
+}
+
+
+/**
+ * @brief Get the lower signed 16 bit value of a packed word
+ */
+static inline int16_t acc_simd_low(uint32_t packed)
+{
+	return (int16_t)(uint16_t)(packed & 0xffff);
+}
+
+
+/**
+ * @brief Get the upper signed 16 bit value of a packed word
+ */
+static inline int16_t acc_simd_high(uint32_t packed)
+{
+	return (int16_t)(uint16_t)(packed >> 16);
+}
+
+
+#if !ACC_SIMD_DSP
+/**
+ * @brief Saturate a value to signed 16 bit, used by the portable C versions
+ */
+static inline int16_t acc_simd_saturate16(int32_t value)
+{
+	return (int16_t)((value > INT16_MAX) ? INT16_MAX : ((value < INT16_MIN) ? INT16_MIN : value));
+}
+#endif
+
+
+/**
+ * @brief Saturating signed addition of two pairs of 16 bit values, __QADD16
+ */
+static inline uint32_t acc_simd_qadd16(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return __QADD16(x, y);
+#else
+	return acc_simd_pack(acc_simd_saturate16((int32_t)acc_simd_low(x) + acc_simd_low(y)),
+	                     acc_simd_saturate16((int32_t)acc_simd_high(x) + acc_simd_high(y)));
+#endif
+}
+
+
+/**
+ * @brief Saturating signed subtraction of two pairs of 16 bit values, __QSUB16
+ */
+static inline uint32_t acc_simd_qsub16(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return __QSUB16(x, y);
+#else
+	return acc_simd_pack(acc_simd_saturate16((int32_t)acc_simd_low(x) - acc_simd_low(y)),
+	                     acc_simd_saturate16((int32_t)acc_simd_high(x) - acc_simd_high(y)));
+#endif
+}
+
+
+/**
+ * @brief Addition of two pairs of 16 bit values, wrapping on overflow, __UADD16
+ */
+static inline uint32_t acc_simd_add16(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return __UADD16(x, y);
+#else
+	return ((x + y) & 0xffff) | (((x >> 16) + (y >> 16)) << 16);
+#endif
+}
+
+
+/**
+ * @brief Saturating unsigned subtraction of two pairs of 16 bit values, __UQSUB16
+ *
+ * Differences below zero are clamped to zero.
+ */
+static inline uint32_t acc_simd_uqsub16(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return __UQSUB16(x, y);
+#else
+	uint32_t low  = ((x & 0xffff) > (y & 0xffff)) ? (x & 0xffff) - (y & 0xffff) : 0;
+	uint32_t high = ((x >> 16) > (y >> 16)) ? (x >> 16) - (y >> 16) : 0;
+
+	return low | (high << 16);
+#endif
+}
+
+
+/**
+ * @brief Unsigned halving subtraction of two pairs of 16 bit values, __UHSUB16
+ *
+ * Each result is (x - y) / 2 rounded down, which always fits a signed 16 bit value.
+ */
+static inline uint32_t acc_simd_uhsub16(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return __UHSUB16(x, y);
+#else
+	uint32_t low  = (((x & 0xffff) - (y & 0xffff)) >> 1) & 0xffff;
+	uint32_t high = (((x >> 16) - (y >> 16)) >> 1) & 0xffff;
+
+	return low | (high << 16);
+#endif
+}
+
+
+/**
+ * @brief Dual signed 16 bit multiply, sum of products, __SMUAD
+ *
+ * x.low * y.low + x.high * y.high, wrapping on overflow.
+ */
+static inline int32_t acc_simd_smuad(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return (int32_t)__SMUAD(x, y);
+#else
+	return (int32_t)((uint32_t)((int32_t)acc_simd_low(x) * acc_simd_low(y)) +
+	                 (uint32_t)((int32_t)acc_simd_high(x) * acc_simd_high(y)));
+#endif
+}
+
+
+/**
+ * @brief Dual signed 16 bit multiply exchanged, difference of products, __SMUSDX
+ *
+ * x.low * y.high - x.high * y.low, wrapping on overflow.
+ */
+static inline int32_t acc_simd_smusdx(uint32_t x, uint32_t y)
+{
+#if ACC_SIMD_DSP
+	return (int32_t)__SMUSDX(x, y);
+#else
+	return (int32_t)((uint32_t)((int32_t)acc_simd_low(x) * acc_simd_high(y)) -
+	                 (uint32_t)((int32_t)acc_simd_high(x) * acc_simd_low(y)));
+#endif
+}
+
+
+/**
+ * @brief Dual signed 16 bit multiply with 32 bit accumulate, __SMLAD
+ *
+ * acc + x.low * y.low + x.high * y.high, wrapping on overflow.
+ */
+static inline int32_t acc_simd_smlad(uint32_t x, uint32_t y, int32_t acc)
+{
+#if ACC_SIMD_DSP
+	return (int32_t)__SMLAD(x, y, (uint32_t)acc);
+#else
+	return (int32_t)((uint32_t)acc + (uint32_t)((int32_t)acc_simd_low(x) * acc_simd_low(y)) +
+	                 (uint32_t)((int32_t)acc_simd_high(x) * acc_simd_high(y)));
+#endif
+}
+
+
+/**
+ * @brief Dual signed 16 bit multiply with 64 bit accumulate, __SMLALD
+ *
+ * acc + x.low * y.low + x.high * y.high.
+ */
+static inline int64_t acc_simd_smlald(uint32_t x, uint32_t y, int64_t acc)
+{
+#if ACC_SIMD_DSP
+	return (int64_t)__SMLALD(x, y, (uint64_t)acc);
+#else
+	return acc + ((int32_t)acc_simd_low(x) * acc_simd_low(y)) + ((int32_t)acc_simd_high(x) * acc_simd_high(y));
+#endif
+}
+
+
+#endif
@@ -0,0 +1,234 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "acc_integration.h"
+#include "acc_simd.h"
+#include "acc_sparse_dsp.h"
+
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Offset of the unsigned sparse data, flipping the sign bit of each half word converts it to signed
+#define SPARSE_OFFSET    32768U
+#define SPARSE_OFFSET_X2 0x80008000U
+
+
+static int16_t centered_mean(uint32_t sum, uint16_t sweeps)
+{
+	return (int16_t)((int32_t)((sum + (sweeps / 2U)) / sweeps) - (int32_t)SPARSE_OFFSET);
+}
+
+
+/**
+ * @brief Calculate the means of two neighbouring points and write their DC removed sweeps
+ */
+static void remove_dc_x2(acc_sparse_dsp_t *dsp, const uint16_t *frame, uint16_t point)
+{
+	uint16_t sweeps = dsp->sweeps_per_frame;
+	uint16_t length = dsp->sweep_length;
+	uint32_t sum0   = 0;
+	uint32_t sum1   = 0;
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		uint32_t values = acc_simd_read_x2(&frame[(sweep * length) + point]);
+
+		sum0 += values & 0xffff;
+		sum1 += values >> 16;
+	}
+
+	dsp->mean[point]     = (float)sum0 / (float)sweeps;
+	dsp->mean[point + 1] = (float)sum1 / (float)sweeps;
+
+	uint32_t means = acc_simd_pack(centered_mean(sum0, sweeps), centered_mean(sum1, sweeps));
+	int16_t  *row0 = &dsp->deviation[point * dsp->deviation_stride];
+	int16_t  *row1 = row0 + dsp->deviation_stride;
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		uint32_t values     = acc_simd_read_x2(&frame[(sweep * length) + point]) ^ SPARSE_OFFSET_X2;
+		uint32_t deviations = acc_simd_qsub16(values, means);
+
+		row0[sweep] = acc_simd_low(deviations);
+		row1[sweep] = acc_simd_high(deviations);
+	}
+}
+
+
+/**
+ * @brief Calculate the mean of a single point and write its DC removed sweeps
+ */
+static void remove_dc(acc_sparse_dsp_t *dsp, const uint16_t *frame, uint16_t point)
+{
+	uint16_t sweeps = dsp->sweeps_per_frame;
+	uint16_t length = dsp->sweep_length;
+	uint32_t sum    = 0;
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		sum += frame[(sweep * length) + point];
+	}
+
+	dsp->mean[point] = (float)sum / (float)sweeps;
+
+	uint32_t mean = acc_simd_pack(centered_mean(sum, sweeps), 0);
+	int16_t  *row = &dsp->deviation[point * dsp->deviation_stride];
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		uint32_t value = (uint32_t)(frame[(sweep * length) + point] ^ SPARSE_OFFSET);
+
+		row[sweep] = acc_simd_low(acc_simd_qsub16(value, mean));
+	}
+}
+
+
+/**
+ * @brief Sum the squared deviations and the products of consecutive deviations of a point
+ *
+ * The row has an even length, padded with a zero for an odd number of sweeps, and is
+ * read two sweeps at a time.
+ */
+static void energy_correlation(const int16_t *row, uint16_t stride, int64_t *energy, int64_t *correlation)
+{
+	int64_t  r0      = 0;
+	int64_t  r1      = 0;
+	uint32_t current = acc_simd_read_x2(&row[0]);
+
+	for (uint16_t sweep = 0; sweep < stride; sweep += 2)
+	{
+		uint32_t next = (sweep + 2 < stride) ? acc_simd_read_x2(&row[sweep + 2]) : 0;
+
+		// The pair shifted one sweep, for the products of consecutive sweeps
+		uint32_t shifted = (current >> 16) | (next << 16);
+
+		r0 = acc_simd_smlald(current, current, r0);
+		r1 = acc_simd_smlald(current, shifted, r1);
+
+		current = next;
+	}
+
+	*energy      = r0;
+	*correlation = r1;
+}
+
+
+static float estimate_speed(float correlation, float sweep_rate_hz)
+{
+	correlation = (correlation > 1.0f) ? 1.0f : ((correlation < -1.0f) ? -1.0f : correlation);
+
+	float phase_step   = acosf(correlation);
+	float frequency_hz = phase_step * sweep_rate_hz / (2.0f * (float)M_PI);
+
+	return frequency_hz * ACC_SPARSE_DSP_WAVELENGTH_M / 2.0f;
+}
+
+
+bool acc_sparse_dsp_create(acc_sparse_dsp_t *dsp, uint16_t sweeps_per_frame, uint16_t sweep_length, float sweep_rate_hz,
+                           float filter_factor)
+{
+	memset(dsp, 0, sizeof(*dsp));
+
+	dsp->sweeps_per_frame = sweeps_per_frame;
+	dsp->sweep_length     = sweep_length;
+	dsp->sweep_rate_hz    = sweep_rate_hz;
+	dsp->filter_factor    = filter_factor;
+	dsp->deviation_stride = (uint16_t)((sweeps_per_frame + 1U) & ~1U);
+
+	if (sweeps_per_frame == 0 || sweep_length == 0)
+	{
+		return false;
+	}
+
+	dsp->mean            = acc_integration_mem_calloc(sweep_length, sizeof(*dsp->mean));
+	dsp->variance        = acc_integration_mem_calloc(sweep_length, sizeof(*dsp->variance));
+	dsp->energy          = acc_integration_mem_calloc(sweep_length, sizeof(*dsp->energy));
+	dsp->filtered_energy = acc_integration_mem_calloc(sweep_length, sizeof(*dsp->filtered_energy));
+	dsp->correlation     = acc_integration_mem_calloc(sweep_length, sizeof(*dsp->correlation));
+	dsp->deviation       = acc_integration_mem_calloc((size_t)sweep_length * dsp->deviation_stride, sizeof(*dsp->deviation));
+
+	if (dsp->mean == NULL || dsp->variance == NULL || dsp->energy == NULL || dsp->filtered_energy == NULL ||
+	    dsp->correlation == NULL || dsp->deviation == NULL)
+	{
+		acc_sparse_dsp_destroy(dsp);
+		return false;
+	}
+
+	return true;
+}
+
+
+void acc_sparse_dsp_destroy(acc_sparse_dsp_t *dsp)
+{
+	acc_integration_mem_free(dsp->mean);
+	acc_integration_mem_free(dsp->variance);
+	acc_integration_mem_free(dsp->energy);
+	acc_integration_mem_free(dsp->filtered_energy);
+	acc_integration_mem_free(dsp->correlation);
+	acc_integration_mem_free(dsp->deviation);
+
+	memset(dsp, 0, sizeof(*dsp));
+}
+
+
+ACC_INTEGRATION_RAM_FUNC void acc_sparse_dsp_process(acc_sparse_dsp_t *dsp, const uint16_t *frame)
+{
+	uint16_t length = dsp->sweep_length;
+	uint16_t point  = 0;
+
+	for (; point + 1 < length; point += 2)
+	{
+		remove_dc_x2(dsp, frame, point);
+	}
+
+	if (point < length)
+	{
+		remove_dc(dsp, frame, point);
+	}
+
+	float sweeps           = (float)dsp->sweeps_per_frame;
+	float lag_scale        = (dsp->sweeps_per_frame > 1) ? sweeps / (sweeps - 1.0f) : 0.0f;
+	float highest_energy   = -1.0f;
+	float filter_factor    = (dsp->frames > 0) ? dsp->filter_factor : 0.0f;
+	float new_energy_scale = 1.0f - filter_factor;
+
+	for (point = 0; point < length; point++)
+	{
+		int64_t r0;
+		int64_t r1;
+
+		energy_correlation(&dsp->deviation[point * dsp->deviation_stride], dsp->deviation_stride, &r0, &r1);
+
+		float energy = (float)r0;
+
+		dsp->energy[point]          = energy;
+		dsp->variance[point]        = energy / sweeps;
+		dsp->correlation[point]     = (r0 > 0) ? (float)r1 * lag_scale / energy : 0.0f;
+		dsp->filtered_energy[point] = (filter_factor * dsp->filtered_energy[point]) + (new_energy_scale * energy);
+
+		if (energy > highest_energy)
+		{
+			highest_energy       = energy;
+			dsp->strongest_point = point;
+		}
+	}
+
+	dsp->speed = (highest_energy > 0.0f) ? estimate_speed(dsp->correlation[dsp->strongest_point], dsp->sweep_rate_hz) : 0.0f;
+	dsp->frames++;
+}
+
+
+const char *acc_sparse_dsp_kernel_name(void)
+{
+	return ACC_SIMD_DSP ? "DSP extension" : "portable C";
+}
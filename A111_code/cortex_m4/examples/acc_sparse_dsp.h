@@ -0,0 +1,120 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_SPARSE_DSP_H_
+#define ACC_SPARSE_DSP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * Sparse frame processing
+ *
+ * A sparse frame is sweeps_per_frame sweeps of sweep_length points each, in sweep order,
+ * as returned by acc_service_sparse_get_next_by_reference. For each point, a column of
+ * the frame, the processing calculates:
+ *   - The mean over the sweeps
+ *   - The variance over the sweeps
+ *   - The energy of the DC removed column, the sum of the squared deviations from the mean
+ *   - The energy filtered over frames with an exponential filter
+ *   - The normalized correlation between consecutive sweeps, for the speed estimate
+ *
+ * The speed is estimated at the point with the highest energy from the correlation
+ * between consecutive sweeps. A reflector moving with the speed v gives a sinusoid in
+ * the sweeps with the frequency 2 * v / wavelength, and the correlation is the cosine of
+ * the phase step between sweeps. Only the magnitude of the speed can be estimated from
+ * real valued data. Speeds that give more than half a turn of phase per sweep are folded.
+ *
+ * The frame is processed as signed 16 bit values, two points or two sweeps at a time with
+ * the helpers in acc_simd.h:
+ *   - The DC removal subtracts the means of two neighbouring points with one saturating
+ *     __QSUB16 and writes the deviations transposed, so that the sweeps of a point are
+ *     consecutive in memory
+ *   - The energy and correlation sums are made over two sweeps per __SMLALD, with
+ *     64 bit accumulators so that any frame size and signal level is exact
+ */
+
+
+/**
+ * @brief Wavelength of the A111 radar at 60.5 GHz in m
+ */
+#define ACC_SPARSE_DSP_WAVELENGTH_M 0.004955f
+
+
+/**
+ * @brief Sparse frame processing
+ *
+ * The result arrays have sweep_length elements and are valid after the first
+ * acc_sparse_dsp_process.
+ */
+typedef struct
+{
+	uint16_t sweeps_per_frame;
+	uint16_t sweep_length;
+	float    sweep_rate_hz;
+	/** Weight of the previous filtered energy, between 0 and 1 */
+	float    filter_factor;
+
+	/** Mean of each point over the sweeps, in sparse data units */
+	float *mean;
+	/** Variance of each point over the sweeps */
+	float *variance;
+	/** Sum of the squared deviations from the mean of each point */
+	float *energy;
+	/** Energy filtered over frames */
+	float *filtered_energy;
+	/** Correlation between consecutive sweeps of each point, normalized with the energy */
+	float *correlation;
+
+	/** Point with the highest energy in the last frame */
+	uint16_t strongest_point;
+	/** Speed estimated at the strongest point in m/s */
+	float    speed;
+	uint32_t frames;
+
+	int16_t  *deviation;
+	uint16_t deviation_stride;
+} acc_sparse_dsp_t;
+
+
+/**
+ * @brief Create sparse frame processing
+ *
+ * @param[out] dsp The sparse frame processing to create
+ * @param[in] sweeps_per_frame The sweeps per frame of the sparse configuration
+ * @param[in] sweep_length The sweep length from the sparse metadata
+ * @param[in] sweep_rate_hz The sweep rate of the sparse configuration, used for the speed estimate
+ * @param[in] filter_factor Weight of the previous filtered energy, between 0 and 1
+ * @return True if successful, false if memory could not be allocated
+ */
+bool acc_sparse_dsp_create(acc_sparse_dsp_t *dsp, uint16_t sweeps_per_frame, uint16_t sweep_length, float sweep_rate_hz,
+                           float filter_factor);
+
+
+/**
+ * @brief Destroy sparse frame processing
+ *
+ * @param[in] dsp The sparse frame processing to destroy
+ */
+void acc_sparse_dsp_destroy(acc_sparse_dsp_t *dsp);
+
+
+/**
+ * @brief Process a sparse frame
+ *
+ * @param[in] dsp The sparse frame processing
+ * @param[in] frame The sparse frame, sweeps_per_frame * sweep_length values
+ */
+void acc_sparse_dsp_process(acc_sparse_dsp_t *dsp, const uint16_t *frame);
+
+
+/**
+ * @brief Get the name of the kernel implementation in use
+ *
+ * @return "DSP extension" or "portable C"
+ */
+const char *acc_sparse_dsp_kernel_name(void);
+
+
+#endif
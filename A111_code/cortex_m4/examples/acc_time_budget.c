@@ -0,0 +1,436 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_integration.h"
+#include "acc_service_envelope.h"
+#include "acc_service_iq.h"
+#include "acc_service_power_bins.h"
+#include "acc_service_sparse.h"
+#include "acc_time_budget.h"
+
+
+// Distance between measured points at downsampling factor 1
+#define POINT_STEP_M        0.000484f
+#define SPARSE_POINT_STEP_M 0.06f
+
+// Raw data read from the sensor per measured point, I and Q for all services but sparse
+#define POINT_BYTES        4U
+#define SPARSE_POINT_BYTES 2U
+
+// Pulse repetition frequencies of the maximum unambiguous ranges
+#define MUR_6_PRF_MHZ 13.0f
+#define MUR_9_PRF_MHZ 8.7f
+
+
+/**
+ * @brief The profiler state
+ *
+ * The sensor device functions of the HAL have no client reference, so the profiler is a
+ * single static instance.
+ */
+typedef struct
+{
+	acc_hal_t                                    hal;
+	acc_hal_sensor_wait_for_interrupt_function_t wait_for_interrupt;
+	acc_hal_sensor_transfer_function_t           transfer;
+	acc_sensor_transfer16_function_t             transfer16;
+	uint32_t                                     frame_start_us;
+	uint32_t                                     frame_measure_us;
+	uint32_t                                     frame_spi_us;
+	uint32_t                                     frames;
+	uint64_t                                     total_us;
+	uint64_t                                     measure_us;
+	uint64_t                                     spi_us;
+	uint64_t                                     spi_bytes;
+	bool                                         in_frame;
+} profiler_t;
+
+
+static profiler_t profiler;
+
+
+static const char *service_names[ACC_TIME_BUDGET_SERVICE_COUNT] = { "envelope", "iq", "power_bins", "sparse" };
+
+
+static uint16_t points_get(const acc_time_budget_input_t *input)
+{
+	float    step_m       = (input->service == ACC_TIME_BUDGET_SERVICE_SPARSE) ? SPARSE_POINT_STEP_M : POINT_STEP_M;
+	uint16_t downsampling = (input->downsampling_factor > 0) ? input->downsampling_factor : 1;
+	float    points       = input->length_m / (step_m * (float)downsampling);
+
+	if (points < 0.0f)
+	{
+		return 1;
+	}
+
+	return (points > (float)(UINT16_MAX - 1)) ? UINT16_MAX : (uint16_t)points + 1;
+}
+
+
+static uint32_t point_bytes_get(const acc_time_budget_input_t *input)
+{
+	return (input->service == ACC_TIME_BUDGET_SERVICE_SPARSE) ? SPARSE_POINT_BYTES : POINT_BYTES;
+}
+
+
+static float prf_factor_get(const acc_time_budget_input_t *input)
+{
+	return (input->mur == ACC_SERVICE_MUR_9) ? MUR_6_PRF_MHZ / MUR_9_PRF_MHZ : 1.0f;
+}
+
+
+static uint16_t sweeps_per_frame_get(const acc_time_budget_input_t *input)
+{
+	return (input->sweeps_per_frame > 0) ? input->sweeps_per_frame : 1;
+}
+
+
+static uint32_t profile_index_get(const acc_time_budget_input_t *input)
+{
+	if (input->profile < ACC_SERVICE_PROFILE_1 || input->profile > ACC_SERVICE_PROFILE_5)
+	{
+		return 0;
+	}
+
+	return (uint32_t)input->profile - (uint32_t)ACC_SERVICE_PROFILE_1;
+}
+
+
+/**
+ * @brief SPI time of one sweep at the clock rate, without overhead and calibration
+ */
+static float spi_transfer_us(const acc_time_budget_input_t *input, uint16_t points)
+{
+	if (input->spi_clock_hz == 0)
+	{
+		return 0.0f;
+	}
+
+	return ((float)points * (float)point_bytes_get(input) * 8.0f * 1000000.0f) / (float)input->spi_clock_hz;
+}
+
+
+void acc_time_budget_model_default(acc_time_budget_model_t *model)
+{
+	memset(model, 0, sizeof(*model));
+
+	model->sweep_overhead_us = 250.0f;
+	model->spi_overhead_us   = 60.0f;
+	model->spi_scale         = 1.0f;
+
+	// The pulse repetition frequency does not depend on the profile, calibrate to get the differences
+	for (uint32_t i = 0; i < ACC_SERVICE_PROFILE_5; i++)
+	{
+		model->point_us[i] = 1.0f / MUR_6_PRF_MHZ;
+	}
+
+	model->processing_overhead_us[ACC_TIME_BUDGET_SERVICE_ENVELOPE]   = 400.0f;
+	model->processing_overhead_us[ACC_TIME_BUDGET_SERVICE_IQ]         = 400.0f;
+	model->processing_overhead_us[ACC_TIME_BUDGET_SERVICE_POWER_BINS] = 300.0f;
+	model->processing_overhead_us[ACC_TIME_BUDGET_SERVICE_SPARSE]     = 200.0f;
+
+	model->processing_point_us[ACC_TIME_BUDGET_SERVICE_ENVELOPE]   = 1.2f;
+	model->processing_point_us[ACC_TIME_BUDGET_SERVICE_IQ]         = 0.8f;
+	model->processing_point_us[ACC_TIME_BUDGET_SERVICE_POWER_BINS] = 0.6f;
+	model->processing_point_us[ACC_TIME_BUDGET_SERVICE_SPARSE]     = 0.1f;
+}
+
+
+void acc_time_budget_input_get(acc_service_configuration_t configuration, acc_time_budget_service_t service,
+                               float update_rate_hz, uint32_t spi_clock_hz, acc_time_budget_input_t *input)
+{
+	memset(input, 0, sizeof(*input));
+
+	input->service                  = service;
+	input->profile                  = acc_service_profile_get(configuration);
+	input->mur                      = acc_service_mur_get(configuration);
+	input->hwaas                    = acc_service_hw_accelerated_average_samples_get(configuration);
+	input->start_m                  = acc_service_requested_start_get(configuration);
+	input->length_m                 = acc_service_requested_length_get(configuration);
+	input->sweeps_per_frame         = 1;
+	input->update_rate_hz           = update_rate_hz;
+	input->asynchronous_measurement = acc_service_asynchronous_measurement_get(configuration);
+	input->spi_clock_hz             = spi_clock_hz;
+
+	switch (service)
+	{
+		case ACC_TIME_BUDGET_SERVICE_ENVELOPE:
+			input->downsampling_factor = acc_service_envelope_downsampling_factor_get(configuration);
+			break;
+		case ACC_TIME_BUDGET_SERVICE_IQ:
+			input->downsampling_factor = acc_service_iq_downsampling_factor_get(configuration);
+			break;
+		case ACC_TIME_BUDGET_SERVICE_POWER_BINS:
+			input->downsampling_factor = acc_service_power_bins_downsampling_factor_get(configuration);
+			break;
+		case ACC_TIME_BUDGET_SERVICE_SPARSE:
+			input->downsampling_factor = acc_service_sparse_downsampling_factor_get(configuration);
+			input->sweeps_per_frame    = acc_service_sparse_configuration_sweeps_per_frame_get(configuration);
+			input->sweep_rate_hz       = acc_service_sparse_configuration_sweep_rate_get(configuration);
+			break;
+		default:
+			break;
+	}
+}
+
+
+bool acc_time_budget_estimate(const acc_time_budget_model_t *model, const acc_time_budget_input_t *input,
+                              acc_time_budget_estimate_t *estimate)
+{
+	uint16_t points           = points_get(input);
+	uint16_t sweeps_per_frame = sweeps_per_frame_get(input);
+	float    point_us         = model->point_us[profile_index_get(input)] * prf_factor_get(input);
+
+	memset(estimate, 0, sizeof(*estimate));
+
+	estimate->points   = points;
+	estimate->sweep_us = model->sweep_overhead_us + ((float)points * (float)input->hwaas * point_us);
+
+	float sweep_period_us = estimate->sweep_us;
+
+	if (input->sweep_rate_hz > 0.0f)
+	{
+		float requested_period_us = 1000000.0f / input->sweep_rate_hz;
+
+		if (estimate->sweep_us > requested_period_us)
+		{
+			estimate->violations |= ACC_TIME_BUDGET_SWEEP_RATE_TOO_HIGH;
+		}
+		else
+		{
+			sweep_period_us = requested_period_us;
+		}
+	}
+
+	// The frame ends when the last sweep is measured, there is no wait after it
+	estimate->measure_us    = ((float)(sweeps_per_frame - 1) * sweep_period_us) + estimate->sweep_us;
+	estimate->spi_us        = (float)sweeps_per_frame *
+	                          ((spi_transfer_us(input, points) * model->spi_scale) + model->spi_overhead_us);
+	estimate->processing_us = model->processing_overhead_us[input->service] +
+	                          ((float)points * (float)sweeps_per_frame * model->processing_point_us[input->service]);
+
+	// With asynchronous measurement the sensor measures the next frame while the last is processed
+	if (input->asynchronous_measurement)
+	{
+		float longest_us = (estimate->measure_us > estimate->processing_us) ? estimate->measure_us : estimate->processing_us;
+
+		estimate->frame_us = estimate->spi_us + longest_us;
+	}
+	else
+	{
+		estimate->frame_us = estimate->measure_us + estimate->spi_us + estimate->processing_us;
+	}
+
+	estimate->max_update_rate_hz = 1000000.0f / estimate->frame_us;
+
+	if (input->update_rate_hz > estimate->max_update_rate_hz)
+	{
+		estimate->violations |= ACC_TIME_BUDGET_UPDATE_RATE_TOO_HIGH;
+	}
+
+	return estimate->violations == 0;
+}
+
+
+void acc_time_budget_calibrate(acc_time_budget_model_t *model, const acc_time_budget_input_t *input,
+                               const acc_time_budget_measurement_t *measurement)
+{
+	uint16_t points           = points_get(input);
+	float    sweeps_per_frame = (float)sweeps_per_frame_get(input);
+
+	// The wait for interrupt only covers the sweeps when there is no wait for the sweep rate
+	if (measurement->measure_us > 0.0f && input->hwaas > 0 && input->sweep_rate_hz <= 0.0f)
+	{
+		float sweep_us = (measurement->measure_us / sweeps_per_frame) - model->sweep_overhead_us;
+
+		if (sweep_us > 0.0f)
+		{
+			model->point_us[profile_index_get(input)] = sweep_us /
+			                                            ((float)points * (float)input->hwaas * prf_factor_get(input));
+		}
+	}
+
+	float transfer_us = spi_transfer_us(input, points) * sweeps_per_frame;
+
+	if (measurement->spi_us > 0.0f && transfer_us > 0.0f)
+	{
+		float spi_us = measurement->spi_us - (model->spi_overhead_us * sweeps_per_frame);
+
+		if (spi_us > 0.0f)
+		{
+			model->spi_scale = spi_us / transfer_us;
+		}
+	}
+
+	if (measurement->processing_us > 0.0f)
+	{
+		float processing_us = measurement->processing_us - model->processing_overhead_us[input->service];
+
+		if (processing_us > 0.0f)
+		{
+			model->processing_point_us[input->service] = processing_us / ((float)points * sweeps_per_frame);
+		}
+	}
+}
+
+
+void acc_time_budget_model_print(const acc_time_budget_model_t *model)
+{
+	printf("time_budget sweep_overhead_us %f\n", (double)model->sweep_overhead_us);
+
+	for (uint32_t i = 0; i < ACC_SERVICE_PROFILE_5; i++)
+	{
+		printf("time_budget point_us.%u %f\n", (unsigned int)(i + 1), (double)model->point_us[i]);
+	}
+
+	printf("time_budget spi_overhead_us %f\n", (double)model->spi_overhead_us);
+	printf("time_budget spi_scale %f\n", (double)model->spi_scale);
+
+	for (uint32_t i = 0; i < ACC_TIME_BUDGET_SERVICE_COUNT; i++)
+	{
+		printf("time_budget processing_overhead_us.%s %f\n", service_names[i], (double)model->processing_overhead_us[i]);
+		printf("time_budget processing_point_us.%s %f\n", service_names[i], (double)model->processing_point_us[i]);
+	}
+}
+
+
+void acc_time_budget_estimate_print(const acc_time_budget_estimate_t *estimate)
+{
+	printf("Points: %u, sweep: %u us, measure: %u us, spi: %u us, processing: %u us, frame: %u us, max rate: %u Hz%s%s\n",
+	       (unsigned int)estimate->points,
+	       (unsigned int)estimate->sweep_us,
+	       (unsigned int)estimate->measure_us,
+	       (unsigned int)estimate->spi_us,
+	       (unsigned int)estimate->processing_us,
+	       (unsigned int)estimate->frame_us,
+	       (unsigned int)estimate->max_update_rate_hz,
+	       (estimate->violations & ACC_TIME_BUDGET_SWEEP_RATE_TOO_HIGH) ? ", sweep rate too high" : "",
+	       (estimate->violations & ACC_TIME_BUDGET_UPDATE_RATE_TOO_HIGH) ? ", update rate too high" : "");
+}
+
+
+static bool profiled_wait_for_interrupt(acc_sensor_id_t sensor_id, uint32_t timeout_ms)
+{
+	uint32_t start_us = acc_integration_get_time_us();
+	bool     result   = profiler.wait_for_interrupt(sensor_id, timeout_ms);
+
+	profiler.frame_measure_us += acc_integration_get_time_us() - start_us;
+
+	return result;
+}
+
+
+static void profiled_transfer(acc_sensor_id_t sensor_id, uint8_t *buffer, size_t buffer_size)
+{
+	uint32_t start_us = acc_integration_get_time_us();
+
+	profiler.transfer(sensor_id, buffer, buffer_size);
+
+	profiler.frame_spi_us += acc_integration_get_time_us() - start_us;
+
+	if (profiler.in_frame)
+	{
+		profiler.spi_bytes += buffer_size;
+	}
+}
+
+
+static void profiled_transfer16(acc_sensor_id_t sensor_id, uint16_t *buffer, size_t buffer_length)
+{
+	uint32_t start_us = acc_integration_get_time_us();
+
+	profiler.transfer16(sensor_id, buffer, buffer_length);
+
+	profiler.frame_spi_us += acc_integration_get_time_us() - start_us;
+
+	if (profiler.in_frame)
+	{
+		profiler.spi_bytes += buffer_length * sizeof(*buffer);
+	}
+}
+
+
+const acc_hal_t *acc_time_budget_profiler_hal(const acc_hal_t *hal)
+{
+	profiler.hal                = *hal;
+	profiler.wait_for_interrupt = hal->sensor_device.wait_for_interrupt;
+	profiler.transfer           = hal->sensor_device.transfer;
+	profiler.transfer16         = hal->optimization.transfer16;
+
+	profiler.hal.sensor_device.wait_for_interrupt = profiled_wait_for_interrupt;
+	profiler.hal.sensor_device.transfer           = profiled_transfer;
+
+	if (profiler.transfer16 != NULL)
+	{
+		profiler.hal.optimization.transfer16 = profiled_transfer16;
+	}
+
+	acc_time_budget_profiler_reset();
+
+	return &profiler.hal;
+}
+
+
+void acc_time_budget_profiler_reset(void)
+{
+	profiler.frames     = 0;
+	profiler.total_us   = 0;
+	profiler.measure_us = 0;
+	profiler.spi_us     = 0;
+	profiler.spi_bytes  = 0;
+	profiler.in_frame   = false;
+}
+
+
+void acc_time_budget_profiler_frame_begin(void)
+{
+	profiler.frame_measure_us = 0;
+	profiler.frame_spi_us     = 0;
+	profiler.in_frame         = true;
+	profiler.frame_start_us   = acc_integration_get_time_us();
+}
+
+
+void acc_time_budget_profiler_frame_end(void)
+{
+	uint32_t total_us = acc_integration_get_time_us() - profiler.frame_start_us;
+
+	if (!profiler.in_frame)
+	{
+		return;
+	}
+
+	profiler.frames++;
+	profiler.total_us   += total_us;
+	profiler.measure_us += profiler.frame_measure_us;
+	profiler.spi_us     += profiler.frame_spi_us;
+	profiler.in_frame    = false;
+}
+
+
+void acc_time_budget_profiler_get(acc_time_budget_measurement_t *measurement)
+{
+	memset(measurement, 0, sizeof(*measurement));
+
+	if (profiler.frames == 0)
+	{
+		return;
+	}
+
+	float frames = (float)profiler.frames;
+
+	measurement->frames        = profiler.frames;
+	measurement->measure_us    = (float)profiler.measure_us / frames;
+	measurement->spi_us        = (float)profiler.spi_us / frames;
+	measurement->spi_bytes     = (float)profiler.spi_bytes / frames;
+	measurement->processing_us = (float)(profiler.total_us - profiler.measure_us - profiler.spi_us) / frames;
+}
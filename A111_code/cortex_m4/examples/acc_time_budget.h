@@ -0,0 +1,247 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_TIME_BUDGET_H_
+#define ACC_TIME_BUDGET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "acc_definitions_a111.h"
+#include "acc_definitions_common.h"
+#include "acc_hal_definitions.h"
+#include "acc_service.h"
+
+
+/**
+ * Measurement time budget
+ *
+ * Estimates the time of each stage of a frame from a service configuration, before the
+ * service is created:
+ *   - Sweep time, the sensor measuring every point of a sweep HWAAS times
+ *   - SPI readout time, the raw data of each sweep read over the SPI at the HAL clock
+ *   - RSS processing time, the service processing of the read data on the MCU
+ * and from these the highest update rate the configuration can reach without missed data.
+ *
+ * The model is linear in the number of measured points, with nominal coefficients for
+ * the STM32L476 at 80 MHz. The coefficients are calibrated against a measured frame with
+ * the stage profiler, which wraps the wait for interrupt and transfer functions of the
+ * HAL and times get_next. The same model is implemented by script/time_budget.py, which
+ * reads the coefficients printed by acc_time_budget_model_print to check configurations
+ * on the host.
+ */
+
+
+/**
+ * @brief Service types of the estimator
+ */
+typedef enum
+{
+	ACC_TIME_BUDGET_SERVICE_ENVELOPE,
+	ACC_TIME_BUDGET_SERVICE_IQ,
+	ACC_TIME_BUDGET_SERVICE_POWER_BINS,
+	ACC_TIME_BUDGET_SERVICE_SPARSE,
+	ACC_TIME_BUDGET_SERVICE_COUNT
+} acc_time_budget_service_t;
+
+
+/**
+ * @brief Reasons for a configuration not to fit its time budget
+ */
+typedef enum
+{
+	/** The sweeps of a frame take longer than the sweep rate allows */
+	ACC_TIME_BUDGET_SWEEP_RATE_TOO_HIGH  = 1 << 0,
+	/** The frame takes longer than the update rate allows */
+	ACC_TIME_BUDGET_UPDATE_RATE_TOO_HIGH = 1 << 1
+} acc_time_budget_violation_t;
+
+
+/**
+ * @brief Estimator model coefficients
+ */
+typedef struct
+{
+	/** Fixed time per sweep in us */
+	float sweep_overhead_us;
+	/** Time per measured point and HWAAS in us at MUR 6, by profile */
+	float point_us[ACC_SERVICE_PROFILE_5];
+	/** Fixed SPI time per sweep in us, register accesses and transfer setup */
+	float spi_overhead_us;
+	/** Fixed processing time per frame in us, by service */
+	float processing_overhead_us[ACC_TIME_BUDGET_SERVICE_COUNT];
+	/** Processing time per measured point in us, by service */
+	float processing_point_us[ACC_TIME_BUDGET_SERVICE_COUNT];
+	/** Calibration factor of the SPI time, the achieved rate relative to the SPI clock */
+	float spi_scale;
+} acc_time_budget_model_t;
+
+
+/**
+ * @brief Estimator input, the timing relevant part of a service configuration
+ */
+typedef struct
+{
+	acc_time_budget_service_t service;
+	acc_service_profile_t     profile;
+	acc_service_mur_t         mur;
+	uint8_t                   hwaas;
+	float                     start_m;
+	float                     length_m;
+	uint16_t                  downsampling_factor;
+	/** Sweeps per frame, 1 for all services but sparse */
+	uint16_t                  sweeps_per_frame;
+	/** Sparse sweep rate in Hz, 0 for the highest possible */
+	float                     sweep_rate_hz;
+	/** Requested update rate in Hz, 0 if not checked */
+	float                     update_rate_hz;
+	bool                      asynchronous_measurement;
+	uint32_t                  spi_clock_hz;
+} acc_time_budget_input_t;
+
+
+/**
+ * @brief Estimated time budget of a frame
+ */
+typedef struct
+{
+	/** Number of points measured in each sweep */
+	uint16_t points;
+	/** Time to measure one sweep */
+	float    sweep_us;
+	/** Time to measure all sweeps of a frame, including waiting for the sweep rate */
+	float    measure_us;
+	/** Time to read the frame over the SPI */
+	float    spi_us;
+	/** Time for RSS to process the frame */
+	float    processing_us;
+	/** Time for one frame, with measurement overlapping readout and processing if asynchronous */
+	float    frame_us;
+	/** The highest update rate without missed data */
+	float    max_update_rate_hz;
+	/** Bit mask of acc_time_budget_violation_t, 0 if the configuration fits */
+	uint32_t violations;
+} acc_time_budget_estimate_t;
+
+
+/**
+ * @brief Stage times measured by the profiler, averages per frame
+ */
+typedef struct
+{
+	uint32_t frames;
+	/** Time spent waiting for the sensor interrupt */
+	float    measure_us;
+	/** Time spent in SPI transfers */
+	float    spi_us;
+	/** Bytes transferred over the SPI */
+	float    spi_bytes;
+	/** Time in get_next outside the two stages above */
+	float    processing_us;
+} acc_time_budget_measurement_t;
+
+
+/**
+ * @brief Get the nominal model for the STM32L476 at 80 MHz
+ *
+ * @param[out] model The model
+ */
+void acc_time_budget_model_default(acc_time_budget_model_t *model);
+
+
+/**
+ * @brief Read the estimator input from a service configuration
+ *
+ * @param[in] configuration The service configuration
+ * @param[in] service The service type of the configuration
+ * @param[in] update_rate_hz The update rate to check, 0 if not checked
+ * @param[in] spi_clock_hz The SPI clock of the HAL
+ * @param[out] input The estimator input
+ */
+void acc_time_budget_input_get(acc_service_configuration_t configuration, acc_time_budget_service_t service,
+                               float update_rate_hz, uint32_t spi_clock_hz, acc_time_budget_input_t *input);
+
+
+/**
+ * @brief Estimate the time budget of a configuration
+ *
+ * @param[in] model The model
+ * @param[in] input The estimator input
+ * @param[out] estimate The estimated time budget
+ * @return True if the configuration fits its sweep and update rate
+ */
+bool acc_time_budget_estimate(const acc_time_budget_model_t *model, const acc_time_budget_input_t *input,
+                              acc_time_budget_estimate_t *estimate);
+
+
+/**
+ * @brief Calibrate the model against a measurement
+ *
+ * Sets the point time of the profile, the SPI factor and the processing point time of
+ * the service so that the estimate of the input matches the measured stage times.
+ * Calibrate each profile and service that is used. Stages measured as zero are not
+ * calibrated.
+ *
+ * @param[in, out] model The model
+ * @param[in] input The estimator input of the measured configuration
+ * @param[in] measurement The measured stage times
+ */
+void acc_time_budget_calibrate(acc_time_budget_model_t *model, const acc_time_budget_input_t *input,
+                               const acc_time_budget_measurement_t *measurement);
+
+
+/**
+ * @brief Print the model coefficients in the format read by script/time_budget.py
+ *
+ * @param[in] model The model
+ */
+void acc_time_budget_model_print(const acc_time_budget_model_t *model);
+
+
+/**
+ * @brief Print an estimate
+ *
+ * @param[in] estimate The estimate
+ */
+void acc_time_budget_estimate_print(const acc_time_budget_estimate_t *estimate);
+
+
+/**
+ * @brief Get a HAL with the profiler in the sensor device functions
+ *
+ * The returned HAL calls the functions of the given HAL and is passed to acc_rss_activate.
+ * Only one HAL can be profiled at a time.
+ *
+ * @param[in] hal The HAL to profile
+ * @return The profiling HAL
+ */
+const acc_hal_t *acc_time_budget_profiler_hal(const acc_hal_t *hal);
+
+
+/**
+ * @brief Clear the profiler measurement
+ */
+void acc_time_budget_profiler_reset(void);
+
+
+/**
+ * @brief Mark the start of a get_next call
+ */
+void acc_time_budget_profiler_frame_begin(void);
+
+
+/**
+ * @brief Mark the end of a get_next call
+ */
+void acc_time_budget_profiler_frame_end(void);
+
+
+/**
+ * @brief Get the stage times of the frames since the last reset
+ *
+ * @param[out] measurement The averages per frame
+ */
+void acc_time_budget_profiler_get(acc_time_budget_measurement_t *measurement);
+
+
+#endif
@@ -0,0 +1,225 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_definitions_common.h"
+#include "acc_envelope_peaks.h"
+#include "acc_envelope_preprocess.h"
+#include "acc_integration.h"
+#include "acc_iq_q15.h"
+#include "acc_sparse_dsp.h"
+
+
+/** \example example_benchmark_dsp.c
+ * @brief This is an example on how the processing kernels are benchmarked without a sensor
+ * @n
+ * Each kernel processes synthetic data of a typical size a number of times and the
+ * average cycle count of a call is printed. No sensor and no RSS is used, so the
+ * example runs on the target and as a host binary. On the host the cycle count of
+ * acc_integration_get_cycle_count is the time in ns.
+ * @n
+ * The example executes as follows:
+ *   - Benchmark the envelope preprocessing and the envelope peak finder
+ *   - Benchmark the sparse frame processing
+ *   - Benchmark the IQ polar conversion and the micro-motion tracker
+ */
+
+
+#define ITERATIONS              100
+#define ENVELOPE_LENGTH         1000
+#define SPARSE_SWEEPS_PER_FRAME 32
+#define SPARSE_SWEEP_LENGTH     12
+#define SPARSE_SWEEP_RATE_HZ    3000.0f
+#define IQ_LENGTH               500
+#define MAX_PEAKS               8
+
+
+static uint16_t            envelope[ENVELOPE_LENGTH];
+static uint16_t            sparse_frame[SPARSE_SWEEPS_PER_FRAME * SPARSE_SWEEP_LENGTH];
+static acc_int16_complex_t iq[IQ_LENGTH];
+static uint16_t            iq_magnitude[IQ_LENGTH];
+static int16_t             iq_phase[IQ_LENGTH];
+
+
+static void fill_envelope(uint32_t iteration);
+
+
+static void print_result(const char *name, uint32_t cycles);
+
+
+static bool benchmark_envelope(void);
+
+
+static bool benchmark_sparse(void);
+
+
+static bool benchmark_iq(void);
+
+
+int acc_example_benchmark_dsp(int argc, char *argv[]);
+
+
+int acc_example_benchmark_dsp(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	if (!benchmark_envelope() || !benchmark_sparse() || !benchmark_iq())
+	{
+		printf("Benchmark failed\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Application finished OK\n");
+
+	return EXIT_SUCCESS;
+}
+
+
+void fill_envelope(uint32_t iteration)
+{
+	for (uint16_t i = 0; i < ENVELOPE_LENGTH; i++)
+	{
+		envelope[i] = (uint16_t)(100 + ((i * 7 + iteration * 13) % 64));
+	}
+
+	// Two reflectors above the noise
+	envelope[200] = 2000;
+	envelope[201] = 1600;
+	envelope[600] = 900;
+}
+
+
+void print_result(const char *name, uint32_t cycles)
+{
+	printf("%-28s %8u cycles per call\n", name, (unsigned int)(cycles / ITERATIONS));
+}
+
+
+bool benchmark_envelope(void)
+{
+	acc_envelope_preprocess_t   preprocess;
+	acc_envelope_peaks_config_t peaks_config;
+	acc_envelope_peak_t         peaks[MAX_PEAKS];
+
+	if (!acc_envelope_preprocess_create(&preprocess, ENVELOPE_LENGTH, 0.7f))
+	{
+		return false;
+	}
+
+	acc_envelope_peaks_config_default(&peaks_config);
+
+	uint32_t preprocess_cycles = 0;
+	uint32_t peaks_cycles      = 0;
+	uint32_t peak_count        = 0;
+
+	for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++)
+	{
+		fill_envelope(iteration);
+
+		uint32_t start = acc_integration_get_cycle_count();
+
+		acc_envelope_preprocess_process(&preprocess, envelope);
+
+		uint32_t middle = acc_integration_get_cycle_count();
+
+		peak_count += acc_envelope_peaks_find(&peaks_config, envelope, ENVELOPE_LENGTH, peaks, MAX_PEAKS);
+
+		uint32_t end = acc_integration_get_cycle_count();
+
+		preprocess_cycles += middle - start;
+		peaks_cycles      += end - middle;
+	}
+
+	acc_envelope_preprocess_destroy(&preprocess);
+
+	print_result("envelope preprocess", preprocess_cycles);
+	print_result("envelope peaks", peaks_cycles);
+	printf("%u peaks per sweep\n", (unsigned int)(peak_count / ITERATIONS));
+
+	return true;
+}
+
+
+bool benchmark_sparse(void)
+{
+	acc_sparse_dsp_t dsp;
+
+	if (!acc_sparse_dsp_create(&dsp, SPARSE_SWEEPS_PER_FRAME, SPARSE_SWEEP_LENGTH, SPARSE_SWEEP_RATE_HZ, 0.8f))
+	{
+		return false;
+	}
+
+	uint32_t cycles = 0;
+
+	for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++)
+	{
+		for (uint16_t i = 0; i < SPARSE_SWEEPS_PER_FRAME * SPARSE_SWEEP_LENGTH; i++)
+		{
+			sparse_frame[i] = (uint16_t)(32768 + ((i * 31 + iteration * 17) % 512));
+		}
+
+		uint32_t start = acc_integration_get_cycle_count();
+
+		acc_sparse_dsp_process(&dsp, sparse_frame);
+
+		cycles += acc_integration_get_cycle_count() - start;
+	}
+
+	print_result("sparse dsp", cycles);
+	printf("sparse dsp kernel: %s\n", acc_sparse_dsp_kernel_name());
+
+	acc_sparse_dsp_destroy(&dsp);
+
+	return true;
+}
+
+
+bool benchmark_iq(void)
+{
+	acc_iq_q15_tracker_t tracker;
+
+	if (!acc_iq_q15_tracker_create(&tracker, IQ_LENGTH, 8192))
+	{
+		return false;
+	}
+
+	uint32_t polar_cycles   = 0;
+	uint32_t tracker_cycles = 0;
+
+	for (uint32_t iteration = 0; iteration < ITERATIONS; iteration++)
+	{
+		for (uint16_t i = 0; i < IQ_LENGTH; i++)
+		{
+			iq[i].real = (int16_t)(((i * 37 + iteration * 11) % 2048) - 1024);
+			iq[i].imag = (int16_t)(((i * 53 + iteration * 7) % 2048) - 1024);
+		}
+
+		uint32_t start = acc_integration_get_cycle_count();
+
+		acc_iq_q15_polar(iq, IQ_LENGTH, iq_magnitude, iq_phase);
+
+		uint32_t middle = acc_integration_get_cycle_count();
+
+		acc_iq_q15_tracker_update(&tracker, iq);
+
+		uint32_t end = acc_integration_get_cycle_count();
+
+		polar_cycles   += middle - start;
+		tracker_cycles += end - middle;
+	}
+
+	acc_iq_q15_tracker_destroy(&tracker);
+
+	print_result("iq q15 polar", polar_cycles);
+	print_result("iq q15 tracker", tracker_cycles);
+
+	return true;
+}
@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_BENCHMARK_DSP_H_
+#define EXAMPLE_BENCHMARK_DSP_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Processing kernel benchmark example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_benchmark_dsp(int argc, char *argv[]);
+
+
+#endif
@@ -0,0 +1,321 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_cascade.h"
+#include "acc_detector_distance.h"
+#include "acc_detector_presence.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_power_bins.h"
+#include "acc_version.h"
+
+
+/** \example example_cascade.c
+ * @brief This is an example on how the power bins service can gate an expensive pipeline
+ * @n
+ * The power bins service runs at a low rate with a few bins until a bin deviates from its
+ * learned baseline. Then the distance detector, on envelope data, or the presence
+ * detector, on sparse data, runs until it has reported nothing for the quiet timeout,
+ * and the power bins service takes over again. The pipeline is selected with
+ * EXAMPLE_PIPELINE.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Create the pipeline detector
+ *   - Create a power bins service configuration
+ *   - Create the cascade using the power bins configuration and the pipeline
+ *   - Destroy the power bins service configuration
+ *   - Run the cascade for a number of frames and print the stage transitions
+ *   - Print the time, charge and latency of each stage
+ *   - Destroy the cascade and the pipeline detector
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID   1
+#define START_M     0.3f
+#define LENGTH_M    1.5f
+#define FRAME_COUNT 1000
+
+#define PIPELINE_DISTANCE 0
+#define PIPELINE_PRESENCE 1
+#define EXAMPLE_PIPELINE  PIPELINE_DISTANCE
+
+#define TRIGGER_BIN_COUNT   4
+#define TRIGGER_RATE_HZ     2.0f
+#define PIPELINE_RATE_HZ    10.0f
+#define DISTANCE_MAX_PEAKS  5
+#define QUIET_TIMEOUT_MS    5000
+
+// Estimated average currents of the stages at their rates, measure these for a real estimate
+#define TRIGGER_CURRENT_UA  100.0f
+#define PIPELINE_CURRENT_UA 4000.0f
+
+
+static bool distance_activate(void *client_reference);
+
+
+static bool distance_deactivate(void *client_reference);
+
+
+static bool distance_get_next(void *client_reference, bool *activity);
+
+
+static bool presence_activate(void *client_reference);
+
+
+static bool presence_deactivate(void *client_reference);
+
+
+static bool presence_get_next(void *client_reference, bool *activity);
+
+
+static bool create_pipeline(acc_cascade_pipeline_t *pipeline);
+
+
+static void destroy_pipeline(acc_cascade_pipeline_t *pipeline);
+
+
+int acc_example_cascade(int argc, char *argv[]);
+
+
+int acc_example_cascade(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_cascade_pipeline_t pipeline;
+
+	if (!create_pipeline(&pipeline))
+	{
+		printf("Pipeline creation failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_configuration_t power_bins_configuration = acc_service_power_bins_configuration_create();
+
+	if (power_bins_configuration == NULL)
+	{
+		printf("acc_service_power_bins_configuration_create() failed\n");
+		destroy_pipeline(&pipeline);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_sensor_set(power_bins_configuration, SENSOR_ID);
+	acc_service_requested_start_set(power_bins_configuration, START_M);
+	acc_service_requested_length_set(power_bins_configuration, LENGTH_M);
+	acc_service_power_bins_requested_bin_count_set(power_bins_configuration, TRIGGER_BIN_COUNT);
+
+	acc_cascade_config_t config;
+
+	acc_cascade_config_default(&config);
+	config.trigger_rate_hz                        = TRIGGER_RATE_HZ;
+	config.quiet_timeout_ms                       = QUIET_TIMEOUT_MS;
+	config.current_ua[ACC_CASCADE_STAGE_TRIGGER]  = TRIGGER_CURRENT_UA;
+	config.current_ua[ACC_CASCADE_STAGE_PIPELINE] = PIPELINE_CURRENT_UA;
+
+	acc_cascade_t cascade;
+	bool          created = acc_cascade_create(&cascade, power_bins_configuration, &pipeline, &config);
+
+	acc_service_power_bins_configuration_destroy(&power_bins_configuration);
+
+	if (!created)
+	{
+		printf("acc_cascade_create() failed\n");
+		destroy_pipeline(&pipeline);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	bool                success    = true;
+	acc_cascade_stage_t last_stage = ACC_CASCADE_STAGE_TRIGGER;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		acc_cascade_stage_t stage;
+		bool                activity;
+
+		if (!acc_cascade_update(&cascade, &stage, &activity))
+		{
+			printf("acc_cascade_update() failed\n");
+			success = false;
+			break;
+		}
+
+		if (stage != last_stage)
+		{
+			printf("%s\n", (stage == ACC_CASCADE_STAGE_PIPELINE) ? "Pipeline started" : "Back to power bins");
+			last_stage = stage;
+		}
+		else if (stage == ACC_CASCADE_STAGE_TRIGGER && activity)
+		{
+			printf("Triggered, deviation %u%%\n", (unsigned int)(cascade.deviation * 100.0f));
+		}
+	}
+
+	acc_cascade_stats_print(&cascade);
+
+	acc_cascade_destroy(&cascade);
+	destroy_pipeline(&pipeline);
+
+	acc_rss_deactivate();
+
+	if (success)
+	{
+		printf("Application finished OK\n");
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
+
+
+bool distance_activate(void *client_reference)
+{
+	return acc_detector_distance_activate((acc_detector_distance_handle_t)client_reference);
+}
+
+
+bool distance_deactivate(void *client_reference)
+{
+	return acc_detector_distance_deactivate((acc_detector_distance_handle_t)client_reference);
+}
+
+
+bool distance_get_next(void *client_reference, bool *activity)
+{
+	acc_detector_distance_result_t      result[DISTANCE_MAX_PEAKS];
+	acc_detector_distance_result_info_t result_info;
+
+	if (!acc_detector_distance_get_next((acc_detector_distance_handle_t)client_reference, result, DISTANCE_MAX_PEAKS,
+	                                    &result_info))
+	{
+		return false;
+	}
+
+	*activity = result_info.number_of_peaks > 0;
+
+	return true;
+}
+
+
+bool presence_activate(void *client_reference)
+{
+	return acc_detector_presence_activate((acc_detector_presence_handle_t)client_reference);
+}
+
+
+bool presence_deactivate(void *client_reference)
+{
+	return acc_detector_presence_deactivate((acc_detector_presence_handle_t)client_reference);
+}
+
+
+bool presence_get_next(void *client_reference, bool *activity)
+{
+	acc_detector_presence_result_t result;
+
+	if (!acc_detector_presence_get_next((acc_detector_presence_handle_t)client_reference, &result))
+	{
+		return false;
+	}
+
+	*activity = result.presence_detected;
+
+	return true;
+}
+
+
+bool create_pipeline(acc_cascade_pipeline_t *pipeline)
+{
+	pipeline->rate_hz = PIPELINE_RATE_HZ;
+
+	if (EXAMPLE_PIPELINE == PIPELINE_DISTANCE)
+	{
+		acc_detector_distance_configuration_t configuration = acc_detector_distance_configuration_create();
+
+		if (configuration == NULL)
+		{
+			return false;
+		}
+
+		acc_detector_distance_configuration_sensor_set(configuration, SENSOR_ID);
+		acc_detector_distance_configuration_requested_start_set(configuration, START_M);
+		acc_detector_distance_configuration_requested_length_set(configuration, LENGTH_M);
+
+		pipeline->activate         = distance_activate;
+		pipeline->deactivate       = distance_deactivate;
+		pipeline->get_next         = distance_get_next;
+		pipeline->client_reference = acc_detector_distance_create(configuration);
+
+		acc_detector_distance_configuration_destroy(&configuration);
+	}
+	else
+	{
+		acc_detector_presence_configuration_t configuration = acc_detector_presence_configuration_create();
+
+		if (configuration == NULL)
+		{
+			return false;
+		}
+
+		acc_detector_presence_configuration_sensor_set(configuration, SENSOR_ID);
+		acc_detector_presence_configuration_start_set(configuration, START_M);
+		acc_detector_presence_configuration_length_set(configuration, LENGTH_M);
+		acc_detector_presence_configuration_update_rate_set(configuration, PIPELINE_RATE_HZ);
+
+		pipeline->activate         = presence_activate;
+		pipeline->deactivate       = presence_deactivate;
+		pipeline->get_next         = presence_get_next;
+		pipeline->client_reference = acc_detector_presence_create(configuration);
+
+		acc_detector_presence_configuration_destroy(&configuration);
+	}
+
+	return pipeline->client_reference != NULL;
+}
+
+
+void destroy_pipeline(acc_cascade_pipeline_t *pipeline)
+{
+	if (pipeline->client_reference == NULL)
+	{
+		return;
+	}
+
+	if (EXAMPLE_PIPELINE == PIPELINE_DISTANCE)
+	{
+		acc_detector_distance_handle_t handle = pipeline->client_reference;
+
+		acc_detector_distance_destroy(&handle);
+	}
+	else
+	{
+		acc_detector_presence_handle_t handle = pipeline->client_reference;
+
+		acc_detector_presence_destroy(&handle);
+	}
+
+	pipeline->client_reference = NULL;
+}
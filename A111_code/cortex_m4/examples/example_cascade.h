@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_CASCADE_H_
+#define EXAMPLE_CASCADE_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Power bins cascade example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_cascade(int argc, char *argv[]);
+
+
+#endif
@@ -0,0 +1,217 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_integration_clock.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_envelope.h"
+#include "acc_version.h"
+
+
+/** \example example_clock_profile.c
+ * @brief This is an example on how the MCU clock profile is switched between measurement bursts
+ * @n
+ * The same envelope service is measured in a burst of frames in each clock profile. The
+ * frame rate and the MCU cycles are measured, the energy per frame is estimated from the
+ * typical run current of the profile and the supply voltage. The estimate covers the MCU
+ * only, measure the supply current of the board for the sensor and for sleep between
+ * frames. The results are printed after the last burst, in the max throughput profile,
+ * as the debug output clock depends on the system clock.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Create and activate an envelope service
+ *   - For each clock profile
+ *     - Set the clock profile
+ *     - Get a number of frames, measuring the time and the cycles
+ *   - Set the max throughput profile and print the results
+ *   - Deactivate and destroy the envelope service
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID        1
+#define START_M          0.2f
+#define LENGTH_M         1.0f
+#define FRAME_COUNT      100
+#define SUPPLY_VOLTAGE_V 3.3f
+
+
+/**
+ * @brief Result of the burst in one clock profile
+ */
+typedef struct
+{
+	bool     success;
+	uint32_t spi_clock_hz;
+	uint32_t time_us;
+	uint32_t cycles;
+} burst_result_t;
+
+
+static bool measure_burst(acc_service_handle_t handle, acc_integration_clock_profile_t profile, burst_result_t *result);
+
+
+static void print_result(acc_integration_clock_profile_t profile, const burst_result_t *result);
+
+
+int acc_example_clock_profile(int argc, char *argv[]);
+
+
+int acc_example_clock_profile(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_service_configuration_t envelope_configuration = acc_service_envelope_configuration_create();
+
+	if (envelope_configuration == NULL)
+	{
+		printf("acc_service_envelope_configuration_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_sensor_set(envelope_configuration, SENSOR_ID);
+	acc_service_requested_start_set(envelope_configuration, START_M);
+	acc_service_requested_length_set(envelope_configuration, LENGTH_M);
+
+	acc_service_handle_t handle = acc_service_create(envelope_configuration);
+
+	acc_service_envelope_configuration_destroy(&envelope_configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_service_destroy(&handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	burst_result_t results[ACC_INTEGRATION_CLOCK_PROFILE_COUNT];
+	bool           success = true;
+
+	for (acc_integration_clock_profile_t profile = 0; profile < ACC_INTEGRATION_CLOCK_PROFILE_COUNT; profile++)
+	{
+		success = measure_burst(handle, profile, &results[profile]) && success;
+	}
+
+	if (!acc_integration_clock_profile_set(ACC_INTEGRATION_CLOCK_PROFILE_MAX_THROUGHPUT))
+	{
+		success = false;
+	}
+
+	for (acc_integration_clock_profile_t profile = 0; profile < ACC_INTEGRATION_CLOCK_PROFILE_COUNT; profile++)
+	{
+		print_result(profile, &results[profile]);
+	}
+
+	bool deactivated = acc_service_deactivate(handle);
+
+	acc_service_destroy(&handle);
+
+	acc_rss_deactivate();
+
+	if (!success || !deactivated)
+	{
+		return EXIT_FAILURE;
+	}
+
+	printf("Application finished OK\n");
+
+	return EXIT_SUCCESS;
+}
+
+
+bool measure_burst(acc_service_handle_t handle, acc_integration_clock_profile_t profile, burst_result_t *result)
+{
+	acc_service_envelope_result_info_t result_info;
+	uint16_t                           *data;
+
+	result->success      = false;
+	result->spi_clock_hz = 0;
+	result->time_us      = 0;
+	result->cycles       = 0;
+
+	if (!acc_integration_clock_profile_set(profile))
+	{
+		return false;
+	}
+
+	result->spi_clock_hz = acc_hal_integration_get_spi_clock_hz();
+
+	// The first frame was measured in the previous profile with asynchronous measurement
+	if (!acc_service_envelope_get_next_by_reference(handle, &data, &result_info))
+	{
+		return false;
+	}
+
+	uint32_t start_us     = acc_integration_get_time_us();
+	uint32_t start_cycles = acc_integration_get_cycle_count();
+
+	for (uint32_t i = 0; i < FRAME_COUNT; i++)
+	{
+		if (!acc_service_envelope_get_next_by_reference(handle, &data, &result_info))
+		{
+			return false;
+		}
+	}
+
+	result->cycles  = acc_integration_get_cycle_count() - start_cycles;
+	result->time_us = acc_integration_get_time_us() - start_us;
+	result->success = true;
+
+	return true;
+}
+
+
+void print_result(acc_integration_clock_profile_t profile, const burst_result_t *result)
+{
+	const acc_integration_clock_profile_info_t *info = acc_integration_clock_profile_info_get(profile);
+
+	if (!result->success || result->time_us == 0)
+	{
+		printf("%s: failed\n", info->name);
+		return;
+	}
+
+	float frame_us        = (float)result->time_us / FRAME_COUNT;
+	float frame_rate_hz   = 1000000.0f / frame_us;
+	float frame_energy_uj = (float)info->run_current_ua * SUPPLY_VOLTAGE_V * frame_us / 1000000.0f;
+
+	printf("%s: %u MHz, SPI %u kHz, %u frames/s, %u us/frame, %u cycles/frame, %u uJ/frame\n",
+	       info->name,
+	       (unsigned int)(info->system_clock_hz / 1000000U),
+	       (unsigned int)(result->spi_clock_hz / 1000U),
+	       (unsigned int)(frame_rate_hz + 0.5f),
+	       (unsigned int)(frame_us + 0.5f),
+	       (unsigned int)(result->cycles / FRAME_COUNT),
+	       (unsigned int)(frame_energy_uj + 0.5f));
+}
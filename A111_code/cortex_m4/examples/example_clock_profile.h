@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_CLOCK_PROFILE_H_
+#define EXAMPLE_CLOCK_PROFILE_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Clock profile benchmark example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_clock_profile(int argc, char *argv[]);
+
+
+#endif
@@ -0,0 +1,224 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_detector_distance.h"
+#include "acc_envelope_peaks.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_version.h"
+
+
+/** \example example_envelope_peaks.c
+ * @brief This is an example on how acc_envelope_peaks can be used on envelope data
+ * @n
+ * The distance detector is run with a CFAR threshold and the envelope it processes is
+ * received with the service data callback. The same envelope is processed with
+ * acc_envelope_peaks in the callback, so both peak finders see identical data. The peaks
+ * from both are printed, followed by the average time of acc_envelope_peaks and of the
+ * distance detector processing after the callback.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Create a distance detector configuration with a service data callback
+ *   - Create a distance detector using the previously created configuration
+ *   - Destroy the distance detector configuration
+ *   - Activate the distance detector
+ *   - Get a number of results, find the peaks of each envelope in the callback, and print
+ *     the peaks from both
+ *   - Print the processing times
+ *   - Deactivate and destroy the distance detector
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID      1
+#define START_M        0.2f
+#define LENGTH_M       1.0f
+#define FRAME_COUNT    100
+#define PRINT_INTERVAL 10
+#define MAX_PEAKS      5
+
+
+/**
+ * @brief State shared with the service data callback
+ */
+typedef struct
+{
+	acc_envelope_peaks_config_t config;
+	acc_envelope_peak_t         peaks[MAX_PEAKS];
+	uint16_t                    peak_count;
+	uint16_t                    data_length;
+	uint32_t                    callback_end_us;
+	uint32_t                    total_us;
+} envelope_peaks_state_t;
+
+
+static envelope_peaks_state_t envelope_peaks_state;
+
+
+static void service_data_callback(const uint16_t *data, uint16_t data_length);
+
+
+static void print_peaks(const acc_detector_distance_result_t *result, const acc_detector_distance_result_info_t *result_info,
+                        const acc_detector_distance_metadata_t *metadata);
+
+
+int acc_example_envelope_peaks(int argc, char *argv[]);
+
+
+int acc_example_envelope_peaks(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_envelope_peaks_config_default(&envelope_peaks_state.config);
+
+	acc_detector_distance_configuration_t distance_configuration = acc_detector_distance_configuration_create();
+
+	if (distance_configuration == NULL)
+	{
+		printf("acc_detector_distance_configuration_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_detector_distance_configuration_sensor_set(distance_configuration, SENSOR_ID);
+	acc_detector_distance_configuration_requested_start_set(distance_configuration, START_M);
+	acc_detector_distance_configuration_requested_length_set(distance_configuration, LENGTH_M);
+	acc_detector_distance_configuration_threshold_type_set(distance_configuration, ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_CFAR);
+	acc_detector_distance_configuration_service_data_callback_set(distance_configuration, service_data_callback);
+
+	acc_detector_distance_handle_t distance_handle = acc_detector_distance_create(distance_configuration);
+
+	acc_detector_distance_configuration_destroy(&distance_configuration);
+
+	if (distance_handle == NULL)
+	{
+		printf("acc_detector_distance_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_detector_distance_metadata_t metadata;
+
+	if (!acc_detector_distance_metadata_get(distance_handle, &metadata))
+	{
+		printf("acc_detector_distance_metadata_get() failed\n");
+		acc_detector_distance_destroy(&distance_handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	if (!acc_detector_distance_activate(distance_handle))
+	{
+		printf("acc_detector_distance_activate() failed\n");
+		acc_detector_distance_destroy(&distance_handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	bool                                success     = true;
+	uint32_t                            detector_us = 0;
+	acc_detector_distance_result_t      result[MAX_PEAKS];
+	acc_detector_distance_result_info_t result_info;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		if (!acc_detector_distance_get_next(distance_handle, result, MAX_PEAKS, &result_info))
+		{
+			printf("acc_detector_distance_get_next() failed\n");
+			success = false;
+			break;
+		}
+
+		detector_us += acc_integration_get_time_us() - envelope_peaks_state.callback_end_us;
+
+		if ((frame % PRINT_INTERVAL) == 0)
+		{
+			print_peaks(result, &result_info, &metadata);
+		}
+	}
+
+	if (success)
+	{
+		printf("acc_envelope_peaks: %u us per frame\n", (unsigned int)(envelope_peaks_state.total_us / FRAME_COUNT));
+		printf("Distance detector: %u us per frame\n", (unsigned int)(detector_us / FRAME_COUNT));
+	}
+
+	bool deactivated = acc_detector_distance_deactivate(distance_handle);
+
+	acc_detector_distance_destroy(&distance_handle);
+
+	acc_rss_deactivate();
+
+	if (deactivated && success)
+	{
+		printf("Application finished OK\n");
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
+
+
+void service_data_callback(const uint16_t *data, uint16_t data_length)
+{
+	uint32_t start_us = acc_integration_get_time_us();
+
+	envelope_peaks_state.peak_count = acc_envelope_peaks_find(&envelope_peaks_state.config, data, data_length,
+	                                                          envelope_peaks_state.peaks, MAX_PEAKS);
+	envelope_peaks_state.data_length = data_length;
+
+	envelope_peaks_state.callback_end_us = acc_integration_get_time_us();
+	envelope_peaks_state.total_us       += envelope_peaks_state.callback_end_us - start_us;
+}
+
+
+void print_peaks(const acc_detector_distance_result_t *result, const acc_detector_distance_result_info_t *result_info,
+                 const acc_detector_distance_metadata_t *metadata)
+{
+	float step_m = 0.0f;
+
+	if (envelope_peaks_state.data_length > 1)
+	{
+		step_m = metadata->length_m / (float)(envelope_peaks_state.data_length - 1);
+	}
+
+	printf("Distance detector:");
+
+	for (uint16_t i = 0; i < result_info->number_of_peaks; i++)
+	{
+		printf(" %u mm (%u)", (unsigned int)(result[i].distance_m * 1000.0f), (unsigned int)result[i].amplitude);
+	}
+
+	printf("\nacc_envelope_peaks:");
+
+	for (uint16_t i = 0; i < envelope_peaks_state.peak_count; i++)
+	{
+		const acc_envelope_peak_t *peak      = &envelope_peaks_state.peaks[i];
+		float                     distance_m = metadata->start_m + (peak->position * step_m);
+
+		printf(" %u mm (%u)", (unsigned int)(distance_m * 1000.0f), (unsigned int)peak->amplitude);
+	}
+
+	printf("\n");
+}
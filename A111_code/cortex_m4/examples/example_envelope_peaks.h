@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_ENVELOPE_PEAKS_H_
+#define EXAMPLE_ENVELOPE_PEAKS_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Envelope peak finder example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_envelope_peaks(int argc, char *argv[]);
+
+
+#endif
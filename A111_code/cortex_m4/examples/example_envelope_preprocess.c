@@ -0,0 +1,278 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_envelope_preprocess.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_envelope.h"
+#include "acc_version.h"
+
+
+/** \example example_envelope_preprocess.c
+ * @brief This is an example on how envelope sweeps can be preprocessed in place
+ * @n
+ * First the cycles per sweep of acc_envelope_preprocess are measured on synthetic sweeps
+ * of 500, 1000 and 2000 samples, next to a floating point running average and background
+ * subtraction. Build with ACC_SIMD_DISABLE defined to compare with the portable C kernels.
+ * @n
+ * Then the envelope service is run without its running average. The background is recorded
+ * over the first sweeps and the following sweeps are averaged and background subtracted
+ * in the buffer returned by acc_service_envelope_get_next_by_reference.
+ * @n
+ * The example executes as follows:
+ *   - Measure and print the preprocessing cycles for each sweep length
+ *   - Activate Radar System Software (RSS)
+ *   - Create an envelope service configuration
+ *   - Create an envelope service using the previously created configuration
+ *   - Destroy the envelope service configuration
+ *   - Activate the envelope service
+ *   - Record the background, then preprocess a number of sweeps and print the strongest sample
+ *   - Deactivate and destroy the envelope service
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID              1
+#define START_M                0.2f
+#define LENGTH_M               0.5f
+#define RUNNING_AVERAGE_FACTOR 0.7f
+#define BACKGROUND_SWEEPS      20
+#define SWEEP_COUNT            50
+
+#define BENCHMARK_MAX_LENGTH 2000
+#define BENCHMARK_SWEEPS     20
+
+
+static const uint16_t benchmark_lengths[] = { 500, 1000, 2000 };
+
+static ACC_INTEGRATION_RAM2_DATA uint16_t benchmark_sweep[BENCHMARK_MAX_LENGTH];
+static ACC_INTEGRATION_RAM2_DATA uint16_t benchmark_background[BENCHMARK_MAX_LENGTH];
+static float                              benchmark_average[BENCHMARK_MAX_LENGTH];
+
+
+static bool benchmark(uint16_t length);
+
+
+static void float_reference(uint16_t *data, uint16_t length);
+
+
+static void fill_sweep(uint16_t length, uint32_t sweep);
+
+
+static bool run_service(void);
+
+
+int acc_example_envelope_preprocess(int argc, char *argv[]);
+
+
+int acc_example_envelope_preprocess(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	for (uint16_t i = 0; i < sizeof(benchmark_lengths) / sizeof(benchmark_lengths[0]); i++)
+	{
+		if (!benchmark(benchmark_lengths[i]))
+		{
+			printf("Benchmark of %u samples failed\n", (unsigned int)benchmark_lengths[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	bool success = run_service();
+
+	acc_rss_deactivate();
+
+	if (success)
+	{
+		printf("Application finished OK\n");
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
+
+
+bool benchmark(uint16_t length)
+{
+	acc_envelope_preprocess_t preprocess;
+
+	if (!acc_envelope_preprocess_create(&preprocess, length, RUNNING_AVERAGE_FACTOR))
+	{
+		return false;
+	}
+
+	for (uint16_t i = 0; i < length; i++)
+	{
+		benchmark_background[i] = 100;
+	}
+
+	acc_envelope_preprocess_background_set(&preprocess, benchmark_background);
+
+	uint32_t fixed_cycles = 0;
+	uint32_t float_cycles = 0;
+
+	// The first sweep only initializes the averages and is not counted
+	for (uint32_t sweep = 0; sweep <= BENCHMARK_SWEEPS; sweep++)
+	{
+		fill_sweep(length, sweep);
+
+		uint32_t start = acc_integration_get_cycle_count();
+
+		acc_envelope_preprocess_process(&preprocess, benchmark_sweep);
+
+		uint32_t end = acc_integration_get_cycle_count();
+
+		fill_sweep(length, sweep);
+
+		uint32_t float_start = acc_integration_get_cycle_count();
+
+		float_reference(benchmark_sweep, length);
+
+		uint32_t float_end = acc_integration_get_cycle_count();
+
+		if (sweep > 0)
+		{
+			fixed_cycles += end - start;
+			float_cycles += float_end - float_start;
+		}
+	}
+
+	printf("%u samples: %u cycles per sweep, float %u cycles per sweep, %u bytes state\n",
+	       (unsigned int)length,
+	       (unsigned int)(fixed_cycles / BENCHMARK_SWEEPS),
+	       (unsigned int)(float_cycles / BENCHMARK_SWEEPS),
+	       (unsigned int)acc_envelope_preprocess_memory_size(length));
+
+	acc_envelope_preprocess_destroy(&preprocess);
+
+	return true;
+}
+
+
+void float_reference(uint16_t *data, uint16_t length)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		float average = (RUNNING_AVERAGE_FACTOR * benchmark_average[i]) + ((1.0f - RUNNING_AVERAGE_FACTOR) * (float)data[i]);
+		float above   = average - (float)benchmark_background[i];
+
+		benchmark_average[i] = average;
+		data[i]              = (above > 0.0f) ? (uint16_t)above : 0;
+	}
+}
+
+
+void fill_sweep(uint16_t length, uint32_t sweep)
+{
+	for (uint16_t i = 0; i < length; i++)
+	{
+		benchmark_sweep[i] = (uint16_t)(100 + ((i * 7 + sweep * 13) % 64));
+	}
+}
+
+
+bool run_service(void)
+{
+	acc_service_configuration_t envelope_configuration = acc_service_envelope_configuration_create();
+
+	if (envelope_configuration == NULL)
+	{
+		printf("acc_service_envelope_configuration_create() failed\n");
+		return false;
+	}
+
+	acc_service_sensor_set(envelope_configuration, SENSOR_ID);
+	acc_service_requested_start_set(envelope_configuration, START_M);
+	acc_service_requested_length_set(envelope_configuration, LENGTH_M);
+	acc_service_envelope_running_average_factor_set(envelope_configuration, 0.0f);
+
+	acc_service_handle_t handle = acc_service_create(envelope_configuration);
+
+	acc_service_envelope_configuration_destroy(&envelope_configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		return false;
+	}
+
+	acc_service_envelope_metadata_t envelope_metadata = { 0 };
+	acc_service_envelope_get_metadata(handle, &envelope_metadata);
+
+	acc_envelope_preprocess_t preprocess;
+
+	if (!acc_envelope_preprocess_create(&preprocess, envelope_metadata.data_length, RUNNING_AVERAGE_FACTOR))
+	{
+		printf("acc_envelope_preprocess_create() failed\n");
+		acc_service_destroy(&handle);
+		return false;
+	}
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_envelope_preprocess_destroy(&preprocess);
+		acc_service_destroy(&handle);
+		return false;
+	}
+
+	bool                               success = true;
+	uint16_t                           *data;
+	acc_service_envelope_result_info_t result_info;
+
+	for (uint32_t sweep = 0; sweep < BACKGROUND_SWEEPS + SWEEP_COUNT; sweep++)
+	{
+		if (!acc_service_envelope_get_next_by_reference(handle, &data, &result_info))
+		{
+			printf("acc_service_envelope_get_next_by_reference() failed\n");
+			success = false;
+			break;
+		}
+
+		if (sweep < BACKGROUND_SWEEPS)
+		{
+			acc_envelope_preprocess_background_record(&preprocess, data);
+			continue;
+		}
+
+		acc_envelope_preprocess_process(&preprocess, data);
+
+		uint16_t strongest = 0;
+
+		for (uint16_t i = 1; i < envelope_metadata.data_length; i++)
+		{
+			strongest = (data[i] > data[strongest]) ? i : strongest;
+		}
+
+		printf("Strongest above background: %u at %u mm\n", (unsigned int)data[strongest],
+		       (unsigned int)((envelope_metadata.start_m + (strongest * envelope_metadata.step_length_m)) * 1000.0f));
+	}
+
+	bool deactivated = acc_service_deactivate(handle);
+
+	acc_envelope_preprocess_destroy(&preprocess);
+	acc_service_destroy(&handle);
+
+	return deactivated && success;
+}
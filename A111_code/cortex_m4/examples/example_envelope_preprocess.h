@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_ENVELOPE_PREPROCESS_H_
+#define EXAMPLE_ENVELOPE_PREPROCESS_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Envelope preprocessing example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_envelope_preprocess(int argc, char *argv[]);
+
+
+#endif
@@ -9,8 +9,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "acc_gain_controller.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
+#include "acc_integration_sweep_dump.h"
+#include "acc_recovery_manager.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_service_envelope.h"
@@ -27,18 +30,22 @@
  *   - Activate the envelope service
  *   - Get the result and print it 5 times
  * 	 - Detect and appropriately handle indications from acc_service_envelope_get_next
+ *     using the recovery manager
  *   - Destroy envelope configuration
  *   - Deactivate and destroy the envelope service
  *   - Deactivate Radar System Software (RSS)
  */
 
 
-static void print_data(uint16_t *data, uint16_t data_length);
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+static uint32_t sweep_dump_dropped;
+#endif
 
-static bool handle_indication(acc_service_envelope_result_info_t *result_info, acc_service_handle_t *handle,
-                              acc_service_configuration_t envelope_configuration, bool *success);
 
-static bool restart_service(acc_service_handle_t *handle, acc_service_configuration_t envelope_configuration);
+static void print_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                       const acc_service_envelope_result_info_t *result_info);
+
+static void print_recovery_stats(const acc_recovery_manager_t *recovery);
 
 
 int acc_example_error_handling(int argc, char *argv[]);
@@ -51,6 +58,10 @@ int acc_example_error_handling(int argc, char *argv[])
 
 	printf("Acconeer software version %s\n", acc_version_get());
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_uart_dma_write, true);
+#endif
+
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
 	if (!acc_rss_activate(hal))
@@ -94,7 +105,24 @@ int acc_example_error_handling(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
-	bool                               try_again;
+	/**
+	 * The recovery manager handles the indications in result_info. It starts with the
+	 * cheapest action for each indication and escalates if the indication remains:
+	 *  - Missed data: retry. Only necessary to handle if running streaming mode, it may be
+	 *    avoided by lowering the update rate, adding downsampling or shortening the sweep.
+	 *  - Sensor communication error: recreate the service.
+	 *  - Data saturated: lower the receiver gain and recreate the service. The gain controller
+	 *    of the recovery manager bisects the gain steps, so the highest gain without
+	 *    saturation is found after a few results.
+	 *  - Data quality warning: retry, then recreate the service with a new sensor calibration.
+	 * The sensor calibration is reused when the service is recreated.
+	 */
+	acc_recovery_service_t envelope = { .handle = handle, .configuration = envelope_configuration };
+	acc_recovery_manager_t recovery;
+
+	acc_recovery_manager_init(&recovery, &acc_recovery_service_ops, &envelope, acc_service_sensor_get(envelope_configuration));
+
+	acc_recovery_action_t              action        = ACC_RECOVERY_ACTION_NONE;
 	bool                               success       = true;
 	const int                          iterations    = 5;
 	const int                          attempt_limit = 10;
@@ -118,30 +146,52 @@ int acc_example_error_handling(int argc, char *argv[])
 			}
 
 			/**
-			 * Return value == false is assumed to be due to a sensor_communication_error, which is handled in handle_indication.
+			 * Return value == false is assumed to be due to a sensor communication error.
 			 * Assume that the same data length can be used regardless of indication.
 			 */
-			acc_service_envelope_get_next(handle, data, envelope_metadata.data_length, &result_info);
+			bool got_next = acc_service_envelope_get_next(envelope.handle, data, envelope_metadata.data_length, &result_info);
+
+			acc_recovery_indications_t indications = acc_recovery_indications_envelope(&result_info);
+
+			indications.sensor_communication_error |= !got_next;
+			indications.peak                        = acc_gain_controller_peak_uint16(data, envelope_metadata.data_length);
 
-			try_again = handle_indication(&result_info, &handle, envelope_configuration, &success);
-		} while (try_again);
+			action = acc_recovery_manager_handle(&recovery, &indications);
+
+			if (action != ACC_RECOVERY_ACTION_NONE)
+			{
+				printf("Indication %s, action %s\n", acc_recovery_cause_name(recovery.cause), acc_recovery_action_name(action));
+			}
+		} while (action != ACC_RECOVERY_ACTION_NONE && action != ACC_RECOVERY_ACTION_FAILED);
 
-		if (!success)
+		if (!success || action == ACC_RECOVERY_ACTION_FAILED)
 		{
 			printf("An error was encountered that could not be handled\n");
 			printf("Exiting...\n");
 
+			success = false;
 			break;
 		}
 
-		print_data(data, envelope_metadata.data_length);
+		print_data(data, &envelope_metadata, &result_info);
 	}
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_flush();
+
+	if (sweep_dump_dropped > 0)
+	{
+		printf("%u sweep dump frames dropped\n", (unsigned int)sweep_dump_dropped);
+	}
+#endif
+
+	print_recovery_stats(&recovery);
+
 	acc_service_envelope_configuration_destroy(&envelope_configuration);
 
-	bool deactivated = acc_service_deactivate(handle);
+	bool deactivated = acc_service_deactivate(envelope.handle);
 
-	acc_service_destroy(&handle);
+	acc_service_destroy(&envelope.handle);
 
 	acc_rss_deactivate();
 
@@ -155,10 +205,29 @@ int acc_example_error_handling(int argc, char *argv[])
 }
 
 
-void print_data(uint16_t *data, uint16_t data_length)
+void print_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                const acc_service_envelope_result_info_t *result_info)
 {
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_info_t info =
+	{
+		.stream_id     = 0,
+		.flags         = acc_integration_sweep_dump_flags_envelope(result_info),
+		.start_m       = metadata->start_m,
+		.step_length_m = metadata->step_length_m,
+		.sweep_length  = metadata->data_length,
+		.sweeps        = 1,
+	};
+
+	if (!acc_integration_sweep_dump_uint16(&info, data))
+	{
+		sweep_dump_dropped++;
+	}
+#else
+	(void)result_info;
+
 	printf("Envelope data:\n");
-	for (uint16_t i = 0; i < data_length; i++)
+	for (uint16_t i = 0; i < metadata->data_length; i++)
 	{
 		if ((i > 0) && ((i % 10) == 0))
 		{
@@ -169,109 +238,26 @@ void print_data(uint16_t *data, uint16_t data_length)
 	}
 
 	printf("\n");
+#endif
 }
 
 
-/**
- * This function will look at the result_info field after a call to acc_service_envelope_get_next().
- * Returns true if an error was detected, after trying to correct the error.
- */
-bool handle_indication(acc_service_envelope_result_info_t *result_info, acc_service_handle_t *handle,
-                       acc_service_configuration_t envelope_configuration,
-                       bool *success)
+void print_recovery_stats(const acc_recovery_manager_t *recovery)
 {
-	if (result_info->missed_data)
+	for (acc_recovery_cause_t cause = 0; cause < ACC_RECOVERY_CAUSE_COUNT; cause++)
 	{
-		/**
-		 * Indication of missed data from the sensor.
-		 * Only neccecary to handle this error if running streaming mode.
-		 * Possible actions to mitigate this error are:
-		 *  - Change the update rate using: acc_service_repetition_mode_streaming_set
-		 *  - Add a downsampling factor using: acc_service_envelope_downsampling_factor_set
-		 *  - Change the sweep length using: acc_service_requested_length_set
-		 */
-
-		printf("Missing data was reported\n");
-		printf("Retrying...\n");
-
-		return true;
-	}
-
-	if (result_info->sensor_communication_error)
-	{
-		/**
-		 * Indication of a sensor communication error.
-		 * The service probably needs to be restarted.
-		 */
-
-		printf("There was a sensor communication error\n");
-		printf("Attempting to restart service...\n");
-
-		*success = restart_service(handle, envelope_configuration);
-
-		return *success;
-	}
-
-	if (result_info->data_saturated)
-	{
-		/**
-		 * Indication of sensor data being saturated.
-		 * This can cause result instability.
-		 * Error can be mitigated by lowering the gain of the receiver.
-		 */
-
-		printf("Data was saturated\n");
-		printf("Retrying with lower gain...\n");
+		const acc_recovery_stats_t *stats = acc_recovery_manager_stats_get(recovery, cause);
 
-		float gain              = acc_service_receiver_gain_get(envelope_configuration);
-		float conversion_scalar = 0.9;
-		float new_gain          = gain * conversion_scalar;
-
-		acc_service_receiver_gain_set(envelope_configuration, new_gain);
-
-		*success = restart_service(handle, envelope_configuration);
-
-		return *success;
-	}
-
-	if (result_info->data_quality_warning)
-	{
-		/**
-		 * Indication of bad data quality.
-		 * This may be addressed by restarting the service to recalibrate the sensor.
-		 */
-
-		printf("The data may be of poor quality\n");
-		printf("Attempting to restart service to recalibrate the sensor...\n");
-
-		*success = restart_service(handle, envelope_configuration);
-
-		return *success;
-	}
-
-	// No indications received, so no need to retry
-	return EXIT_FAILURE;
-}
-
-
-bool restart_service(acc_service_handle_t *handle, acc_service_configuration_t envelope_configuration)
-{
-	acc_service_deactivate(*handle);
-	acc_service_destroy(handle);
-
-	*handle = acc_service_create(envelope_configuration);
-
-	if (*handle == NULL)
-	{
-		printf("acc_service_create() failed\n");
-		return false;
-	}
+		if (stats->recoveries == 0)
+		{
+			continue;
+		}
 
-	if (!acc_service_activate(*handle))
-	{
-		printf("acc_service_activate() failed\n");
-		return false;
+		printf("Recovery from %s: %u times, %u failed, latency avg %u ms, max %u ms\n",
+		       acc_recovery_cause_name(cause),
+		       (unsigned int)stats->recoveries,
+		       (unsigned int)stats->failures,
+		       (unsigned int)((stats->recovered > 0) ? stats->total_latency_ms / stats->recovered : 0),
+		       (unsigned int)stats->max_latency_ms);
 	}
-
-	return true;
 }
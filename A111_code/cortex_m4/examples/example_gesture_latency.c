@@ -0,0 +1,292 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_detector_presence.h"
+#include "acc_frame_scheduler.h"
+#include "acc_gesture_engine.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_version.h"
+
+
+/** \example example_gesture_latency.c
+ * @brief This is an example measuring the latency from motion onset to a gesture event
+ * @n
+ * The presence scores of a number of frames are recorded with the wave to exit
+ * configuration, together with a microsecond timestamp per frame. The recording is then
+ * replayed through the gesture engine. For each detected wave, the latency is the time
+ * from the motion onset, the first frame of the rise in presence score that led to the
+ * detection, to the frame that caused the event. The time spent in the gesture engine is
+ * measured during the replay.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Record the presence score and timestamp of each frame, wave in front of the sensor
+ *   - Replay the recording through the gesture engine and print the latency of each wave
+ *   - Print the average and highest latency and gesture engine update time
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define DEFAULT_SENSOR_ID (1U)
+#define RANGE_START_M     (0.12f)
+#define RANGE_LENGTH_M    (0.18f)
+#define UPDATE_RATE_HZ    (80U)
+#define SWEEPS_PER_FRAME  (32U)
+#define HWAAS             (60U)
+#define PROFILE           (ACC_SERVICE_PROFILE_2)
+#define POWER_SAVE_MODE   (ACC_POWER_SAVE_MODE_SLEEP)
+
+#define DETECTION_THRESHOLD (1.4f)
+#define COOL_DOWN_THRESHOLD (1.1f)
+#define COOL_DOWN_TIME_US   (0U)
+
+// Presence score above which a frame is counted as motion, the onset is the first frame of a rise above it
+#define ONSET_SCORE (0.5f)
+
+#define RECORD_FRAMES (10U * UPDATE_RATE_HZ)
+
+
+/**
+ * @brief A recorded frame
+ */
+typedef struct
+{
+	float    score;
+	uint32_t time_us;
+} recorded_frame_t;
+
+
+/**
+ * @brief Latency statistics
+ */
+typedef struct
+{
+	uint32_t waves;
+	uint32_t total_latency_us;
+	uint32_t max_latency_us;
+	uint32_t total_update_us;
+	uint32_t max_update_us;
+} latency_stats_t;
+
+
+static const acc_gesture_transition_t wave_transitions[] =
+{
+	{ ACC_GESTURE_STATE_TRIGGER,    ACC_GESTURE_CONDITION_SCORE_ABOVE,   DETECTION_THRESHOLD, 0U,                ACC_GESTURE_STATE_COOLDOWN,
+	  ACC_GESTURE_EVENT_DETECTED },
+	{ ACC_GESTURE_STATE_COOLDOWN,   ACC_GESTURE_CONDITION_SCORE_BELOW,   COOL_DOWN_THRESHOLD, 0U,                ACC_GESTURE_STATE_REFRACTORY,
+	  ACC_GESTURE_EVENT_RELEASED },
+	{ ACC_GESTURE_STATE_REFRACTORY, ACC_GESTURE_CONDITION_TIME_IN_STATE, 0.0f,                COOL_DOWN_TIME_US, ACC_GESTURE_STATE_TRIGGER,
+	  ACC_GESTURE_EVENT_REARMED },
+};
+
+static recorded_frame_t recording[RECORD_FRAMES];
+
+
+static void configure_detector(acc_detector_presence_configuration_t configuration);
+
+
+static bool record(acc_detector_presence_configuration_t configuration);
+
+
+static void replay(latency_stats_t *stats);
+
+
+int acc_example_gesture_latency(int argc, char *argv[]);
+
+
+int acc_example_gesture_latency(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_detector_presence_configuration_t configuration = acc_detector_presence_configuration_create();
+
+	if (configuration == NULL)
+	{
+		printf("acc_detector_presence_configuration_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	configure_detector(configuration);
+
+	bool success = record(configuration);
+
+	acc_detector_presence_configuration_destroy(&configuration);
+	acc_rss_deactivate();
+
+	if (!success)
+	{
+		return EXIT_FAILURE;
+	}
+
+	latency_stats_t stats = { 0 };
+
+	replay(&stats);
+
+	uint32_t waves = (stats.waves > 0) ? stats.waves : 1;
+
+	printf("Waves: %u, latency avg: %u us, max: %u us\n",
+	       (unsigned int)stats.waves,
+	       (unsigned int)(stats.total_latency_us / waves),
+	       (unsigned int)stats.max_latency_us);
+	printf("Gesture engine update avg: %u us, max: %u us\n",
+	       (unsigned int)(stats.total_update_us / RECORD_FRAMES),
+	       (unsigned int)stats.max_update_us);
+
+	printf("Application finished OK\n");
+
+	return EXIT_SUCCESS;
+}
+
+
+void configure_detector(acc_detector_presence_configuration_t configuration)
+{
+	acc_detector_presence_configuration_sensor_set(configuration, DEFAULT_SENSOR_ID);
+
+	acc_detector_presence_configuration_service_profile_set(configuration, PROFILE);
+	acc_detector_presence_configuration_start_set(configuration, RANGE_START_M);
+	acc_detector_presence_configuration_length_set(configuration, RANGE_LENGTH_M);
+	acc_detector_presence_configuration_hw_accelerated_average_samples_set(configuration, HWAAS);
+	acc_detector_presence_configuration_sweeps_per_frame_set(configuration, SWEEPS_PER_FRAME);
+	acc_detector_presence_configuration_power_save_mode_set(configuration, POWER_SAVE_MODE);
+	acc_detector_presence_configuration_update_rate_set(configuration, UPDATE_RATE_HZ);
+	acc_detector_presence_configuration_detection_threshold_set(configuration, DETECTION_THRESHOLD);
+
+	acc_detector_presence_configuration_filter_parameters_t filter = acc_detector_presence_configuration_filter_parameters_get(
+		configuration);
+
+	filter.intra_frame_weight     = 1.0f;
+	filter.intra_frame_time_const = 0.05f;
+	filter.output_time_const      = 0.02f;
+
+	acc_detector_presence_configuration_filter_parameters_set(configuration, &filter);
+}
+
+
+bool record(acc_detector_presence_configuration_t configuration)
+{
+	acc_detector_presence_handle_t handle = acc_detector_presence_create(configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_detector_presence_create() failed\n");
+		return false;
+	}
+
+	if (!acc_detector_presence_activate(handle))
+	{
+		printf("acc_detector_presence_activate() failed\n");
+		acc_detector_presence_destroy(&handle);
+		return false;
+	}
+
+	printf("Recording %u frames, wave in front of the sensor\n", (unsigned int)RECORD_FRAMES);
+
+	acc_frame_scheduler_t scheduler;
+
+	acc_frame_scheduler_init(&scheduler, UPDATE_RATE_HZ);
+
+	bool success = true;
+
+	for (uint32_t frame = 0; frame < RECORD_FRAMES; frame++)
+	{
+		acc_detector_presence_result_t result;
+
+		acc_frame_scheduler_wait(&scheduler);
+
+		if (!acc_detector_presence_get_next(handle, &result))
+		{
+			printf("acc_detector_presence_get_next() failed\n");
+			success = false;
+			break;
+		}
+
+		recording[frame].time_us = acc_integration_get_time_us();
+		recording[frame].score   = result.presence_score;
+	}
+
+	acc_frame_scheduler_stats_print(&scheduler);
+
+	if (!acc_detector_presence_deactivate(handle))
+	{
+		printf("acc_detector_presence_deactivate() failed\n");
+		success = false;
+	}
+
+	acc_detector_presence_destroy(&handle);
+
+	return success;
+}
+
+
+void replay(latency_stats_t *stats)
+{
+	acc_gesture_engine_t engine;
+
+	acc_gesture_engine_init(&engine, wave_transitions, sizeof(wave_transitions) / sizeof(wave_transitions[0]), NULL, NULL);
+
+	uint32_t onset_frame = 0;
+	bool     in_motion   = false;
+
+	for (uint32_t frame = 0; frame < RECORD_FRAMES; frame++)
+	{
+		const recorded_frame_t *recorded = &recording[frame];
+
+		if (recorded->score >= ONSET_SCORE)
+		{
+			if (!in_motion)
+			{
+				onset_frame = frame;
+				in_motion   = true;
+			}
+		}
+		else
+		{
+			in_motion = false;
+		}
+
+		uint32_t            start_us  = acc_integration_get_time_us();
+		acc_gesture_event_t event     = acc_gesture_engine_update(&engine, recorded->score, recorded->time_us);
+		uint32_t            update_us = acc_integration_get_time_us() - start_us;
+
+		stats->total_update_us += update_us;
+		stats->max_update_us    = (update_us > stats->max_update_us) ? update_us : stats->max_update_us;
+
+		if (event == ACC_GESTURE_EVENT_DETECTED)
+		{
+			uint32_t latency_us = recorded->time_us - recording[onset_frame].time_us;
+
+			printf("Wave at frame %u, onset at frame %u, latency %u us\n",
+			       (unsigned int)frame,
+			       (unsigned int)onset_frame,
+			       (unsigned int)latency_us);
+
+			stats->waves++;
+			stats->total_latency_us += latency_us;
+			stats->max_latency_us    = (latency_us > stats->max_latency_us) ? latency_us : stats->max_latency_us;
+		}
+	}
+}
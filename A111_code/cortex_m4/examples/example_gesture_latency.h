@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_GESTURE_LATENCY_H_
+#define EXAMPLE_GESTURE_LATENCY_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Gesture latency example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_gesture_latency(int argc, char *argv[]);
+
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
+#include "acc_integration_sweep_dump.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_service_envelope.h"
@@ -45,10 +46,17 @@
  */
 
 
-static void print_envelope_data(uint16_t *data, uint16_t data_length);
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+static uint32_t sweep_dump_dropped;
+#endif
 
 
-static void print_sparse_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per_frame);
+static void print_envelope_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                                const acc_service_envelope_result_info_t *result_info);
+
+
+static void print_sparse_data(uint16_t *data, const acc_service_sparse_metadata_t *metadata, uint16_t sweeps_per_frame,
+                              const acc_service_sparse_result_info_t *result_info);
 
 
 int acc_example_multiple_service_usage(int argc, char *argv[]);
@@ -60,6 +68,10 @@ int acc_example_multiple_service_usage(int argc, char *argv[])
 	(void)argv;
 	printf("Acconeer software version %s\n", acc_version_get());
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_uart_dma_write, true);
+#endif
+
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
 	// Activate RSS and override sensor ID check
@@ -154,7 +166,7 @@ int acc_example_multiple_service_usage(int argc, char *argv[])
 			break;
 		}
 
-		print_envelope_data(envelope_data, envelope_metadata.data_length);
+		print_envelope_data(envelope_data, &envelope_metadata, &envelope_result_info);
 
 		if (!acc_service_deactivate(envelope_handle))
 		{
@@ -179,7 +191,7 @@ int acc_example_multiple_service_usage(int argc, char *argv[])
 			break;
 		}
 
-		print_sparse_data(sparse_data, sparse_metadata.data_length, sweeps_per_frame);
+		print_sparse_data(sparse_data, &sparse_metadata, sweeps_per_frame, &sparse_result_info);
 
 		if (!acc_service_deactivate(sparse_handle))
 		{
@@ -189,6 +201,15 @@ int acc_example_multiple_service_usage(int argc, char *argv[])
 		}
 	}
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_flush();
+
+	if (sweep_dump_dropped > 0)
+	{
+		printf("%u sweep dump frames dropped\n", (unsigned int)sweep_dump_dropped);
+	}
+#endif
+
 	acc_service_destroy(&envelope_handle);
 	acc_service_destroy(&sparse_handle);
 
@@ -202,10 +223,29 @@ int acc_example_multiple_service_usage(int argc, char *argv[])
 }
 
 
-void print_envelope_data(uint16_t *data, uint16_t data_length)
+void print_envelope_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                         const acc_service_envelope_result_info_t *result_info)
 {
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_info_t info =
+	{
+		.stream_id     = 0,
+		.flags         = acc_integration_sweep_dump_flags_envelope(result_info),
+		.start_m       = metadata->start_m,
+		.step_length_m = metadata->step_length_m,
+		.sweep_length  = metadata->data_length,
+		.sweeps        = 1,
+	};
+
+	if (!acc_integration_sweep_dump_uint16(&info, data))
+	{
+		sweep_dump_dropped++;
+	}
+#else
+	(void)result_info;
+
 	printf("Envelope data:\n");
-	for (uint16_t i = 0; i < data_length; i++)
+	for (uint16_t i = 0; i < metadata->data_length; i++)
 	{
 		if ((i > 0) && ((i % 8) == 0))
 		{
@@ -216,12 +256,32 @@ void print_envelope_data(uint16_t *data, uint16_t data_length)
 	}
 
 	printf("\n\n");
+#endif
 }
 
 
-void print_sparse_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per_frame)
+void print_sparse_data(uint16_t *data, const acc_service_sparse_metadata_t *metadata, uint16_t sweeps_per_frame,
+                       const acc_service_sparse_result_info_t *result_info)
 {
-	uint16_t sweep_length = data_length / sweeps_per_frame;
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_info_t info =
+	{
+		.stream_id     = 1,
+		.flags         = acc_integration_sweep_dump_flags_sparse(result_info),
+		.start_m       = metadata->start_m,
+		.step_length_m = metadata->step_length_m,
+		.sweep_length  = metadata->data_length / sweeps_per_frame,
+		.sweeps        = sweeps_per_frame,
+	};
+
+	if (!acc_integration_sweep_dump_uint16(&info, data))
+	{
+		sweep_dump_dropped++;
+	}
+#else
+	(void)result_info;
+
+	uint16_t sweep_length = metadata->data_length / sweeps_per_frame;
 
 	printf("Sparse data:\n");
 	for (uint16_t sweep = 0; sweep < sweeps_per_frame; sweep++)
@@ -237,4 +297,5 @@ void print_sparse_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per
 	}
 
 	printf("\n");
+#endif
 }
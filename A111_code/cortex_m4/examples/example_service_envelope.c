@@ -9,8 +9,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "acc_gain_controller.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
+#include "acc_integration_sweep_dump.h"
+#include "acc_recovery_manager.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_service_envelope.h"
@@ -24,18 +27,24 @@
  *   - Activate Radar System Software (RSS)
  *   - Create an envelope service configuration
  *   - Create an envelope service using the previously created configuration
- *   - Destroy the envelope service configuration
  *   - Activate the envelope service
- *   - Get the result and print it 5 times
+ *   - Get the result and print it 5 times, indications are handled by the recovery manager
  *   - Deactivate and destroy the envelope service
+ *   - Destroy the envelope service configuration
  *   - Deactivate Radar System Software (RSS)
  */
 
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+static uint32_t sweep_dump_dropped;
+#endif
+
+
 static void update_configuration(acc_service_configuration_t envelope_configuration);
 
 
-static void print_data(uint16_t *data, uint16_t data_length);
+static void print_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                       const acc_service_envelope_result_info_t *result_info);
 
 
 int acc_example_service_envelope(int argc, char *argv[]);
@@ -47,6 +56,10 @@ int acc_example_service_envelope(int argc, char *argv[])
 	(void)argv;
 	printf("Acconeer software version %s\n", acc_version_get());
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_uart_dma_write, true);
+#endif
+
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
 	if (!acc_rss_activate(hal))
@@ -76,8 +89,6 @@ int acc_example_service_envelope(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
-	acc_service_envelope_configuration_destroy(&envelope_configuration);
-
 	acc_service_envelope_metadata_t envelope_metadata = { 0 };
 	acc_service_envelope_get_metadata(handle, &envelope_metadata);
 
@@ -89,10 +100,17 @@ int acc_example_service_envelope(int argc, char *argv[])
 	{
 		printf("acc_service_activate() failed\n");
 		acc_service_destroy(&handle);
+		acc_service_envelope_configuration_destroy(&envelope_configuration);
 		acc_rss_deactivate();
 		return EXIT_FAILURE;
 	}
 
+	// The configuration is kept, the recovery manager recreates the service from it
+	acc_recovery_service_t envelope = { .handle = handle, .configuration = envelope_configuration };
+	acc_recovery_manager_t recovery;
+
+	acc_recovery_manager_init(&recovery, &acc_recovery_service_ops, &envelope, acc_service_sensor_get(envelope_configuration));
+
 	bool                               success    = true;
 	const int                          iterations = 5;
 	uint16_t                           data[envelope_metadata.data_length];
@@ -100,20 +118,44 @@ int acc_example_service_envelope(int argc, char *argv[])
 
 	for (int i = 0; i < iterations; i++)
 	{
-		success = acc_service_envelope_get_next(handle, data, envelope_metadata.data_length, &result_info);
+		acc_recovery_action_t action;
 
-		if (!success)
+		do
 		{
-			printf("acc_service_envelope_get_next() failed\n");
+			bool got_next = acc_service_envelope_get_next(envelope.handle, data, envelope_metadata.data_length, &result_info);
+
+			acc_recovery_indications_t indications = acc_recovery_indications_envelope(&result_info);
+
+			indications.sensor_communication_error |= !got_next;
+			indications.peak                        = acc_gain_controller_peak_uint16(data, envelope_metadata.data_length);
+
+			action = acc_recovery_manager_handle(&recovery, &indications);
+		} while (action != ACC_RECOVERY_ACTION_NONE && action != ACC_RECOVERY_ACTION_FAILED);
+
+		if (action == ACC_RECOVERY_ACTION_FAILED)
+		{
+			printf("acc_service_envelope_get_next() failed, %s could not be recovered\n", acc_recovery_cause_name(recovery.cause));
+			success = false;
 			break;
 		}
 
-		print_data(data, envelope_metadata.data_length);
+		print_data(data, &envelope_metadata, &result_info);
+	}
+
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_flush();
+
+	if (sweep_dump_dropped > 0)
+	{
+		printf("%u sweep dump frames dropped\n", (unsigned int)sweep_dump_dropped);
 	}
+#endif
 
-	bool deactivated = acc_service_deactivate(handle);
+	bool deactivated = acc_service_deactivate(envelope.handle);
 
-	acc_service_destroy(&handle);
+	acc_service_destroy(&envelope.handle);
+
+	acc_service_envelope_configuration_destroy(&envelope_configuration);
 
 	acc_rss_deactivate();
 
@@ -137,10 +179,29 @@ void update_configuration(acc_service_configuration_t envelope_configuration)
 }
 
 
-void print_data(uint16_t *data, uint16_t data_length)
+void print_data(uint16_t *data, const acc_service_envelope_metadata_t *metadata,
+                const acc_service_envelope_result_info_t *result_info)
 {
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_info_t info =
+	{
+		.stream_id     = 0,
+		.flags         = acc_integration_sweep_dump_flags_envelope(result_info),
+		.start_m       = metadata->start_m,
+		.step_length_m = metadata->step_length_m,
+		.sweep_length  = metadata->data_length,
+		.sweeps        = 1,
+	};
+
+	if (!acc_integration_sweep_dump_uint16(&info, data))
+	{
+		sweep_dump_dropped++;
+	}
+#else
+	(void)result_info;
+
 	printf("Envelope data:\n");
-	for (uint16_t i = 0; i < data_length; i++)
+	for (uint16_t i = 0; i < metadata->data_length; i++)
 	{
 		if ((i > 0) && ((i % 8) == 0))
 		{
@@ -151,4 +212,5 @@ void print_data(uint16_t *data, uint16_t data_length)
 	}
 
 	printf("\n");
+#endif
 }
@@ -0,0 +1,271 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <complex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_definitions_common.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_iq_q15.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_iq.h"
+#include "acc_version.h"
+
+
+/** \example example_service_iq_q15.c
+ * @brief This is an example on how the IQ service can be used with fixed point processing
+ * @n
+ * The IQ service is configured for int16 complex output and the frames are processed by
+ * reference, without a copy, with acc_iq_q15. For comparison, each frame is also converted
+ * to float complex and processed in the same way in floating point, as with the float
+ * complex output format. The processing times and the RAM used by both paths are printed.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Create an IQ service configuration with int16 complex output
+ *   - Create an IQ service using the previously created configuration
+ *   - Destroy the IQ service configuration
+ *   - Activate the IQ service
+ *   - Get a number of frames, track the micro-motion displacement of the strongest point
+ *     in fixed and floating point, and print it
+ *   - Print the processing time and RAM of both paths
+ *   - Deactivate and destroy the IQ service
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID      1
+#define START_M        0.3f
+#define LENGTH_M       0.6f
+#define FRAME_COUNT    200
+#define PRINT_INTERVAL 10
+
+// Weight of a new displacement in the displacement filter, 0.1 in Q15
+#define FILTER_Q15 3277
+
+
+/**
+ * @brief Floating point reference of the fixed point processing
+ */
+typedef struct
+{
+	float complex *frame;
+	float complex *previous;
+	float         *power;
+	float         *magnitude;
+	float         *phase;
+	uint16_t      tracked_point;
+	float         unwrapped_phase;
+	uint32_t      frames;
+} float_path_t;
+
+
+static void float_path_update(float_path_t *path, const acc_int16_complex_t *data, uint16_t length);
+
+
+int acc_example_service_iq_q15(int argc, char *argv[]);
+
+
+int acc_example_service_iq_q15(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_service_configuration_t iq_configuration = acc_service_iq_configuration_create();
+
+	if (iq_configuration == NULL)
+	{
+		printf("acc_service_iq_configuration_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_sensor_set(iq_configuration, SENSOR_ID);
+	acc_service_requested_start_set(iq_configuration, START_M);
+	acc_service_requested_length_set(iq_configuration, LENGTH_M);
+	acc_service_iq_output_format_set(iq_configuration, ACC_SERVICE_IQ_OUTPUT_FORMAT_INT16_COMPLEX);
+
+	acc_service_handle_t handle = acc_service_create(iq_configuration);
+
+	acc_service_iq_configuration_destroy(&iq_configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_iq_metadata_t iq_metadata = { 0 };
+	acc_service_iq_get_metadata(handle, &iq_metadata);
+
+	uint16_t             length = iq_metadata.data_length;
+	acc_iq_q15_tracker_t tracker;
+
+	if (!acc_iq_q15_tracker_create(&tracker, length, FILTER_Q15))
+	{
+		printf("acc_iq_q15_tracker_create() failed\n");
+		acc_service_destroy(&handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	uint16_t      magnitude[length];
+	int16_t       phase[length];
+	float complex float_frame[length];
+	float complex float_previous[length];
+	float         float_power[length];
+	float         float_magnitude[length];
+	float         float_phase[length];
+	float_path_t  float_path =
+	{
+		.frame     = float_frame,
+		.previous  = float_previous,
+		.power     = float_power,
+		.magnitude = float_magnitude,
+		.phase     = float_phase,
+	};
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_iq_q15_tracker_destroy(&tracker);
+		acc_service_destroy(&handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	bool                         success        = true;
+	uint32_t                     fixed_total_us = 0;
+	uint32_t                     float_total_us = 0;
+	acc_int16_complex_t          *data;
+	acc_service_iq_result_info_t result_info;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		if (!acc_service_iq_get_next_by_reference(handle, &data, &result_info))
+		{
+			printf("acc_service_iq_get_next_by_reference() failed\n");
+			success = false;
+			break;
+		}
+
+		uint32_t start_us = acc_integration_get_time_us();
+
+		acc_iq_q15_polar(data, length, magnitude, phase);
+		acc_iq_q15_tracker_update(&tracker, data);
+
+		uint32_t fixed_end_us = acc_integration_get_time_us();
+
+		float_path_update(&float_path, data, length);
+
+		uint32_t float_end_us = acc_integration_get_time_us();
+
+		fixed_total_us += fixed_end_us - start_us;
+		float_total_us += float_end_us - fixed_end_us;
+
+		if ((frame % PRINT_INTERVAL) == 0)
+		{
+			float float_displacement_um = float_path.unwrapped_phase * (float)ACC_IQ_Q15_WAVELENGTH_UM / (4.0f * 3.14159265f);
+
+			printf("Point %u, displacement: %d um, filtered: %d um, float: %d um\n",
+			       (unsigned int)tracker.tracked_point,
+			       (int)tracker.displacement_um,
+			       (int)tracker.filtered_displacement_um,
+			       (int)float_displacement_um);
+		}
+	}
+
+	if (success)
+	{
+		size_t fixed_ram = acc_iq_q15_tracker_memory_size(length) + sizeof(magnitude) + sizeof(phase);
+		size_t float_ram = sizeof(float_frame) + sizeof(float_previous) + sizeof(float_power) + sizeof(float_magnitude) +
+		                   sizeof(float_phase);
+
+		printf("Fixed point: %u us per frame, %u bytes RAM\n", (unsigned int)(fixed_total_us / FRAME_COUNT),
+		       (unsigned int)fixed_ram);
+		printf("Floating point: %u us per frame, %u bytes RAM\n", (unsigned int)(float_total_us / FRAME_COUNT),
+		       (unsigned int)float_ram);
+	}
+
+	bool deactivated = acc_service_deactivate(handle);
+
+	acc_iq_q15_tracker_destroy(&tracker);
+	acc_service_destroy(&handle);
+
+	acc_rss_deactivate();
+
+	if (deactivated && success)
+	{
+		printf("Application finished OK\n");
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
+
+
+void float_path_update(float_path_t *path, const acc_int16_complex_t *data, uint16_t length)
+{
+	uint16_t strongest_point = 0;
+	float    strongest_power = -1.0f;
+
+	for (uint16_t point = 0; point < length; point++)
+	{
+		float complex value = (float)data[point].real + ((float)data[point].imag * I);
+
+		path->frame[point]     = value;
+		path->magnitude[point] = cabsf(value);
+		path->phase[point]     = cargf(value);
+
+		float power = path->magnitude[point] * path->magnitude[point];
+
+		if (path->frames > 0)
+		{
+			power = path->power[point] + ((power - path->power[point]) * 0.125f);
+		}
+
+		path->power[point] = power;
+
+		if (power > strongest_power)
+		{
+			strongest_power = power;
+			strongest_point = point;
+		}
+	}
+
+	if (path->frames == 0 || strongest_power > path->power[path->tracked_point] * 2.0f)
+	{
+		path->tracked_point = strongest_point;
+	}
+
+	if (path->frames > 0)
+	{
+		path->unwrapped_phase += cargf(path->frame[path->tracked_point] * conjf(path->previous[path->tracked_point]));
+	}
+
+	for (uint16_t point = 0; point < length; point++)
+	{
+		path->previous[point] = path->frame[point];
+	}
+
+	path->frames++;
+}
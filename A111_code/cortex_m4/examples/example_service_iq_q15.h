@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_SERVICE_IQ_Q15_H_
+#define EXAMPLE_SERVICE_IQ_Q15_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief IQ service fixed point processing example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_service_iq_q15(int argc, char *argv[]);
+
+
+#endif
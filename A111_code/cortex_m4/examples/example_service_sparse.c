@@ -9,8 +9,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "acc_gain_controller.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
+#include "acc_integration_sweep_dump.h"
+#include "acc_recovery_manager.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_service_sparse.h"
@@ -25,18 +28,24 @@
  *   - Activate Radar System Software (RSS)
  *   - Create a sparse service configuration
  *   - Create a sparse service using the previously created configuration
- *   - Destroy the sparse service configuration
  *   - Activate the sparse service
- *   - Get the result and print it 5 times
+ *   - Get the result and print it 5 times, indications are handled by the recovery manager
  *   - Deactivate and destroy the sparse service
+ *   - Destroy the sparse service configuration
  *   - Deactivate Radar System Software (RSS)
  */
 
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+static uint32_t sweep_dump_dropped;
+#endif
+
+
 static void update_configuration(acc_service_configuration_t sparse_configuration);
 
 
-static void print_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per_frame);
+static void print_data(uint16_t *data, const acc_service_sparse_metadata_t *metadata, uint16_t sweeps_per_frame,
+                       const acc_service_sparse_result_info_t *result_info);
 
 
 int acc_example_service_sparse(int argc, char *argv[]);
@@ -48,6 +57,10 @@ int acc_example_service_sparse(int argc, char *argv[])
 	(void)argv;
 	printf("Acconeer software version %s\n", acc_version_get());
 
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_uart_dma_write, true);
+#endif
+
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
 	if (!acc_rss_activate(hal))
@@ -87,16 +100,21 @@ int acc_example_service_sparse(int argc, char *argv[])
 	printf("Data length: %u\n", (unsigned int)(sparse_metadata.data_length));
 	printf("Sweeps per frame: %u\n", (unsigned int)sweeps_per_frame);
 
-	acc_service_sparse_configuration_destroy(&sparse_configuration);
-
 	if (!acc_service_activate(handle))
 	{
 		printf("acc_service_activate() failed\n");
 		acc_service_destroy(&handle);
+		acc_service_sparse_configuration_destroy(&sparse_configuration);
 		acc_rss_deactivate();
 		return EXIT_FAILURE;
 	}
 
+	// The configuration is kept, the recovery manager recreates the service from it
+	acc_recovery_service_t sparse = { .handle = handle, .configuration = sparse_configuration };
+	acc_recovery_manager_t recovery;
+
+	acc_recovery_manager_init(&recovery, &acc_recovery_service_ops, &sparse, acc_service_sensor_get(sparse_configuration));
+
 	bool                             success    = true;
 	const int                        iterations = 5;
 	uint16_t                         data[sparse_metadata.data_length];
@@ -104,20 +122,44 @@ int acc_example_service_sparse(int argc, char *argv[])
 
 	for (int i = 0; i < iterations; i++)
 	{
-		success = acc_service_sparse_get_next(handle, data, sparse_metadata.data_length, &result_info);
+		acc_recovery_action_t action;
 
-		if (!success)
+		do
 		{
-			printf("acc_service_sparse_get_next() failed\n");
+			bool got_next = acc_service_sparse_get_next(sparse.handle, data, sparse_metadata.data_length, &result_info);
+
+			acc_recovery_indications_t indications = acc_recovery_indications_sparse(&result_info);
+
+			indications.sensor_communication_error |= !got_next;
+			indications.peak                        = acc_gain_controller_peak_uint16(data, sparse_metadata.data_length);
+
+			action = acc_recovery_manager_handle(&recovery, &indications);
+		} while (action != ACC_RECOVERY_ACTION_NONE && action != ACC_RECOVERY_ACTION_FAILED);
+
+		if (action == ACC_RECOVERY_ACTION_FAILED)
+		{
+			printf("acc_service_sparse_get_next() failed, %s could not be recovered\n", acc_recovery_cause_name(recovery.cause));
+			success = false;
 			break;
 		}
 
-		print_data(data, sparse_metadata.data_length, sweeps_per_frame);
+		print_data(data, &sparse_metadata, sweeps_per_frame, &result_info);
+	}
+
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_flush();
+
+	if (sweep_dump_dropped > 0)
+	{
+		printf("%u sweep dump frames dropped\n", (unsigned int)sweep_dump_dropped);
 	}
+#endif
 
-	bool deactivated = acc_service_deactivate(handle);
+	bool deactivated = acc_service_deactivate(sparse.handle);
 
-	acc_service_destroy(&handle);
+	acc_service_destroy(&sparse.handle);
+
+	acc_service_sparse_configuration_destroy(&sparse_configuration);
 
 	acc_rss_deactivate();
 
@@ -144,9 +186,28 @@ void update_configuration(acc_service_configuration_t sparse_configuration)
 }
 
 
-void print_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per_frame)
+void print_data(uint16_t *data, const acc_service_sparse_metadata_t *metadata, uint16_t sweeps_per_frame,
+                const acc_service_sparse_result_info_t *result_info)
 {
-	uint16_t sweep_length = data_length / sweeps_per_frame;
+#if defined(ACC_EXAMPLE_SWEEP_DUMP)
+	acc_integration_sweep_dump_info_t info =
+	{
+		.stream_id     = 0,
+		.flags         = acc_integration_sweep_dump_flags_sparse(result_info),
+		.start_m       = metadata->start_m,
+		.step_length_m = metadata->step_length_m,
+		.sweep_length  = metadata->data_length / sweeps_per_frame,
+		.sweeps        = sweeps_per_frame,
+	};
+
+	if (!acc_integration_sweep_dump_uint16(&info, data))
+	{
+		sweep_dump_dropped++;
+	}
+#else
+	(void)result_info;
+
+	uint16_t sweep_length = metadata->data_length / sweeps_per_frame;
 
 	printf("Sparse data:\n");
 
@@ -163,4 +224,5 @@ void print_data(uint16_t *data, uint16_t data_length, uint16_t sweeps_per_frame)
 	}
 
 	printf("\n");
+#endif
 }
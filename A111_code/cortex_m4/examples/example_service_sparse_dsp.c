@@ -0,0 +1,177 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_sparse.h"
+#include "acc_sparse_dsp.h"
+#include "acc_version.h"
+
+
+/** \example example_service_sparse_dsp.c
+ * @brief This is an example on how the sparse frames can be processed with acc_sparse_dsp
+ * @n
+ * The example measures the time spent processing each frame. Build with ACC_SIMD_DISABLE
+ * defined to compare the DSP extension kernels with the portable C ones.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - Create a sparse service configuration
+ *   - Create a sparse service using the previously created configuration
+ *   - Create the sparse frame processing from the service metadata
+ *   - Activate the sparse service
+ *   - Get and process a number of frames, printing the strongest point and its speed
+ *   - Print the processing time per frame
+ *   - Deactivate and destroy the sparse service
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID        1
+#define START_M          0.18f
+#define LENGTH_M         0.36f
+#define SWEEPS_PER_FRAME 32
+#define SWEEP_RATE_HZ    3000.0f
+#define FILTER_FACTOR    0.8f
+#define FRAME_COUNT      200
+#define PRINT_INTERVAL   20
+
+
+int acc_example_service_sparse_dsp(int argc, char *argv[]);
+
+
+int acc_example_service_sparse_dsp(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	acc_service_configuration_t sparse_configuration = acc_service_sparse_configuration_create();
+
+	if (sparse_configuration == NULL)
+	{
+		printf("acc_service_sparse_configuration_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_sensor_set(sparse_configuration, SENSOR_ID);
+	acc_service_requested_start_set(sparse_configuration, START_M);
+	acc_service_requested_length_set(sparse_configuration, LENGTH_M);
+	acc_service_sparse_configuration_sweeps_per_frame_set(sparse_configuration, SWEEPS_PER_FRAME);
+	acc_service_sparse_configuration_sweep_rate_set(sparse_configuration, SWEEP_RATE_HZ);
+
+	acc_service_handle_t handle = acc_service_create(sparse_configuration);
+
+	acc_service_sparse_configuration_destroy(&sparse_configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	acc_service_sparse_metadata_t sparse_metadata = { 0 };
+	acc_service_sparse_get_metadata(handle, &sparse_metadata);
+
+	uint16_t         sweep_length = sparse_metadata.data_length / SWEEPS_PER_FRAME;
+	acc_sparse_dsp_t dsp;
+
+	if (!acc_sparse_dsp_create(&dsp, SWEEPS_PER_FRAME, sweep_length, SWEEP_RATE_HZ, FILTER_FACTOR))
+	{
+		printf("acc_sparse_dsp_create() failed\n");
+		acc_service_destroy(&handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	printf("Sweep length: %u, sweeps per frame: %u, kernels: %s\n", (unsigned int)sweep_length, (unsigned int)SWEEPS_PER_FRAME,
+	       acc_sparse_dsp_kernel_name());
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_sparse_dsp_destroy(&dsp);
+		acc_service_destroy(&handle);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
+
+	bool                             success          = true;
+	uint32_t                         total_process_us = 0;
+	uint32_t                         max_process_us   = 0;
+	uint16_t                         *data;
+	acc_service_sparse_result_info_t result_info;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		if (!acc_service_sparse_get_next_by_reference(handle, &data, &result_info))
+		{
+			printf("acc_service_sparse_get_next_by_reference() failed\n");
+			success = false;
+			break;
+		}
+
+		uint32_t start_us = acc_integration_get_time_us();
+
+		acc_sparse_dsp_process(&dsp, data);
+
+		uint32_t process_us = acc_integration_get_time_us() - start_us;
+
+		total_process_us += process_us;
+		max_process_us    = (process_us > max_process_us) ? process_us : max_process_us;
+
+		if ((frame % PRINT_INTERVAL) == 0)
+		{
+			uint16_t point = dsp.strongest_point;
+
+			printf("Strongest at %u mm, energy: %u, speed: %u mm/s\n",
+			       (unsigned int)((sparse_metadata.start_m + (float)point * sparse_metadata.step_length_m) * 1000.0f),
+			       (unsigned int)dsp.filtered_energy[point],
+			       (unsigned int)(dsp.speed * 1000.0f));
+		}
+	}
+
+	if (success)
+	{
+		printf("Processing time avg: %u us, max: %u us per frame of %u values\n",
+		       (unsigned int)(total_process_us / FRAME_COUNT),
+		       (unsigned int)max_process_us,
+		       (unsigned int)sparse_metadata.data_length);
+	}
+
+	bool deactivated = acc_service_deactivate(handle);
+
+	acc_sparse_dsp_destroy(&dsp);
+	acc_service_destroy(&handle);
+
+	acc_rss_deactivate();
+
+	if (deactivated && success)
+	{
+		printf("Application finished OK\n");
+		return EXIT_SUCCESS;
+	}
+
+	return EXIT_FAILURE;
+}
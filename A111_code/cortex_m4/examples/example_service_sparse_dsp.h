@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_SERVICE_SPARSE_DSP_H_
+#define EXAMPLE_SERVICE_SPARSE_DSP_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Sparse frame processing example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_service_sparse_dsp(int argc, char *argv[]);
+
+
+#endif
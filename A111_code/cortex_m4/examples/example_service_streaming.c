@@ -0,0 +1,339 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_frame_scheduler.h"
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_envelope.h"
+#include "acc_service_sparse.h"
+#include "acc_version.h"
+
+
+/** \example example_service_streaming.c
+ * @brief This is an example comparing on demand and streaming repetition mode
+ * @n
+ * In on demand mode the application triggers each frame and is responsible for the
+ * timing, here with the frame scheduler. In streaming mode the sensor triggers the
+ * frames with its own timer and the application waits for the frame interrupt in
+ * get_next, with the MCU sleeping in the wait for the sensor interrupt.
+ * @n
+ * The presence and distance detectors only support on demand mode. The example uses
+ * the services they are built on, sparse for presence and envelope for distance,
+ * configured as in the presence and distance reference applications.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS)
+ *   - For a sparse and an envelope service configuration
+ *     - Run a number of frames in on demand mode, paced by the frame scheduler
+ *     - Run the same number of frames in streaming mode
+ *     - Print the frame interval jitter, missed data and the part of the time
+ *       the MCU was awake for both modes
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID      1
+#define UPDATE_RATE_HZ 80.0f
+#define FRAME_COUNT    800
+
+// Busy time per frame, simulating processing. Raise it to see missed data in streaming mode.
+#ifndef PROCESSING_TIME_MS
+#define PROCESSING_TIME_MS 0
+#endif
+
+// Missed data events printed per run, the rest are only counted
+#define MISSED_DATA_PRINT_LIMIT 5
+
+#define SPARSE_START_M          0.12f
+#define SPARSE_LENGTH_M         0.18f
+#define SPARSE_SWEEPS_PER_FRAME 32
+#define SPARSE_SWEEP_RATE_HZ    3000.0f
+
+#define ENVELOPE_START_M  0.2f
+#define ENVELOPE_LENGTH_M 0.5f
+
+
+typedef enum
+{
+	SERVICE_TYPE_SPARSE,
+	SERVICE_TYPE_ENVELOPE
+} service_type_t;
+
+
+/**
+ * @brief Frame timing statistics for one run
+ */
+typedef struct
+{
+	uint32_t frames;
+	uint32_t missed_data;
+	/** Number of intervals longer than 1.5 periods, a frame was lost */
+	uint32_t lost_frames;
+	/** Sum of absolute deviations of the frame interval from the period in us */
+	uint32_t total_jitter_us;
+	/** Highest absolute deviation of the frame interval from the period in us */
+	uint32_t max_jitter_us;
+	/** Time spent waiting for frames, sleeping or in get_next, in us */
+	uint32_t wait_us;
+	uint32_t total_us;
+} run_stats_t;
+
+
+static bool run(acc_service_configuration_t configuration, service_type_t type, bool streaming, run_stats_t *stats);
+
+
+static bool get_next(acc_service_handle_t handle, service_type_t type, bool *missed_data);
+
+
+static void print_stats(const char *name, const run_stats_t *stats);
+
+
+int acc_example_service_streaming(int argc, char *argv[]);
+
+
+int acc_example_service_streaming(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_hal_integration_get_implementation();
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	bool success = true;
+
+	for (service_type_t type = SERVICE_TYPE_SPARSE; success && type <= SERVICE_TYPE_ENVELOPE; type++)
+	{
+		acc_service_configuration_t configuration;
+
+		if (type == SERVICE_TYPE_SPARSE)
+		{
+			configuration = acc_service_sparse_configuration_create();
+		}
+		else
+		{
+			configuration = acc_service_envelope_configuration_create();
+		}
+
+		if (configuration == NULL)
+		{
+			printf("Failed to create service configuration\n");
+			success = false;
+			break;
+		}
+
+		acc_service_sensor_set(configuration, SENSOR_ID);
+
+		if (type == SERVICE_TYPE_SPARSE)
+		{
+			acc_service_requested_start_set(configuration, SPARSE_START_M);
+			acc_service_requested_length_set(configuration, SPARSE_LENGTH_M);
+			acc_service_sparse_configuration_sweeps_per_frame_set(configuration, SPARSE_SWEEPS_PER_FRAME);
+			acc_service_sparse_configuration_sweep_rate_set(configuration, SPARSE_SWEEP_RATE_HZ);
+		}
+		else
+		{
+			acc_service_requested_start_set(configuration, ENVELOPE_START_M);
+			acc_service_requested_length_set(configuration, ENVELOPE_LENGTH_M);
+		}
+
+		// Streaming mode requires asynchronous measurement
+		acc_service_asynchronous_measurement_set(configuration, true);
+
+		run_stats_t on_demand_stats = { 0 };
+		run_stats_t streaming_stats = { 0 };
+
+		success = run(configuration, type, false, &on_demand_stats) &&
+		          run(configuration, type, true, &streaming_stats);
+
+		if (success)
+		{
+			const char *name = (type == SERVICE_TYPE_SPARSE) ? "Sparse" : "Envelope";
+
+			printf("%s, %u frames at %u mHz\n", name, (unsigned int)FRAME_COUNT, (unsigned int)(UPDATE_RATE_HZ * 1000.0f));
+			print_stats("  on demand", &on_demand_stats);
+			print_stats("  streaming", &streaming_stats);
+		}
+
+		if (type == SERVICE_TYPE_SPARSE)
+		{
+			acc_service_sparse_configuration_destroy(&configuration);
+		}
+		else
+		{
+			acc_service_envelope_configuration_destroy(&configuration);
+		}
+	}
+
+	acc_rss_deactivate();
+
+	if (!success)
+	{
+		return EXIT_FAILURE;
+	}
+
+	printf("Application finished OK\n");
+
+	return EXIT_SUCCESS;
+}
+
+
+bool run(acc_service_configuration_t configuration, service_type_t type, bool streaming, run_stats_t *stats)
+{
+	if (streaming)
+	{
+		acc_service_repetition_mode_streaming_set(configuration, UPDATE_RATE_HZ);
+	}
+	else
+	{
+		acc_service_repetition_mode_on_demand_set(configuration);
+	}
+
+	acc_service_handle_t handle = acc_service_create(configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		return false;
+	}
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_service_destroy(&handle);
+		return false;
+	}
+
+	acc_frame_scheduler_t scheduler;
+
+	acc_frame_scheduler_init(&scheduler, UPDATE_RATE_HZ);
+
+	const uint32_t period_us     = (uint32_t)(1000000.0f / UPDATE_RATE_HZ);
+	bool           success       = true;
+	uint32_t       start_us      = acc_integration_get_time_us();
+	uint32_t       last_frame_us = 0;
+
+	for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		uint32_t wait_start_us = acc_integration_get_time_us();
+
+		if (!streaming)
+		{
+			acc_frame_scheduler_wait(&scheduler);
+		}
+
+		bool missed_data = false;
+
+		if (!get_next(handle, type, &missed_data))
+		{
+			printf("get_next() failed\n");
+			success = false;
+			break;
+		}
+
+		uint32_t frame_us = acc_integration_get_time_us();
+
+		stats->wait_us += frame_us - wait_start_us;
+
+		if (missed_data)
+		{
+			if (stats->missed_data < MISSED_DATA_PRINT_LIMIT)
+			{
+				printf("Missed data in frame %u\n", (unsigned int)frame);
+			}
+
+			stats->missed_data++;
+		}
+
+		if (frame > 0)
+		{
+			uint32_t interval_us = frame_us - last_frame_us;
+			uint32_t jitter_us   = (interval_us > period_us) ? interval_us - period_us : period_us - interval_us;
+
+			stats->total_jitter_us += jitter_us;
+			stats->max_jitter_us    = (jitter_us > stats->max_jitter_us) ? jitter_us : stats->max_jitter_us;
+
+			if (2 * interval_us > 3 * period_us)
+			{
+				stats->lost_frames++;
+			}
+		}
+
+		last_frame_us = frame_us;
+		stats->frames++;
+
+#if PROCESSING_TIME_MS > 0
+		while (acc_integration_get_time_us() - frame_us < PROCESSING_TIME_MS * 1000U)
+		{
+		}
+#endif
+	}
+
+	stats->total_us = acc_integration_get_time_us() - start_us;
+
+	if (!acc_service_deactivate(handle))
+	{
+		printf("acc_service_deactivate() failed\n");
+		success = false;
+	}
+
+	acc_service_destroy(&handle);
+
+	return success;
+}
+
+
+bool get_next(acc_service_handle_t handle, service_type_t type, bool *missed_data)
+{
+	uint16_t *data;
+	bool     success;
+
+	if (type == SERVICE_TYPE_SPARSE)
+	{
+		acc_service_sparse_result_info_t result_info;
+
+		success      = acc_service_sparse_get_next_by_reference(handle, &data, &result_info);
+		*missed_data = success && result_info.missed_data;
+	}
+	else
+	{
+		acc_service_envelope_result_info_t result_info;
+
+		success      = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
+		*missed_data = success && result_info.missed_data;
+	}
+
+	return success;
+}
+
+
+void print_stats(const char *name, const run_stats_t *stats)
+{
+	uint32_t intervals = (stats->frames > 1) ? stats->frames - 1 : 1;
+	uint32_t total_us  = (stats->total_us > 0) ? stats->total_us : 1;
+
+	printf("%s: jitter avg %u us, max %u us, missed data %u, lost frames %u, MCU awake %u per mille\n",
+	       name,
+	       (unsigned int)(stats->total_jitter_us / intervals),
+	       (unsigned int)stats->max_jitter_us,
+	       (unsigned int)stats->missed_data,
+	       (unsigned int)stats->lost_frames,
+	       (unsigned int)(((uint64_t)(total_us - stats->wait_us) * 1000) / total_us));
+}
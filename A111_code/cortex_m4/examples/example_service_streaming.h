@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_SERVICE_STREAMING_H_
+#define EXAMPLE_SERVICE_STREAMING_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Service streaming example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_service_streaming(int argc, char *argv[]);
+
+
+#endif
@@ -0,0 +1,305 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acc_hal_definitions.h"
+#include "acc_hal_integration.h"
+#include "acc_rss.h"
+#include "acc_service.h"
+#include "acc_service_envelope.h"
+#include "acc_service_sparse.h"
+#include "acc_time_budget.h"
+#include "acc_version.h"
+
+
+/** \example example_time_budget.c
+ * @brief This is an example on how the measurement time budget of a configuration is estimated
+ * @n
+ * The estimator is calibrated against frames measured with the stage profiler, one
+ * envelope and one sparse configuration run back to back in on demand mode without
+ * asynchronous measurement, so that each stage is measured separately. The calibrated
+ * model is then used to check the configurations of the distance and presence reference
+ * applications, and printed for script/time_budget.py.
+ * @n
+ * The example executes as follows:
+ *   - Activate Radar System Software (RSS) with the profiling HAL
+ *   - For an envelope and a sparse calibration configuration
+ *     - Print the nominal estimate
+ *     - Create and activate the service and measure a number of frames with the profiler
+ *     - Calibrate the model and print the calibrated estimate
+ *   - Print the calibrated estimates of the application configurations
+ *   - Print the calibrated model
+ *   - Deactivate Radar System Software (RSS)
+ */
+
+
+#define SENSOR_ID   1
+#define FRAME_COUNT 50
+
+#define CALIBRATION_ENVELOPE_LENGTH_M 1.0f
+#define CALIBRATION_SPARSE_LENGTH_M   1.2f
+#define CALIBRATION_SPARSE_SWEEPS     16
+#define CALIBRATION_HWAAS             16
+
+
+/**
+ * @brief An application configuration to check
+ */
+typedef struct
+{
+	const char                *name;
+	acc_time_budget_service_t service;
+	acc_service_profile_t     profile;
+	uint8_t                   hwaas;
+	float                     start_m;
+	float                     length_m;
+	uint16_t                  downsampling_factor;
+	uint16_t                  sweeps_per_frame;
+	float                     sweep_rate_hz;
+	float                     update_rate_hz;
+} application_t;
+
+
+static const application_t applications[] =
+{
+	{ "distance, tank level far range", ACC_TIME_BUDGET_SERVICE_ENVELOPE, ACC_SERVICE_PROFILE_2, 10, 0.19f, 1.3f,  4, 1,  0.0f,    10.0f },
+	{ "presence, wave to exit",         ACC_TIME_BUDGET_SERVICE_SPARSE,   ACC_SERVICE_PROFILE_2, 60, 0.12f, 0.18f, 1, 32, 0.0f,    80.0f },
+	{ "presence, smart presence",       ACC_TIME_BUDGET_SERVICE_SPARSE,   ACC_SERVICE_PROFILE_2, 10, 0.18f, 2.0f,  1, 16, 0.0f,    20.0f },
+};
+
+
+static acc_service_configuration_t configuration_create(acc_time_budget_service_t service);
+
+
+static void configuration_destroy(acc_time_budget_service_t service, acc_service_configuration_t *configuration);
+
+
+static bool calibrate(acc_time_budget_model_t *model, acc_time_budget_service_t service, uint32_t spi_clock_hz);
+
+
+static bool profile_frames(acc_service_configuration_t configuration, acc_time_budget_service_t service);
+
+
+int acc_example_time_budget(int argc, char *argv[]);
+
+
+int acc_example_time_budget(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("Acconeer software version %s\n", acc_version_get());
+
+	const acc_hal_t *hal = acc_time_budget_profiler_hal(acc_hal_integration_get_implementation());
+
+	if (!acc_rss_activate(hal))
+	{
+		printf("acc_rss_activate() failed\n");
+		return EXIT_FAILURE;
+	}
+
+	uint32_t                spi_clock_hz = acc_hal_integration_get_spi_clock_hz();
+	acc_time_budget_model_t model;
+
+	acc_time_budget_model_default(&model);
+
+	printf("SPI clock: %u Hz\n", (unsigned int)spi_clock_hz);
+
+	bool success = calibrate(&model, ACC_TIME_BUDGET_SERVICE_ENVELOPE, spi_clock_hz) &&
+	               calibrate(&model, ACC_TIME_BUDGET_SERVICE_SPARSE, spi_clock_hz);
+
+	acc_rss_deactivate();
+
+	if (!success)
+	{
+		return EXIT_FAILURE;
+	}
+
+	for (uint16_t i = 0; i < sizeof(applications) / sizeof(applications[0]); i++)
+	{
+		const application_t        *application = &applications[i];
+		acc_time_budget_input_t    input        = { 0 };
+		acc_time_budget_estimate_t estimate;
+
+		input.service             = application->service;
+		input.profile             = application->profile;
+		input.mur                 = ACC_SERVICE_MUR_DEFAULT;
+		input.hwaas               = application->hwaas;
+		input.start_m             = application->start_m;
+		input.length_m            = application->length_m;
+		input.downsampling_factor = application->downsampling_factor;
+		input.sweeps_per_frame    = application->sweeps_per_frame;
+		input.sweep_rate_hz       = application->sweep_rate_hz;
+		input.update_rate_hz      = application->update_rate_hz;
+		input.spi_clock_hz        = spi_clock_hz;
+
+		acc_time_budget_estimate(&model, &input, &estimate);
+
+		printf("%s at %u Hz\n", application->name, (unsigned int)application->update_rate_hz);
+		acc_time_budget_estimate_print(&estimate);
+	}
+
+	acc_time_budget_model_print(&model);
+
+	printf("Application finished OK\n");
+
+	return EXIT_SUCCESS;
+}
+
+
+acc_service_configuration_t configuration_create(acc_time_budget_service_t service)
+{
+	acc_service_configuration_t configuration;
+
+	if (service == ACC_TIME_BUDGET_SERVICE_SPARSE)
+	{
+		configuration = acc_service_sparse_configuration_create();
+
+		if (configuration != NULL)
+		{
+			acc_service_requested_length_set(configuration, CALIBRATION_SPARSE_LENGTH_M);
+			acc_service_sparse_configuration_sweeps_per_frame_set(configuration, CALIBRATION_SPARSE_SWEEPS);
+		}
+	}
+	else
+	{
+		configuration = acc_service_envelope_configuration_create();
+
+		if (configuration != NULL)
+		{
+			acc_service_requested_length_set(configuration, CALIBRATION_ENVELOPE_LENGTH_M);
+		}
+	}
+
+	if (configuration != NULL)
+	{
+		acc_service_sensor_set(configuration, SENSOR_ID);
+		acc_service_hw_accelerated_average_samples_set(configuration, CALIBRATION_HWAAS);
+
+		// Measure, read and process each frame in get_next so that the stages do not overlap
+		acc_service_asynchronous_measurement_set(configuration, false);
+	}
+
+	return configuration;
+}
+
+
+void configuration_destroy(acc_time_budget_service_t service, acc_service_configuration_t *configuration)
+{
+	if (service == ACC_TIME_BUDGET_SERVICE_SPARSE)
+	{
+		acc_service_sparse_configuration_destroy(configuration);
+	}
+	else
+	{
+		acc_service_envelope_configuration_destroy(configuration);
+	}
+}
+
+
+bool calibrate(acc_time_budget_model_t *model, acc_time_budget_service_t service, uint32_t spi_clock_hz)
+{
+	acc_service_configuration_t configuration = configuration_create(service);
+
+	if (configuration == NULL)
+	{
+		printf("Failed to create service configuration\n");
+		return false;
+	}
+
+	acc_time_budget_input_t       input;
+	acc_time_budget_estimate_t    estimate;
+	acc_time_budget_measurement_t measurement;
+
+	acc_time_budget_input_get(configuration, service, 0.0f, spi_clock_hz, &input);
+
+	printf("%s calibration, nominal\n", (service == ACC_TIME_BUDGET_SERVICE_SPARSE) ? "Sparse" : "Envelope");
+	acc_time_budget_estimate(model, &input, &estimate);
+	acc_time_budget_estimate_print(&estimate);
+
+	bool success = profile_frames(configuration, service);
+
+	configuration_destroy(service, &configuration);
+
+	if (!success)
+	{
+		return false;
+	}
+
+	acc_time_budget_profiler_get(&measurement);
+
+	printf("Measured, measure: %u us, spi: %u us, %u bytes, processing: %u us\n",
+	       (unsigned int)measurement.measure_us,
+	       (unsigned int)measurement.spi_us,
+	       (unsigned int)measurement.spi_bytes,
+	       (unsigned int)measurement.processing_us);
+
+	acc_time_budget_calibrate(model, &input, &measurement);
+
+	printf("Calibrated\n");
+	acc_time_budget_estimate(model, &input, &estimate);
+	acc_time_budget_estimate_print(&estimate);
+
+	return true;
+}
+
+
+bool profile_frames(acc_service_configuration_t configuration, acc_time_budget_service_t service)
+{
+	acc_service_handle_t handle = acc_service_create(configuration);
+
+	if (handle == NULL)
+	{
+		printf("acc_service_create() failed\n");
+		return false;
+	}
+
+	if (!acc_service_activate(handle))
+	{
+		printf("acc_service_activate() failed\n");
+		acc_service_destroy(&handle);
+		return false;
+	}
+
+	acc_time_budget_profiler_reset();
+
+	bool     success = true;
+	uint16_t *data;
+
+	for (uint32_t frame = 0; success && frame < FRAME_COUNT; frame++)
+	{
+		acc_time_budget_profiler_frame_begin();
+
+		if (service == ACC_TIME_BUDGET_SERVICE_SPARSE)
+		{
+			acc_service_sparse_result_info_t result_info;
+
+			success = acc_service_sparse_get_next_by_reference(handle, &data, &result_info);
+		}
+		else
+		{
+			acc_service_envelope_result_info_t result_info;
+
+			success = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
+		}
+
+		acc_time_budget_profiler_frame_end();
+	}
+
+	if (!success)
+	{
+		printf("get_next() failed\n");
+	}
+
+	success = acc_service_deactivate(handle) && success;
+
+	acc_service_destroy(&handle);
+
+	return success;
+}
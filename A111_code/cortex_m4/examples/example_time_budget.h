@@ -0,0 +1,17 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef EXAMPLE_TIME_BUDGET_H_
+#define EXAMPLE_TIME_BUDGET_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Measurement time budget example
+ *
+ * @return Returns EXIT_SUCCESS if successful, otherwise EXIT_FAILURE
+ */
+int acc_example_time_budget(int argc, char *argv[]);
+
+
+#endif
@@ -8,9 +8,9 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "acc_frame_scheduler.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
-#include "acc_integration.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_service_envelope.h"
@@ -57,6 +57,9 @@
 // The time duration between two consecutive sweeps
 #define DETECTOR_SWEEP_PERIOD_S 10.0f
 
+// Number of sweeps between printouts of the achieved sweep rate and jitter
+#define SCHEDULER_STATS_INTERVAL 30
+
 // Minimal envelope service runtime before sensor recalibration due to a data quality warning.
 // A sensor calibration is costly in terms of power consumption relative to the sweeps
 #define SERVICE_RUNTIME_MIN_S 900.0f
@@ -174,13 +177,15 @@ int acc_ref_app_parking(int argc, char *argv[])
 	acc_service_envelope_result_info_t result_info;
 	sweep_observable_t                 observations[DETECTION_OBSERVATION_COUNT];
 	uint16_t                           observation_count   = 0;
-	uint32_t                           last_update_ms      = 0;
+	acc_frame_scheduler_t              scheduler;
 	uint32_t                           last_activate_ms    = hal->os.gettime();
 	uint32_t                           last_calibration_ms = hal->os.gettime();
 	uint16_t                           sweep_index         = 0;
 
 	bool status = true;
 
+	acc_frame_scheduler_init(&scheduler, 1.0f / DETECTOR_SWEEP_PERIOD_S);
+
 	if (!valid_leak_setup)
 	{
 		printf("Parameters are not valid\n");
@@ -201,13 +206,9 @@ int acc_ref_app_parking(int argc, char *argv[])
 
 		if (status)
 		{
-			while (last_update_ms != 0 && hal->os.gettime() - last_update_ms < DETECTOR_SWEEP_PERIOD_S * 1000)
-			{
-				acc_integration_sleep_ms((DETECTOR_SWEEP_PERIOD_S * 1000) - (hal->os.gettime() - last_update_ms));
-			}
+			acc_frame_scheduler_wait(&scheduler);
 
-			status         = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
-			last_update_ms = hal->os.gettime();
+			status = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
 		}
 
 		if (status && result_info.data_quality_warning &&
@@ -238,8 +239,7 @@ int acc_ref_app_parking(int argc, char *argv[])
 
 			if (status)
 			{
-				status         = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
-				last_update_ms = hal->os.gettime();
+				status = acc_service_envelope_get_next_by_reference(handle, &data, &result_info);
 			}
 		}
 
@@ -257,6 +257,11 @@ int acc_ref_app_parking(int argc, char *argv[])
 			}
 
 			sweep_index++;
+
+			if (sweep_index % SCHEDULER_STATS_INTERVAL == 0)
+			{
+				acc_frame_scheduler_stats_print(&scheduler);
+			}
 		}
 	}
 
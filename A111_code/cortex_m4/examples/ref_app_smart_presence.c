@@ -11,9 +11,12 @@
 
 #include "acc_definitions_common.h"
 #include "acc_detector_presence.h"
+#include "acc_frame_scheduler.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
 #include "acc_integration.h"
+#include "acc_presence_engine.h"
+#include "acc_presence_zones.h"
 #include "acc_rss.h"
 #include "acc_version.h"
 
@@ -22,7 +25,8 @@
 #define DEFAULT_SENSOR_ID            (1)
 #define DEFAULT_START_M              (0.18f)
 #define DEFAULT_LENGTH_M             (2.00f)
-#define DEFAULT_ZONE_LENGTH          (0.4f)
+#define DEFAULT_ZONE_COUNT           (5)
+#define DEFAULT_ZONE_HOLD_MS         (1000)
 #define DEFAULT_UPDATE_RATE_WAKEUP   (2.0f)
 #define DEFAULT_UPDATE_RATE_TRACKING (20.0f)
 #define DEFAULT_THRESHOLD            (2.0f)
@@ -55,80 +59,34 @@ static void set_default_configuration(acc_detector_presence_configuration_t pres
 
 
 /**
- * @brief Use the presence detector to detect movement with low power
+ * @brief Print the distance and score of a detected motion and the zone scores
  *
- * @param[in] handle The presence detector handle
+ * @param[in] result The presence result
+ * @param[in] zones The presence zones
  */
-static bool execute_wakeup(acc_detector_presence_handle_t handle)
+static void print_motion(const acc_detector_presence_result_t *result, const acc_presence_zones_t *zones)
 {
-	acc_detector_presence_result_t result;
-
-	if (!acc_detector_presence_activate(handle))
-	{
-		printf("Failed to activate detector\n");
-		return false;
-	}
-
-	do
-	{
-		if (!acc_detector_presence_get_next(handle, &result))
-		{
-			printf("Failed to get data from sensor\n");
-			return false;
-		}
-
-		acc_integration_sleep_ms(1000 / DEFAULT_UPDATE_RATE_WAKEUP);
-	} while (!result.presence_detected);
-
-	uint32_t detected_zone = (uint32_t)((float)(result.presence_distance - DEFAULT_START_M) / (float)DEFAULT_ZONE_LENGTH);
-	printf("Motion in zone: %u, distance: %d, score: %d\n", (unsigned int)detected_zone, (int)(result.presence_distance * 1000.0f),
-	       (int)(result.presence_score * 1000.0f));
-
-	acc_detector_presence_deactivate(handle);
-
-	return true;
+	printf("Motion at distance: %d, score: %d\n", (int)(result->presence_distance * 1000.0f),
+	       (int)(result->presence_score * 1000.0f));
+	acc_presence_zones_print(zones);
 }
 
 
 /**
- * @brief Use the presence detector to track movement in front of the sensor
+ * @brief Print the transition latency to a stage
  *
- * @param[in] handle The presence detector handle
+ * @param[in] engine The presence engine
+ * @param[in] stage The stage transitioned to
  */
-static bool execute_movement_tracking(acc_detector_presence_handle_t handle)
+static void print_transition(const acc_presence_engine_t *engine, acc_presence_engine_stage_t stage)
 {
-	acc_detector_presence_result_t result;
-
-	if (!acc_detector_presence_activate(handle))
-	{
-		printf("Failed to activate detector\n");
-		return false;
-	}
-
-	do
-	{
-		if (!acc_detector_presence_get_next(handle, &result))
-		{
-			printf("Failed to get data from sensor\n");
-			return false;
-		}
-
-		if (result.presence_detected)
-		{
-			uint32_t detected_zone = (uint32_t)((float)(result.presence_distance - DEFAULT_START_M) / (float)DEFAULT_ZONE_LENGTH);
-			printf("Motion in zone: %u, distance: %d, score: %d\n", (unsigned int)detected_zone,
-			       (int)(result.presence_distance * 1000.0f),
-			       (int)(result.presence_score * 1000.0f));
-		}
-
-		acc_integration_sleep_ms(1000 / DEFAULT_UPDATE_RATE_TRACKING);
-	} while (result.presence_detected);
+	const acc_presence_engine_stats_t *stats = acc_presence_engine_stats_get(engine, stage);
 
-	printf("No motion, score: %d\n", (int)(result.presence_score * 1000.0f));
-
-	acc_detector_presence_deactivate(handle);
-
-	return true;
+	printf("%s after %u ms, avg %u ms, max %u ms\n",
+	       (stage == ACC_PRESENCE_ENGINE_STAGE_TRACKING) ? "Tracking" : "Wakeup",
+	       (unsigned int)stats->last_latency_ms,
+	       (unsigned int)((stats->transitions > 0) ? stats->total_latency_ms / stats->transitions : 0),
+	       (unsigned int)stats->max_latency_ms);
 }
 
 
@@ -149,67 +107,83 @@ int acc_ref_app_smart_presence(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
-	acc_detector_presence_configuration_t presence_configuration = acc_detector_presence_configuration_create();
-	if (presence_configuration == NULL)
+	acc_detector_presence_configuration_t wakeup_configuration   = acc_detector_presence_configuration_create();
+	acc_detector_presence_configuration_t tracking_configuration = acc_detector_presence_configuration_create();
+	if (wakeup_configuration == NULL || tracking_configuration == NULL)
 	{
 		printf("Failed to create configuration\n");
+		acc_detector_presence_configuration_destroy(&wakeup_configuration);
+		acc_detector_presence_configuration_destroy(&tracking_configuration);
 		acc_rss_deactivate();
 		return EXIT_FAILURE;
 	}
 
-	set_default_configuration(presence_configuration);
-	acc_detector_presence_configuration_power_save_mode_set(presence_configuration, ACC_POWER_SAVE_MODE_OFF);
+	set_default_configuration(wakeup_configuration);
+	acc_detector_presence_configuration_power_save_mode_set(wakeup_configuration, ACC_POWER_SAVE_MODE_OFF);
+
+	set_default_configuration(tracking_configuration);
+	acc_detector_presence_configuration_update_rate_set(tracking_configuration, DEFAULT_UPDATE_RATE_TRACKING);
+	acc_detector_presence_configuration_power_save_mode_set(tracking_configuration, ACC_POWER_SAVE_MODE_SLEEP);
+	acc_detector_presence_configuration_vector_output_mode_set(tracking_configuration, true);
 
-	acc_detector_presence_handle_t handle = acc_detector_presence_create(presence_configuration);
-	if (handle == NULL)
+	// The zones replace one single zone sensor each, from the score per distance of the tracking stage
+	acc_presence_zones_t zones;
+
+	acc_presence_zones_uniform_init(&zones, DEFAULT_START_M, DEFAULT_LENGTH_M, DEFAULT_ZONE_COUNT, DEFAULT_THRESHOLD);
+	acc_presence_zones_hold_time_set(&zones, DEFAULT_ZONE_HOLD_MS);
+
+	acc_presence_engine_t engine;
+
+	if (!acc_presence_engine_create(&engine, wakeup_configuration, tracking_configuration))
 	{
-		printf("Failed to create detector\n");
-		acc_detector_presence_configuration_destroy(&presence_configuration);
-		acc_detector_presence_destroy(&handle);
+		printf("Failed to create presence engine\n");
+		acc_detector_presence_configuration_destroy(&wakeup_configuration);
+		acc_detector_presence_configuration_destroy(&tracking_configuration);
 		acc_rss_deactivate();
 		return EXIT_FAILURE;
 	}
 
+	if (!engine.pre_created)
+	{
+		printf("Only one detector could be created, reconfiguring on every transition\n");
+	}
+
+	acc_detector_presence_result_t result;
+	acc_presence_engine_stage_t    stage;
+	float                          *vector;
+	uint16_t                       vector_length;
+	acc_presence_engine_stage_t    previous_stage = ACC_PRESENCE_ENGINE_STAGE_WAKEUP;
+
 	while (true)
 	{
-		if (!execute_wakeup(handle))
+		if (!acc_presence_engine_distance_point_vector_get_next(&engine, &vector_length, &vector, &result, &stage))
 		{
-			acc_detector_presence_configuration_destroy(&presence_configuration);
-			acc_detector_presence_destroy(&handle);
+			printf("Failed to get data from sensor\n");
+			acc_presence_engine_destroy(&engine);
+			acc_detector_presence_configuration_destroy(&wakeup_configuration);
+			acc_detector_presence_configuration_destroy(&tracking_configuration);
 			acc_rss_deactivate();
 			return EXIT_FAILURE;
 		}
 
-		acc_detector_presence_configuration_update_rate_set(presence_configuration, DEFAULT_UPDATE_RATE_TRACKING);
-		acc_detector_presence_configuration_power_save_mode_set(presence_configuration, ACC_POWER_SAVE_MODE_SLEEP);
+		// Without a vector, in the wakeup stage, the zone occupancies time out
+		acc_presence_zones_update(&zones, vector, vector_length, acc_integration_get_time());
 
-		if (!acc_detector_presence_reconfigure(&handle, presence_configuration))
+		if (stage != previous_stage)
 		{
-			printf("Failed to reconfigure detector\n");
-			acc_detector_presence_configuration_destroy(&presence_configuration);
-			acc_detector_presence_destroy(&handle);
-			acc_rss_deactivate();
-			return EXIT_FAILURE;
+			print_transition(&engine, stage);
+			previous_stage = stage;
 		}
 
-		if (!execute_movement_tracking(handle))
+		if (result.presence_detected)
 		{
-			acc_detector_presence_configuration_destroy(&presence_configuration);
-			acc_detector_presence_destroy(&handle);
-			acc_rss_deactivate();
-			return EXIT_FAILURE;
+			print_motion(&result, &zones);
 		}
-
-		acc_detector_presence_configuration_update_rate_set(presence_configuration, DEFAULT_UPDATE_RATE_WAKEUP);
-		acc_detector_presence_configuration_power_save_mode_set(presence_configuration, ACC_POWER_SAVE_MODE_OFF);
-
-		if (!acc_detector_presence_reconfigure(&handle, presence_configuration))
+		else if (stage == ACC_PRESENCE_ENGINE_STAGE_TRACKING)
 		{
-			printf("Failed to reconfigure detector\n");
-			acc_detector_presence_configuration_destroy(&presence_configuration);
-			acc_detector_presence_destroy(&handle);
-			acc_rss_deactivate();
-			return EXIT_FAILURE;
+			printf("No motion, score: %d\n", (int)(result.presence_score * 1000.0f));
+			acc_presence_zones_print(&zones);
+			acc_frame_scheduler_stats_print(&engine.scheduler);
 		}
 	}
 
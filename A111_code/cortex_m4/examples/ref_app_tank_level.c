@@ -10,9 +10,12 @@
 
 #include "acc_definitions_common.h"
 #include "acc_detector_distance.h"
+#include "acc_gain_controller.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
+#include "acc_integration.h"
 #include "acc_integration_log.h"
+#include "acc_preset.h"
 #include "acc_rss.h"
 #include "acc_version.h"
 
@@ -24,55 +27,98 @@
 // See API documentation for more information of respective parameter
 #define DEFAULT_SENSOR 1
 
-#define DEFAULT_CLOSE_RANGE_MUR                      ACC_SERVICE_MUR_6
-#define DEFAULT_CLOSE_RANGE_START                    -0.11f
-#define DEFAULT_CLOSE_RANGE_LENGTH                   0.23f
-#define DEFAULT_CLOSE_RANGE_GAIN                     0.3182f
-#define DEFAULT_CLOSE_MAXIMIZE_SIGNAL_ATTENUATION    true
-#define DEFAULT_CLOSE_RANGE_SERVICE_PROFILE          ACC_SERVICE_PROFILE_1
-#define DEFAULT_CLOSE_RANGE_DOWNSAMPLIG_FACTOR       1
-#define DEFAULT_CLOSE_RANGE_SWEEP_AVERAGING          30
-#define DEFAULT_CLOSE_RANGE_THRESHOLD_TYPE           ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_RECORDED
-#define DEFAULT_CLOSE_RANGE_RECORD_BACKGROUND_SWEEPS 30
-#define DEFAULT_CLOSE_RANGE_THRESHOLD_SENSITIVITY    0.2f
-
-#define DEFAULT_MID_RANGE_MUR                      ACC_SERVICE_MUR_6
-#define DEFAULT_MID_RANGE_START                    0.1f
-#define DEFAULT_MID_RANGE_LENGTH                   0.37f
-#define DEFAULT_MID_RANGE_GAIN                     0.5f
-#define DEFAULT_MID_MAXIMIZE_SIGNAL_ATTENUATION    false
-#define DEFAULT_MID_RANGE_SERVICE_PROFILE          ACC_SERVICE_PROFILE_1
-#define DEFAULT_MID_RANGE_DOWNSAMPLING_FACTOR      1
-#define DEFAULT_MID_RANGE_SWEEP_AVERAGING          30
-#define DEFAULT_MID_RANGE_THRESHOLD_TYPE           ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_RECORDED
-#define DEFAULT_MID_RANGE_RECORD_BACKGROUND_SWEEPS 30
-#define DEFAULT_MID_RANGE_THRESHOLD_SENSITIVITY    0.2f
-
-#define DEFAULT_FAR_RANGE_MUR                   ACC_SERVICE_MUR_6
-#define DEFAULT_FAR_RANGE_START                 0.19f
-#define DEFAULT_FAR_RANGE_LENGTH                1.3f
-#define DEFAULT_FAR_RANGE_GAIN                  0.8182f
-#define DEFAULT_FAR_MAXIMIZE_SIGNAL_ATTENUATION false
-#define DEFAULT_FAR_RANGE_SERVICE_PROFILE       ACC_SERVICE_PROFILE_2
-#define DEFAULT_FAR_RANGE_DOWNSAMPLING_FACTOR   4
-#define DEFAULT_FAR_RANGE_SWEEP_AVERAGING       10
-#define DEFAULT_FAR_RANGE_THRESHOLD_TYPE        ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_CFAR
-#define DEFAULT_FAR_RANGE_THRESHOLD_SENSITIVITY 0.4f
-#define DEFAULT_FAR_RANGE_CFAR_THRESHOLD_GUARD  0.12f
-#define DEFAULT_FAR_RANGE_CFAR_THRESHOLD_WINDOW 0.03f
-
-// Gain can be configured in 22 steps between 0.0 and 1.0
-#define GAIN_STEP             (1.0f / 22.0f)
+// Receiver gain for a sector preset without a gain entry
+#define DEFAULT_GAIN 0.5f
+
+
+// The sector presets are applied to the same configuration one after the other, so each
+// preset sets every parameter that differs between the sectors
+static const acc_preset_entry_t close_range_entries[] =
+{
+	ACC_PRESET_INT(ACC_PRESET_MUR, ACC_SERVICE_MUR_6),
+	ACC_PRESET_FLOAT(ACC_PRESET_START_M, -0.11f),
+	ACC_PRESET_FLOAT(ACC_PRESET_LENGTH_M, 0.23f),
+	ACC_PRESET_FLOAT(ACC_PRESET_RECEIVER_GAIN, 0.3182f),
+	ACC_PRESET_INT(ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION, true),
+	ACC_PRESET_INT(ACC_PRESET_PROFILE, ACC_SERVICE_PROFILE_1),
+	ACC_PRESET_INT(ACC_PRESET_DOWNSAMPLING_FACTOR, 1),
+	ACC_PRESET_INT(ACC_PRESET_SWEEP_AVERAGING, 30),
+	ACC_PRESET_INT(ACC_PRESET_THRESHOLD_TYPE, ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_RECORDED),
+	ACC_PRESET_INT(ACC_PRESET_RECORD_BACKGROUND_SWEEPS, 30),
+	ACC_PRESET_FLOAT(ACC_PRESET_THRESHOLD_SENSITIVITY, 0.2f),
+};
+
+static const acc_preset_entry_t mid_range_entries[] =
+{
+	ACC_PRESET_INT(ACC_PRESET_MUR, ACC_SERVICE_MUR_6),
+	ACC_PRESET_FLOAT(ACC_PRESET_START_M, 0.1f),
+	ACC_PRESET_FLOAT(ACC_PRESET_LENGTH_M, 0.37f),
+	ACC_PRESET_FLOAT(ACC_PRESET_RECEIVER_GAIN, 0.5f),
+	ACC_PRESET_INT(ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION, false),
+	ACC_PRESET_INT(ACC_PRESET_PROFILE, ACC_SERVICE_PROFILE_1),
+	ACC_PRESET_INT(ACC_PRESET_DOWNSAMPLING_FACTOR, 1),
+	ACC_PRESET_INT(ACC_PRESET_SWEEP_AVERAGING, 30),
+	ACC_PRESET_INT(ACC_PRESET_THRESHOLD_TYPE, ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_RECORDED),
+	ACC_PRESET_INT(ACC_PRESET_RECORD_BACKGROUND_SWEEPS, 30),
+	ACC_PRESET_FLOAT(ACC_PRESET_THRESHOLD_SENSITIVITY, 0.2f),
+};
+
+static const acc_preset_entry_t far_range_entries[] =
+{
+	ACC_PRESET_INT(ACC_PRESET_MUR, ACC_SERVICE_MUR_6),
+	ACC_PRESET_FLOAT(ACC_PRESET_START_M, 0.19f),
+	ACC_PRESET_FLOAT(ACC_PRESET_LENGTH_M, 1.3f),
+	ACC_PRESET_FLOAT(ACC_PRESET_RECEIVER_GAIN, 0.8182f),
+	ACC_PRESET_INT(ACC_PRESET_MAXIMIZE_SIGNAL_ATTENUATION, false),
+	ACC_PRESET_INT(ACC_PRESET_PROFILE, ACC_SERVICE_PROFILE_2),
+	ACC_PRESET_INT(ACC_PRESET_DOWNSAMPLING_FACTOR, 4),
+	ACC_PRESET_INT(ACC_PRESET_SWEEP_AVERAGING, 10),
+	ACC_PRESET_INT(ACC_PRESET_THRESHOLD_TYPE, ACC_DETECTOR_DISTANCE_THRESHOLD_TYPE_CFAR),
+	ACC_PRESET_FLOAT(ACC_PRESET_THRESHOLD_SENSITIVITY, 0.4f),
+	ACC_PRESET_FLOAT(ACC_PRESET_CFAR_GUARD_M, 0.12f),
+	ACC_PRESET_FLOAT(ACC_PRESET_CFAR_WINDOW_M, 0.03f),
+};
+
+static const acc_preset_t close_range_preset =
+{
+	"close range", ACC_PRESET_TARGET_DETECTOR_DISTANCE, close_range_entries, ACC_PRESET_ENTRY_COUNT(close_range_entries)
+};
+
+static const acc_preset_t mid_range_preset =
+{
+	"mid range", ACC_PRESET_TARGET_DETECTOR_DISTANCE, mid_range_entries, ACC_PRESET_ENTRY_COUNT(mid_range_entries)
+};
+
+static const acc_preset_t far_range_preset =
+{
+	"far range", ACC_PRESET_TARGET_DETECTOR_DISTANCE, far_range_entries, ACC_PRESET_ENTRY_COUNT(far_range_entries)
+};
+
 #define MAX_BACKGROUND_LENGTH 1200
 
 
-static uint16_t close_background[MAX_BACKGROUND_LENGTH];
+/**
+ * The gain of each sector is lowered by the gain controllers on data saturation. Only the
+ * saturation indication is used, so the gain never goes above the gain used when the
+ * background was recorded. Each measurement starts from the gain of the background, or
+ * the preset gain for the far range sector, so a lowered gain is not kept.
+ */
+static acc_gain_controller_t close_gain_controller;
+static acc_gain_controller_t mid_gain_controller;
+static acc_gain_controller_t far_gain_controller;
+
+static ACC_INTEGRATION_RAM2_DATA uint16_t close_background[MAX_BACKGROUND_LENGTH];
 static uint16_t close_background_length;
-static float    close_range_gain = DEFAULT_CLOSE_RANGE_GAIN;
+static float    close_background_gain;
 
-static uint16_t mid_background[MAX_BACKGROUND_LENGTH];
+static ACC_INTEGRATION_RAM2_DATA uint16_t mid_background[MAX_BACKGROUND_LENGTH];
 static uint16_t mid_background_length;
-static float    mid_range_gain = DEFAULT_MID_RANGE_GAIN;
+static float    mid_background_gain;
+
+/**
+ * The checksum of the preset and gain the detector was last reconfigured with
+ */
+static acc_preset_state_t distance_preset_state;
 
 
 /**
@@ -84,60 +130,68 @@ static bool sensor_calibration(void);
 
 
 /**
- * Configure distance detector to measure in the close range sector
+ * Get the receiver gain of a sector preset
  *
- * @param distance_handle Distance Detector handle
- * @param distance_configuration Distance Detector configuration
- * @return True, if configuration was successful
+ * @param preset The sector preset
+ * @return The receiver gain
  */
-static bool configure_close_range(acc_detector_distance_handle_t        *distance_handle,
-                                  acc_detector_distance_configuration_t distance_configuration);
+static float preset_gain(const acc_preset_t *preset);
 
 
 /**
- * Configure distance detector to measure in the mid range sector
+ * Restart a gain controller at a gain, which is also the highest gain it will use
  *
- * @param distance_handle Distance Detector handle
- * @param distance_configuration Distance Detector configuration
- * @return True, if configuration was successful
+ * @param gain_controller Gain controller of the sector
+ * @param gain The gain
  */
-static bool configure_mid_range(acc_detector_distance_handle_t        *distance_handle,
-                                acc_detector_distance_configuration_t distance_configuration);
+static void gain_controller_reset(acc_gain_controller_t *gain_controller, float gain);
 
 
 /**
- * Configure distance detector to measure in the far range sector
+ * Configure distance detector to measure in a sector
+ *
+ * The detector is only reconfigured if the preset or the gain of the gain controller
+ * changed since the last reconfiguration.
  *
  * @param distance_handle Distance Detector handle
  * @param distance_configuration Distance Detector configuration
+ * @param preset The sector preset
+ * @param gain_controller Gain controller of the sector
  * @return True, if configuration was successful
  */
-static bool configure_far_range(acc_detector_distance_handle_t        *distance_handle,
-                                acc_detector_distance_configuration_t distance_configuration);
+static bool configure_sector(acc_detector_distance_handle_t        *distance_handle,
+                             acc_detector_distance_configuration_t distance_configuration,
+                             const acc_preset_t                    *preset,
+                             const acc_gain_controller_t           *gain_controller);
 
 
 /**
  * Record the background for specific configuration
  *
- * This function will set the requested gain, but the gain will be lowered in case of data saturation.
+ * This function will set the gain of the gain controller, but the gain will be lowered in case of data saturation.
+ * The background is recorded one gain step below the highest gain without data saturation,
+ * as a margin for measurements with objects in the sector.
  *
  * @param distance_handle Distance Detector handle
  * @param distance_configuration Distance Detector configuration
- * @param range_gain The gain actually used
+ * @param preset The sector preset
+ * @param gain_controller Gain controller of the sector
  * @param background Array to store background in
  * @param background_length Length of background array
+ * @param background_gain The gain the background was recorded with
  * @return True, if recording was successful
  */
 static bool record_background(acc_detector_distance_handle_t *distance_handle,
-                              acc_detector_distance_configuration_t distance_configuration,
-                              float *range_gain, uint16_t *background, uint16_t background_length);
+                              acc_detector_distance_configuration_t distance_configuration, const acc_preset_t *preset,
+                              acc_gain_controller_t *gain_controller, uint16_t *background, uint16_t background_length,
+                              float *background_gain);
 
 
 /**
  * Record background threshold for close and mid range sector
  *
  * Make sure no object is within these two sectors, i.e. no objects closer
- * to the sensor than DEFAULT_MID_RANGE_START + DEFAULT_MID_RANGE_LENGTH
+ * to the sensor than the end of the mid range sector
  *
  * @param distance_handle Distance Detector handle
  * @param distance_configuration Distance Detector configuration
@@ -150,15 +204,19 @@ static bool record_backgrounds(acc_detector_distance_handle_t        *distance_h
 /**
  * Perform one measurement
  *
- * This function will set the requested gain, but the gain will be lowered in case of data saturation.
+ * This function will use the gain of the gain controller, but the gain will be lowered in case of data saturation.
  *
  * @param distance_handle Distance Detector handle
  * @param distance_configuration Distance Detector configuration
+ * @param preset The sector preset
+ * @param gain_controller Gain controller of the sector
  * @param result Distance Detector result
  * @param result_info Distance Detector result info
  */
 static bool measurement(acc_detector_distance_handle_t        *distance_handle,
                         acc_detector_distance_configuration_t distance_configuration,
+                        const acc_preset_t                    *preset,
+                        acc_gain_controller_t                 *gain_controller,
                         acc_detector_distance_result_t        *result,
                         acc_detector_distance_result_info_t   *result_info);
 
@@ -214,6 +272,10 @@ int acc_ref_app_tank_level(int argc, char *argv[])
 	(void)argv;
 	ACC_LOG_INFO("Acconeer software version %s", acc_version_get());
 
+	acc_gain_controller_init(&close_gain_controller, preset_gain(&close_range_preset), 0);
+	acc_gain_controller_init(&mid_gain_controller, preset_gain(&mid_range_preset), 0);
+	acc_gain_controller_init(&far_gain_controller, preset_gain(&far_range_preset), 0);
+
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
 	if (!acc_rss_activate(hal))
@@ -263,6 +325,7 @@ int acc_ref_app_tank_level(int argc, char *argv[])
 	}
 
 	distance_handle = acc_detector_distance_create(distance_configuration);
+	acc_preset_state_invalidate(&distance_preset_state);
 
 	bool status = true;
 
@@ -291,6 +354,9 @@ int acc_ref_app_tank_level(int argc, char *argv[])
 			break;
 		}
 
+		ACC_LOG_DEBUG("Reconfigurations: %u, skipped: %u", (unsigned int)distance_preset_state.applied,
+		              (unsigned int)distance_preset_state.skipped);
+
 		if (distance_detected)
 		{
 			ACC_LOG_INFO("Peak at %u mm", (unsigned int)(distance * 1000));
@@ -329,117 +395,84 @@ bool sensor_calibration(void)
 }
 
 
-bool configure_close_range(acc_detector_distance_handle_t        *distance_handle,
-                           acc_detector_distance_configuration_t distance_configuration)
+float preset_gain(const acc_preset_t *preset)
 {
-	acc_detector_distance_configuration_mur_set(distance_configuration, DEFAULT_CLOSE_RANGE_MUR);
-	acc_detector_distance_configuration_requested_start_set(distance_configuration, DEFAULT_CLOSE_RANGE_START);
-	acc_detector_distance_configuration_requested_length_set(distance_configuration, DEFAULT_CLOSE_RANGE_LENGTH);
-	acc_detector_distance_configuration_receiver_gain_set(distance_configuration, close_range_gain);
-	acc_detector_distance_configuration_maximize_signal_attenuation_set(distance_configuration,
-	                                                                    DEFAULT_CLOSE_MAXIMIZE_SIGNAL_ATTENUATION);
-	acc_detector_distance_configuration_service_profile_set(distance_configuration,
-	                                                        DEFAULT_CLOSE_RANGE_SERVICE_PROFILE);
-	acc_detector_distance_configuration_downsampling_factor_set(distance_configuration,
-	                                                            DEFAULT_CLOSE_RANGE_DOWNSAMPLIG_FACTOR);
-	acc_detector_distance_configuration_sweep_averaging_set(distance_configuration,
-	                                                        DEFAULT_CLOSE_RANGE_SWEEP_AVERAGING);
-	acc_detector_distance_configuration_threshold_type_set(distance_configuration,
-	                                                       DEFAULT_CLOSE_RANGE_THRESHOLD_TYPE);
-	acc_detector_distance_configuration_record_background_sweeps_set(distance_configuration,
-	                                                                 DEFAULT_CLOSE_RANGE_RECORD_BACKGROUND_SWEEPS);
-	acc_detector_distance_configuration_threshold_sensitivity_set(distance_configuration,
-	                                                              DEFAULT_CLOSE_RANGE_THRESHOLD_SENSITIVITY);
-
-	return acc_detector_distance_reconfigure(distance_handle, distance_configuration);
+	acc_preset_value_t gain;
+
+	return acc_preset_value_get(preset, ACC_PRESET_RECEIVER_GAIN, &gain) ? gain.f : DEFAULT_GAIN;
 }
 
 
-bool configure_mid_range(acc_detector_distance_handle_t        *distance_handle,
-                         acc_detector_distance_configuration_t distance_configuration)
+void gain_controller_reset(acc_gain_controller_t *gain_controller, float gain)
 {
-	acc_detector_distance_configuration_mur_set(distance_configuration, DEFAULT_MID_RANGE_MUR);
-	acc_detector_distance_configuration_requested_start_set(distance_configuration, DEFAULT_MID_RANGE_START);
-	acc_detector_distance_configuration_requested_length_set(distance_configuration, DEFAULT_MID_RANGE_LENGTH);
-	acc_detector_distance_configuration_receiver_gain_set(distance_configuration, mid_range_gain);
-	acc_detector_distance_configuration_maximize_signal_attenuation_set(distance_configuration,
-	                                                                    DEFAULT_MID_MAXIMIZE_SIGNAL_ATTENUATION);
-	acc_detector_distance_configuration_service_profile_set(distance_configuration,
-	                                                        DEFAULT_MID_RANGE_SERVICE_PROFILE);
-	acc_detector_distance_configuration_downsampling_factor_set(distance_configuration,
-	                                                            DEFAULT_MID_RANGE_DOWNSAMPLING_FACTOR);
-	acc_detector_distance_configuration_sweep_averaging_set(distance_configuration,
-	                                                        DEFAULT_MID_RANGE_SWEEP_AVERAGING);
-	acc_detector_distance_configuration_threshold_type_set(distance_configuration,
-	                                                       DEFAULT_MID_RANGE_THRESHOLD_TYPE);
-	acc_detector_distance_configuration_record_background_sweeps_set(distance_configuration,
-	                                                                 DEFAULT_MID_RANGE_RECORD_BACKGROUND_SWEEPS);
-	acc_detector_distance_configuration_threshold_sensitivity_set(distance_configuration,
-	                                                              DEFAULT_MID_RANGE_THRESHOLD_SENSITIVITY);
-
-	return acc_detector_distance_reconfigure(distance_handle, distance_configuration);
+	acc_gain_controller_init(gain_controller, gain, 0);
+	acc_gain_controller_limits_set(gain_controller, 1.0f / ACC_GAIN_CONTROLLER_STEPS, gain);
 }
 
 
-bool configure_far_range(acc_detector_distance_handle_t        *distance_handle,
-                         acc_detector_distance_configuration_t distance_configuration)
+bool configure_sector(acc_detector_distance_handle_t        *distance_handle,
+                      acc_detector_distance_configuration_t distance_configuration,
+                      const acc_preset_t                    *preset,
+                      const acc_gain_controller_t           *gain_controller)
 {
-	acc_detector_distance_configuration_mur_set(distance_configuration, DEFAULT_FAR_RANGE_MUR);
-	acc_detector_distance_configuration_requested_start_set(distance_configuration, DEFAULT_FAR_RANGE_START);
-	acc_detector_distance_configuration_requested_length_set(distance_configuration, DEFAULT_FAR_RANGE_LENGTH);
-	acc_detector_distance_configuration_receiver_gain_set(distance_configuration, DEFAULT_FAR_RANGE_GAIN);
-	acc_detector_distance_configuration_maximize_signal_attenuation_set(distance_configuration,
-	                                                                    DEFAULT_FAR_MAXIMIZE_SIGNAL_ATTENUATION);
-	acc_detector_distance_configuration_service_profile_set(distance_configuration,
-	                                                        DEFAULT_FAR_RANGE_SERVICE_PROFILE);
-	acc_detector_distance_configuration_downsampling_factor_set(distance_configuration,
-	                                                            DEFAULT_FAR_RANGE_DOWNSAMPLING_FACTOR);
-	acc_detector_distance_configuration_sweep_averaging_set(distance_configuration,
-	                                                        DEFAULT_FAR_RANGE_SWEEP_AVERAGING);
-	acc_detector_distance_configuration_threshold_type_set(distance_configuration,
-	                                                       DEFAULT_FAR_RANGE_THRESHOLD_TYPE);
-	acc_detector_distance_configuration_threshold_sensitivity_set(distance_configuration,
-	                                                              DEFAULT_FAR_RANGE_THRESHOLD_SENSITIVITY);
-	acc_detector_distance_configuration_cfar_threshold_guard_set(distance_configuration,
-	                                                             DEFAULT_FAR_RANGE_CFAR_THRESHOLD_GUARD);
-	acc_detector_distance_configuration_cfar_threshold_window_set(distance_configuration,
-	                                                              DEFAULT_FAR_RANGE_CFAR_THRESHOLD_WINDOW);
-
-	return acc_detector_distance_reconfigure(distance_handle, distance_configuration);
+	float    gain     = acc_gain_controller_gain_get(gain_controller);
+	uint32_t checksum = acc_preset_checksum(preset, &gain, sizeof(gain));
+
+	if (!acc_preset_changed(&distance_preset_state, checksum))
+	{
+		return true;
+	}
+
+	acc_preset_apply(preset, distance_configuration);
+	acc_gain_controller_distance_apply(gain_controller, distance_configuration);
+
+	// A failed reconfigure leaves the detector in an unknown configuration
+	acc_preset_state_invalidate(&distance_preset_state);
+
+	if (!acc_detector_distance_reconfigure(distance_handle, distance_configuration))
+	{
+		return false;
+	}
+
+	acc_preset_state_set(&distance_preset_state, checksum);
+
+	return true;
 }
 
 
 bool record_background(acc_detector_distance_handle_t *distance_handle,
-                       acc_detector_distance_configuration_t distance_configuration,
-                       float *range_gain, uint16_t *background, uint16_t background_length)
+                       acc_detector_distance_configuration_t distance_configuration, const acc_preset_t *preset,
+                       acc_gain_controller_t *gain_controller, uint16_t *background, uint16_t background_length,
+                       float *background_gain)
 {
 	acc_detector_distance_recorded_background_info_t recorded_background_info;
-	bool                                             status                  = true;
-	bool                                             previous_gain_saturated = true;
+	bool                                             status;
 
-	float gain = acc_detector_distance_configuration_receiver_gain_get(distance_configuration);
-
-	recorded_background_info.data_saturated = true;
-
-	while (status && gain > 0)
+	do
 	{
-		acc_detector_distance_configuration_receiver_gain_set(distance_configuration, gain);
-
-		status = acc_detector_distance_reconfigure(distance_handle, distance_configuration);
+		status = configure_sector(distance_handle, distance_configuration, preset, gain_controller);
 
 		if (status)
 		{
 			status = acc_detector_distance_record_background(*distance_handle, background, background_length,
 			                                                 &recorded_background_info);
+		}
+	} while (status && acc_gain_controller_update(gain_controller, recorded_background_info.data_saturated, 0));
+
+	const float gain_step   = 1.0f / ACC_GAIN_CONTROLLER_STEPS;
+	float       margin_gain = acc_gain_controller_gain_get(gain_controller) - gain_step;
 
-			if (!status || (!previous_gain_saturated && !recorded_background_info.data_saturated))
-			{
-				break;
-			}
+	// The lowest gain step is kept, a gain of 0.0 gives no usable signal
+	if (status && !recorded_background_info.data_saturated && margin_gain > gain_step / 2.0f)
+	{
+		gain_controller_reset(gain_controller, margin_gain);
 
-			previous_gain_saturated = recorded_background_info.data_saturated;
+		status = configure_sector(distance_handle, distance_configuration, preset, gain_controller);
 
-			gain = gain - GAIN_STEP;
+		if (status)
+		{
+			status = acc_detector_distance_record_background(*distance_handle, background, background_length,
+			                                                 &recorded_background_info);
 		}
 	}
 
@@ -449,7 +482,7 @@ bool record_background(acc_detector_distance_handle_t *distance_handle,
 		status = false;
 	}
 
-	*range_gain = gain;
+	*background_gain = acc_gain_controller_gain_get(gain_controller);
 
 	return status;
 }
@@ -460,7 +493,7 @@ bool record_backgrounds(acc_detector_distance_handle_t        *distance_handle,
 {
 	acc_detector_distance_metadata_t metadata;
 
-	if (!configure_close_range(distance_handle, distance_configuration))
+	if (!configure_sector(distance_handle, distance_configuration, &close_range_preset, &close_gain_controller))
 	{
 		return false;
 	}
@@ -473,13 +506,13 @@ bool record_backgrounds(acc_detector_distance_handle_t        *distance_handle,
 	close_background_length = metadata.background_length;
 	ACC_LOG_INFO("Record close range");
 
-	if (!record_background(distance_handle, distance_configuration, &close_range_gain,
-	                       close_background, close_background_length))
+	if (!record_background(distance_handle, distance_configuration, &close_range_preset, &close_gain_controller,
+	                       close_background, close_background_length, &close_background_gain))
 	{
 		return false;
 	}
 
-	if (!configure_mid_range(distance_handle, distance_configuration))
+	if (!configure_sector(distance_handle, distance_configuration, &mid_range_preset, &mid_gain_controller))
 	{
 		return false;
 	}
@@ -492,8 +525,8 @@ bool record_backgrounds(acc_detector_distance_handle_t        *distance_handle,
 	mid_background_length = metadata.background_length;
 	ACC_LOG_INFO("Record mid range");
 
-	if (!record_background(distance_handle, distance_configuration, &mid_range_gain,
-	                       mid_background, mid_background_length))
+	if (!record_background(distance_handle, distance_configuration, &mid_range_preset, &mid_gain_controller,
+	                       mid_background, mid_background_length, &mid_background_gain))
 	{
 		return false;
 	}
@@ -504,14 +537,12 @@ bool record_backgrounds(acc_detector_distance_handle_t        *distance_handle,
 
 bool measurement(acc_detector_distance_handle_t        *distance_handle,
                  acc_detector_distance_configuration_t distance_configuration,
+                 const acc_preset_t                    *preset,
+                 acc_gain_controller_t                 *gain_controller,
                  acc_detector_distance_result_t        *result,
                  acc_detector_distance_result_info_t   *result_info)
 {
-	float gain = acc_detector_distance_configuration_receiver_gain_get(distance_configuration);
-
-	result_info->data_saturated = true;
-
-	while (gain > 0)
+	while (true)
 	{
 		if (!acc_detector_distance_activate(*distance_handle))
 		{
@@ -531,16 +562,12 @@ bool measurement(acc_detector_distance_handle_t        *distance_handle,
 			return false;
 		}
 
-		if (!result_info->data_saturated || gain < GAIN_STEP)
+		if (!acc_gain_controller_update(gain_controller, result_info->data_saturated, 0))
 		{
 			break;
 		}
 
-		gain = gain - GAIN_STEP;
-
-		acc_detector_distance_configuration_receiver_gain_set(distance_configuration, gain);
-
-		if (!acc_detector_distance_reconfigure(distance_handle, distance_configuration))
+		if (!configure_sector(distance_handle, distance_configuration, preset, gain_controller))
 		{
 			return false;
 		}
@@ -564,7 +591,9 @@ bool measure_close_range(acc_detector_distance_handle_t *distance_handle,
 	acc_detector_distance_result_info_t result_info;
 	acc_detector_distance_result_t      result;
 
-	if (!configure_close_range(distance_handle, distance_configuration))
+	gain_controller_reset(&close_gain_controller, close_background_gain);
+
+	if (!configure_sector(distance_handle, distance_configuration, &close_range_preset, &close_gain_controller))
 	{
 		return false;
 	}
@@ -574,7 +603,7 @@ bool measure_close_range(acc_detector_distance_handle_t *distance_handle,
 		return false;
 	}
 
-	if (!measurement(distance_handle, distance_configuration, &result, &result_info))
+	if (!measurement(distance_handle, distance_configuration, &close_range_preset, &close_gain_controller, &result, &result_info))
 	{
 		return false;
 	}
@@ -597,7 +626,9 @@ bool measure_mid_range(acc_detector_distance_handle_t *distance_handle,
 	acc_detector_distance_result_info_t result_info;
 	acc_detector_distance_result_t      result;
 
-	if (!configure_mid_range(distance_handle, distance_configuration))
+	gain_controller_reset(&mid_gain_controller, mid_background_gain);
+
+	if (!configure_sector(distance_handle, distance_configuration, &mid_range_preset, &mid_gain_controller))
 	{
 		return false;
 	}
@@ -607,7 +638,7 @@ bool measure_mid_range(acc_detector_distance_handle_t *distance_handle,
 		return false;
 	}
 
-	if (!measurement(distance_handle, distance_configuration, &result, &result_info))
+	if (!measurement(distance_handle, distance_configuration, &mid_range_preset, &mid_gain_controller, &result, &result_info))
 	{
 		return false;
 	}
@@ -630,12 +661,14 @@ bool measure_far_range(acc_detector_distance_handle_t *distance_handle,
 	acc_detector_distance_result_info_t result_info;
 	acc_detector_distance_result_t      result;
 
-	if (!configure_far_range(distance_handle, distance_configuration))
+	gain_controller_reset(&far_gain_controller, preset_gain(&far_range_preset));
+
+	if (!configure_sector(distance_handle, distance_configuration, &far_range_preset, &far_gain_controller))
 	{
 		return false;
 	}
 
-	if (!measurement(distance_handle, distance_configuration, &result, &result_info))
+	if (!measurement(distance_handle, distance_configuration, &far_range_preset, &far_gain_controller, &result, &result_info))
 	{
 		return false;
 	}
@@ -11,9 +11,13 @@
 #include <string.h>
 
 #include "acc_detector_presence.h"
+#include "acc_frame_scheduler.h"
+#include "acc_gesture_engine.h"
 #include "acc_hal_definitions.h"
 #include "acc_hal_integration.h"
 #include "acc_integration.h"
+#include "acc_preset.h"
+#include "acc_recovery_manager.h"
 #include "acc_rss.h"
 #include "acc_service.h"
 #include "acc_version.h"
@@ -41,41 +45,75 @@
 // Cool down threshold, level at which to be able to trigger again.
 #define COOL_DOWN_THRESHOLD (1.1f)
 
-// Cool down time, minimal time between triggers in ms.
-#define COOL_DOWN_TIME_MS (0)
+// Cool down time, minimal time from the cool down threshold until a new trigger in us.
+#define COOL_DOWN_TIME_US (0U)
 
-// Cool down time in ticks, derived from cooldown time and update rate.
-#define COOL_DOWN_TIME_TICKS ((COOL_DOWN_TIME_MS * UPDATE_RATE_HZ) / 1000)
+// Number of frames between printouts of the achieved frame rate and jitter
+#define SCHEDULER_STATS_INTERVAL (10U * UPDATE_RATE_HZ)
 
 
 /**
- * Configure the detector to the specified configuration
+ * The wave to exit state machine
  *
- * @param configuration The detector configuration to configure with application settings
+ * A wave triggers at the detection threshold. The presence score must then fall below the cool
+ * down threshold, and the cool down time must elapse, before a new wave can trigger.
  */
-static void configure_detector(acc_detector_presence_configuration_t configuration)
+static const acc_gesture_transition_t wave_transitions[] =
 {
-	acc_detector_presence_configuration_sensor_set(configuration, DEFAULT_SENSOR_ID);
+	{ ACC_GESTURE_STATE_TRIGGER,    ACC_GESTURE_CONDITION_SCORE_ABOVE,   DETECTION_THRESHOLD, 0U,                ACC_GESTURE_STATE_COOLDOWN,
+	  ACC_GESTURE_EVENT_DETECTED },
+	{ ACC_GESTURE_STATE_COOLDOWN,   ACC_GESTURE_CONDITION_SCORE_BELOW,   COOL_DOWN_THRESHOLD, 0U,                ACC_GESTURE_STATE_REFRACTORY,
+	  ACC_GESTURE_EVENT_RELEASED },
+	{ ACC_GESTURE_STATE_REFRACTORY, ACC_GESTURE_CONDITION_TIME_IN_STATE, 0.0f,                COOL_DOWN_TIME_US, ACC_GESTURE_STATE_TRIGGER,
+	  ACC_GESTURE_EVENT_REARMED },
+};
 
-	acc_detector_presence_configuration_service_profile_set(configuration, PROFILE);
-	acc_detector_presence_configuration_start_set(configuration, RANGE_START_M);
-	acc_detector_presence_configuration_length_set(configuration, RANGE_LENGTH_M);
-	acc_detector_presence_configuration_hw_accelerated_average_samples_set(configuration, HWAAS);
-	acc_detector_presence_configuration_sweeps_per_frame_set(configuration, SWEEPS_PER_FRAME);
-	acc_detector_presence_configuration_power_save_mode_set(configuration, POWER_SAVE_MODE);
-	acc_detector_presence_configuration_update_rate_set(configuration, UPDATE_RATE_HZ);
 
-	acc_detector_presence_configuration_filter_parameters_t filter = acc_detector_presence_configuration_filter_parameters_get(
-		configuration);
+/**
+ * Gesture event callback, flags a detected wave
+ *
+ * @param event The gesture event
+ * @param info Information about the event
+ * @param client_reference Pointer to the wave detected flag
+ */
+static void wave_event(acc_gesture_event_t event, const acc_gesture_event_info_t *info, void *client_reference)
+{
+	(void)info;
 
-	filter.intra_frame_weight     = 1.0f;
-	filter.intra_frame_time_const = 0.05f;
-	filter.output_time_const      = 0.02f;
+	bool *wave_to_exit = client_reference;
 
-	acc_detector_presence_configuration_filter_parameters_set(configuration, &filter);
+	if (event == ACC_GESTURE_EVENT_DETECTED)
+	{
+		*wave_to_exit = true;
+	}
 }
 
 
+/**
+ * The detector configuration, applied with acc_preset_apply
+ */
+static const acc_preset_entry_t wave_entries[] =
+{
+	ACC_PRESET_INT(ACC_PRESET_SENSOR, DEFAULT_SENSOR_ID),
+	ACC_PRESET_INT(ACC_PRESET_PROFILE, PROFILE),
+	ACC_PRESET_FLOAT(ACC_PRESET_START_M, RANGE_START_M),
+	ACC_PRESET_FLOAT(ACC_PRESET_LENGTH_M, RANGE_LENGTH_M),
+	ACC_PRESET_INT(ACC_PRESET_HWAAS, HWAAS),
+	ACC_PRESET_INT(ACC_PRESET_SWEEPS_PER_FRAME, SWEEPS_PER_FRAME),
+	ACC_PRESET_INT(ACC_PRESET_POWER_SAVE_MODE, POWER_SAVE_MODE),
+	ACC_PRESET_FLOAT(ACC_PRESET_UPDATE_RATE_HZ, (float)UPDATE_RATE_HZ),
+	ACC_PRESET_FLOAT(ACC_PRESET_DETECTION_THRESHOLD, DETECTION_THRESHOLD),
+	ACC_PRESET_FLOAT(ACC_PRESET_INTRA_FRAME_WEIGHT, 1.0f),
+	ACC_PRESET_FLOAT(ACC_PRESET_INTRA_FRAME_TIME_CONST, 0.05f),
+	ACC_PRESET_FLOAT(ACC_PRESET_OUTPUT_TIME_CONST, 0.02f),
+};
+
+static const acc_preset_t wave_preset =
+{
+	"wave to exit", ACC_PRESET_TARGET_DETECTOR_PRESENCE, wave_entries, ACC_PRESET_ENTRY_COUNT(wave_entries)
+};
+
+
 int acc_ref_app_wave_to_exit(int argc, char *argv[]);
 
 
@@ -88,9 +126,6 @@ int acc_ref_app_wave_to_exit(int argc, char *argv[])
 
 	const acc_hal_t *hal = acc_hal_integration_get_implementation();
 
-	// Timing
-	uint32_t period_length_ms = 1000U / UPDATE_RATE_HZ;
-
 	if (!acc_rss_activate(hal))
 	{
 		printf("Failed to activate RSS\n");
@@ -106,7 +141,13 @@ int acc_ref_app_wave_to_exit(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
-	configure_detector(configuration);
+	if (!acc_preset_apply(&wave_preset, configuration))
+	{
+		printf("Failed to apply detector preset\n");
+		acc_detector_presence_configuration_destroy(&configuration);
+		acc_rss_deactivate();
+		return EXIT_FAILURE;
+	}
 
 	acc_detector_presence_handle_t handle = acc_detector_presence_create(configuration);
 
@@ -119,61 +160,53 @@ int acc_ref_app_wave_to_exit(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
-	acc_detector_presence_result_t result;
+	acc_detector_presence_result_t result = { 0 };
+
+	bool status       = true;
+	bool wave_to_exit = false;
+
+	acc_gesture_engine_t gesture_engine;
 
-	bool     status       = true;
-	bool     cool_trig    = true;
-	bool     cool_time    = true;
-	uint32_t cool_counter = 0;
+	acc_gesture_engine_init(&gesture_engine, wave_transitions, sizeof(wave_transitions) / sizeof(wave_transitions[0]),
+	                        wave_event, &wave_to_exit);
 
-	uint32_t last_update_ms = 0;
+	acc_frame_scheduler_t scheduler;
+
+	acc_frame_scheduler_init(&scheduler, UPDATE_RATE_HZ);
 
 	status = acc_detector_presence_activate(handle);
 
+	// Saturation lowers the gain with a detector reconfigure, communication errors recreate the detector
+	acc_recovery_presence_t presence = { .handle = handle, .configuration = configuration };
+	acc_recovery_manager_t  recovery;
+
+	acc_recovery_manager_init(&recovery, &acc_recovery_presence_ops, &presence,
+	                          acc_detector_presence_configuration_sensor_get(configuration));
+
 	while (status)
 	{
-		while (last_update_ms != 0 && hal->os.gettime() - last_update_ms < period_length_ms)
-		{
-			acc_integration_sleep_ms(period_length_ms - (hal->os.gettime() - last_update_ms));
-		}
+		acc_frame_scheduler_wait(&scheduler);
 
-		status         = acc_detector_presence_get_next(handle, &result);
-		last_update_ms = hal->os.gettime();
+		bool got_next = acc_detector_presence_get_next(presence.handle, &result);
 
-		if (status)
-		{
-			bool wave_to_exit = false;
+		acc_recovery_indications_t indications = acc_recovery_indications_presence(&result);
 
-			// Trigger "Wave to exit" if presence is detected and cool-down citerias has been met.
-			if (result.presence_detected && cool_trig && cool_time)
-			{
-				wave_to_exit = true;
-				cool_trig    = false;
-				cool_time    = false;
-			}
+		indications.sensor_communication_error |= !got_next;
 
-			// The first cool-down criteria is that the presence score must fall below a threshold
-			// before a new "Wave to exit" is triggered
-			if (!cool_trig && (result.presence_score < COOL_DOWN_THRESHOLD))
-			{
-				cool_trig    = true;
-				cool_counter = COOL_DOWN_TIME_TICKS;
-			}
+		acc_recovery_action_t action = acc_recovery_manager_handle(&recovery, &indications);
 
-			// The second cool-down criteria is that a certain time, if set, must elapse before
-			// a new "Wave to exit" is triggered
-			if (!cool_time && cool_trig)
-			{
-				if (cool_counter > 0)
-				{
-					cool_counter -= 1;
-				}
-
-				if (cool_counter == 0)
-				{
-					cool_time = true;
-				}
-			}
+		status = (action != ACC_RECOVERY_ACTION_FAILED);
+
+		if (action == ACC_RECOVERY_ACTION_FAILED)
+		{
+			printf("Detector could not be recovered from %s\n", acc_recovery_cause_name(recovery.cause));
+		}
+		else if (action == ACC_RECOVERY_ACTION_NONE)
+		{
+			wave_to_exit = false;
+
+			// Timestamp the frame as soon as it is available, the gesture timing is based on it
+			acc_gesture_engine_update(&gesture_engine, result.presence_score, acc_integration_get_time_us());
 
 			if (wave_to_exit)
 			{
@@ -183,6 +216,11 @@ int acc_ref_app_wave_to_exit(int argc, char *argv[])
 			{
 				printf("No wave detected\n");
 			}
+
+			if (scheduler.stats.frames % SCHEDULER_STATS_INTERVAL == 0)
+			{
+				acc_frame_scheduler_stats_print(&scheduler);
+			}
 		}
 	}
 
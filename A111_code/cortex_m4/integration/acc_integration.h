@@ -12,6 +12,28 @@
 typedef void (*acc_integration_uart_read_func_t)(uint8_t data, uint32_t status);
 
 
+/**
+ * @brief Memory placement of hot code and data
+ *
+ * ACC_INTEGRATION_RAM_FUNC places a function in SRAM2, where it runs without the flash
+ * wait states, and ACC_INTEGRATION_RAM2_DATA places zero initialized data in SRAM2, next to
+ * the 96 KB SRAM1 with the heap and stack. The sections are set up by the linker scripts and
+ * the startup code. Calls between flash and SRAM2 are out of range for a direct branch and
+ * go through a veneer added by the linker, so functions called per sample should be
+ * inlined into the placed function.
+ *
+ * Define ACC_INTEGRATION_NO_RAM_PLACEMENT to keep everything in flash and SRAM1, for
+ * example to measure the difference.
+ */
+#if defined(__GNUC__) && defined(__arm__) && !defined(ACC_INTEGRATION_NO_RAM_PLACEMENT)
+#define ACC_INTEGRATION_RAM_FUNC  __attribute__((section(".Ram2Func"), noinline))
+#define ACC_INTEGRATION_RAM2_DATA __attribute__((section(".Ram2Data")))
+#else
+#define ACC_INTEGRATION_RAM_FUNC
+#define ACC_INTEGRATION_RAM2_DATA
+#endif
+
+
 /**
  * @brief Sleep for a specified number of microseconds
  *
@@ -68,4 +90,26 @@ void acc_integration_mem_free(void *ptr);
 uint32_t acc_integration_get_time(void);
 
 
+/**
+ * @brief Get current time with microsecond resolution
+ *
+ * The value wraps at 2^32 - 1, after about 71 minutes, so only differences between two
+ * values are meaningful.
+ *
+ * @returns Current time as microseconds
+ */
+uint32_t acc_integration_get_time_us(void);
+
+
+/**
+ * @brief Get the number of core clock cycles
+ *
+ * The cycle counter is started at the first call. The value wraps at 2^32 - 1, after
+ * about 54 seconds at 80 MHz, so only differences between two values are meaningful.
+ *
+ * @returns Current cycle count
+ */
+uint32_t acc_integration_get_cycle_count(void);
+
+
 #endif
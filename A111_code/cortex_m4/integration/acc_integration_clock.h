@@ -0,0 +1,93 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_INTEGRATION_CLOCK_H_
+#define ACC_INTEGRATION_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * MCU clock profiles
+ *
+ * A profile sets the system clock, the voltage range, the flash wait states, the flash
+ * prefetch and caches and the sensor SPI clock together. SystemClock_Config leaves the
+ * MCU at 80 MHz with the SPI clock of the CubeMX project until a profile is set.
+ *
+ * Profiles are switched between measurement bursts, with no SPI transfer in progress.
+ * The SysTick is reconfigured by the HAL so that the time functions keep their unit. The
+ * switch waits for the log UART, huart2 unless ACC_INTEGRATION_CLOCK_UART_HANDLE is
+ * defined, to finish sending and then reinitializes it for its baudrate at the new
+ * clock. Other peripherals clocked from the APB buses must be reinitialized by the
+ * caller after a switch.
+ */
+
+
+/**
+ * @brief The highest SPI clock of the sensor interface in Hz, optional
+ *
+ * When not defined, the highest SPI clock is the one set up by the CubeMX project of the
+ * board, read at the first profile switch. A profile then never runs the sensor
+ * interface faster than the board was configured for, for example 1.25 MHz on the
+ * Sparkfun board and 20 MHz in the module software. Define it to raise or lower the
+ * limit. The STM32L476 SPI master runs at up to 40 MHz in voltage range 1, the A111 at up
+ * to 50 MHz, boards where the sensor is connected with wires need less.
+ */
+
+
+/**
+ * @brief Clock profiles
+ */
+typedef enum
+{
+	/** PLL from HSI16 at 80 MHz, voltage range 1, prefetch and caches on, fastest SPI */
+	ACC_INTEGRATION_CLOCK_PROFILE_MAX_THROUGHPUT,
+	/** MSI at 48 MHz without the PLL, voltage range 1, prefetch and caches on */
+	ACC_INTEGRATION_CLOCK_PROFILE_BALANCED,
+	/** MSI at 4 MHz, voltage range 2, no wait states, caches on and prefetch off */
+	ACC_INTEGRATION_CLOCK_PROFILE_LOW_POWER,
+	ACC_INTEGRATION_CLOCK_PROFILE_COUNT
+} acc_integration_clock_profile_t;
+
+
+/**
+ * @brief Description of a clock profile
+ */
+typedef struct
+{
+	const char *name;
+	uint32_t   system_clock_hz;
+	/** Typical MCU run current from flash in uA, from the datasheet, for energy estimates */
+	uint32_t   run_current_ua;
+} acc_integration_clock_profile_info_t;
+
+
+/**
+ * @brief Set a clock profile
+ *
+ * @param[in] profile The profile
+ * @return True if successful, false if the clock could not be configured or the UART
+ *         baudrate cannot be reached at the new clock
+ */
+bool acc_integration_clock_profile_set(acc_integration_clock_profile_t profile);
+
+
+/**
+ * @brief Get the current clock profile
+ *
+ * @return The last profile set, ACC_INTEGRATION_CLOCK_PROFILE_COUNT if none has been set
+ */
+acc_integration_clock_profile_t acc_integration_clock_profile_get(void);
+
+
+/**
+ * @brief Get the description of a clock profile
+ *
+ * @param[in] profile The profile
+ * @return The description, NULL for an invalid profile
+ */
+const acc_integration_clock_profile_info_t *acc_integration_clock_profile_info_get(acc_integration_clock_profile_t profile);
+
+
+#endif
@@ -0,0 +1,293 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+
+#include "acc_hal_integration.h"
+#include "acc_integration_clock.h"
+
+
+#ifndef ACC_INTEGRATION_CLOCK_UART_HANDLE
+#define ACC_INTEGRATION_CLOCK_UART_HANDLE huart2
+#endif
+
+
+/**
+ * @brief Clock settings of a profile
+ */
+typedef struct
+{
+	acc_integration_clock_profile_info_t info;
+	uint32_t                             voltage_scaling;
+	uint32_t                             system_clock_source;
+	/** MSI range, used when the system clock source is the MSI */
+	uint32_t                             msi_range;
+	uint32_t                             flash_latency;
+	bool                                 prefetch;
+} clock_profile_t;
+
+
+static const clock_profile_t clock_profiles[ACC_INTEGRATION_CLOCK_PROFILE_COUNT] =
+{
+	[ACC_INTEGRATION_CLOCK_PROFILE_MAX_THROUGHPUT] =
+	{
+		.info                = { "max throughput", 80000000U, 10300U },
+		.voltage_scaling     = PWR_REGULATOR_VOLTAGE_SCALE1,
+		.system_clock_source = RCC_SYSCLKSOURCE_PLLCLK,
+		.msi_range           = RCC_MSIRANGE_6,
+		.flash_latency       = FLASH_LATENCY_4,
+		.prefetch            = true,
+	},
+	[ACC_INTEGRATION_CLOCK_PROFILE_BALANCED] =
+	{
+		.info                = { "balanced", 48000000U, 5900U },
+		.voltage_scaling     = PWR_REGULATOR_VOLTAGE_SCALE1,
+		.system_clock_source = RCC_SYSCLKSOURCE_MSI,
+		.msi_range           = RCC_MSIRANGE_11,
+		.flash_latency       = FLASH_LATENCY_2,
+		.prefetch            = true,
+	},
+	[ACC_INTEGRATION_CLOCK_PROFILE_LOW_POWER] =
+	{
+		.info                = { "low power", 4000000U, 430U },
+		.voltage_scaling     = PWR_REGULATOR_VOLTAGE_SCALE2,
+		.system_clock_source = RCC_SYSCLKSOURCE_MSI,
+		.msi_range           = RCC_MSIRANGE_6,
+		.flash_latency       = FLASH_LATENCY_0,
+		.prefetch            = false,
+	},
+};
+
+extern UART_HandleTypeDef ACC_INTEGRATION_CLOCK_UART_HANDLE;
+
+static acc_integration_clock_profile_t current_profile = ACC_INTEGRATION_CLOCK_PROFILE_COUNT;
+
+#if !defined(ACC_INTEGRATION_CLOCK_SPI_MAX_HZ)
+static uint32_t board_spi_clock_hz;
+#endif
+
+
+/**
+ * @brief Get the highest SPI clock, the clock of the board configuration unless overridden
+ *
+ * Must be called before the first clock switch.
+ */
+static uint32_t spi_max_clock_get(void)
+{
+#if defined(ACC_INTEGRATION_CLOCK_SPI_MAX_HZ)
+	return ACC_INTEGRATION_CLOCK_SPI_MAX_HZ;
+#else
+	if (board_spi_clock_hz == 0U)
+	{
+		// Still the clocks of SystemClock_Config and the SPI init of the CubeMX project
+		board_spi_clock_hz = acc_hal_integration_get_spi_clock_hz();
+	}
+
+	return board_spi_clock_hz;
+#endif
+}
+
+
+/**
+ * @brief Wait until the UART has sent all queued data, so that no character is cut by the switch
+ */
+static void uart_wait_idle(UART_HandleTypeDef *uart)
+{
+	if (uart->gState == HAL_UART_STATE_RESET)
+	{
+		return;
+	}
+
+	while (uart->gState != HAL_UART_STATE_READY)
+	{
+	}
+
+	while (__HAL_UART_GET_FLAG(uart, UART_FLAG_TC) == RESET)
+	{
+	}
+}
+
+
+/**
+ * @brief Derive the baudrate register of the UART from the new APB clock
+ *
+ * HAL_UART_Init keeps the settings of the handle and only calls the MSP init the first time.
+ */
+static bool uart_reinit(UART_HandleTypeDef *uart)
+{
+	if (uart->gState == HAL_UART_STATE_RESET)
+	{
+		return true;
+	}
+
+	return HAL_UART_Init(uart) == HAL_OK;
+}
+
+
+/**
+ * @brief Switch the system clock to HSI16 with all buses undivided
+ *
+ * The PLL and the MSI range cannot be changed while they clock the system. The highest
+ * wait state count is used as it is valid in both voltage ranges.
+ */
+static bool system_clock_hsi_set(void)
+{
+	RCC_OscInitTypeDef osc_init = { 0 };
+	RCC_ClkInitTypeDef clk_init = { 0 };
+
+	osc_init.OscillatorType      = RCC_OSCILLATORTYPE_HSI;
+	osc_init.HSIState            = RCC_HSI_ON;
+	osc_init.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+	osc_init.PLL.PLLState        = RCC_PLL_NONE;
+
+	if (HAL_RCC_OscConfig(&osc_init) != HAL_OK)
+	{
+		return false;
+	}
+
+	clk_init.ClockType      = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clk_init.SYSCLKSource   = RCC_SYSCLKSOURCE_HSI;
+	clk_init.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+	clk_init.APB1CLKDivider = RCC_HCLK_DIV1;
+	clk_init.APB2CLKDivider = RCC_HCLK_DIV1;
+
+	return HAL_RCC_ClockConfig(&clk_init, FLASH_LATENCY_4) == HAL_OK;
+}
+
+
+/**
+ * @brief Start the oscillator of a profile and stop the unused ones, except HSI16
+ */
+static bool oscillators_set(const clock_profile_t *profile)
+{
+	RCC_OscInitTypeDef osc_init = { 0 };
+
+	osc_init.OscillatorType      = RCC_OSCILLATORTYPE_MSI;
+	osc_init.MSICalibrationValue = RCC_MSICALIBRATION_DEFAULT;
+
+	if (profile->system_clock_source == RCC_SYSCLKSOURCE_PLLCLK)
+	{
+		// Same PLL configuration as SystemClock_Config, HSI16 / 1 * 10 / 2 = 80 MHz
+		osc_init.MSIState       = RCC_MSI_OFF;
+		osc_init.PLL.PLLState   = RCC_PLL_ON;
+		osc_init.PLL.PLLSource  = RCC_PLLSOURCE_HSI;
+		osc_init.PLL.PLLM       = 1;
+		osc_init.PLL.PLLN       = 10;
+		osc_init.PLL.PLLP       = RCC_PLLP_DIV7;
+		osc_init.PLL.PLLQ       = RCC_PLLQ_DIV2;
+		osc_init.PLL.PLLR       = RCC_PLLR_DIV2;
+	}
+	else
+	{
+		osc_init.MSIState       = RCC_MSI_ON;
+		osc_init.MSIClockRange  = profile->msi_range;
+		osc_init.PLL.PLLState   = RCC_PLL_OFF;
+	}
+
+	return HAL_RCC_OscConfig(&osc_init) == HAL_OK;
+}
+
+
+bool acc_integration_clock_profile_set(acc_integration_clock_profile_t profile)
+{
+	if (profile >= ACC_INTEGRATION_CLOCK_PROFILE_COUNT)
+	{
+		return false;
+	}
+
+	const clock_profile_t *config     = &clock_profiles[profile];
+	uint32_t              spi_max_hz = spi_max_clock_get();
+
+	uart_wait_idle(&ACC_INTEGRATION_CLOCK_UART_HANDLE);
+
+	// Voltage range 1 must be set before the frequency is raised
+	if (config->voltage_scaling == PWR_REGULATOR_VOLTAGE_SCALE1 &&
+	    HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) != HAL_OK)
+	{
+		return false;
+	}
+
+	if (!system_clock_hsi_set() || !oscillators_set(config))
+	{
+		return false;
+	}
+
+	RCC_ClkInitTypeDef clk_init = { 0 };
+
+	clk_init.ClockType      = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clk_init.SYSCLKSource   = config->system_clock_source;
+	clk_init.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+	clk_init.APB1CLKDivider = RCC_HCLK_DIV1;
+	clk_init.APB2CLKDivider = RCC_HCLK_DIV1;
+
+	// Also reconfigures the SysTick for the new clock
+	if (HAL_RCC_ClockConfig(&clk_init, config->flash_latency) != HAL_OK)
+	{
+		return false;
+	}
+
+	if (config->system_clock_source == RCC_SYSCLKSOURCE_MSI)
+	{
+		RCC_OscInitTypeDef osc_init = { 0 };
+
+		osc_init.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+		osc_init.HSIState       = RCC_HSI_OFF;
+		osc_init.PLL.PLLState   = RCC_PLL_NONE;
+
+		if (HAL_RCC_OscConfig(&osc_init) != HAL_OK)
+		{
+			return false;
+		}
+	}
+
+	// Voltage range 2 only after the frequency has been lowered
+	if (config->voltage_scaling == PWR_REGULATOR_VOLTAGE_SCALE2 &&
+	    HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE2) != HAL_OK)
+	{
+		return false;
+	}
+
+	// The prefetch only saves time with wait states, the caches also save flash accesses
+	if (config->prefetch)
+	{
+		__HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+	}
+	else
+	{
+		__HAL_FLASH_PREFETCH_BUFFER_DISABLE();
+	}
+
+	__HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+	__HAL_FLASH_DATA_CACHE_ENABLE();
+
+	acc_hal_integration_set_spi_max_clock_hz(spi_max_hz);
+
+	current_profile = profile;
+
+	// The UART is clocked from PCLK1, which follows the system clock
+	return uart_reinit(&ACC_INTEGRATION_CLOCK_UART_HANDLE);
+}
+
+
+acc_integration_clock_profile_t acc_integration_clock_profile_get(void)
+{
+	return current_profile;
+}
+
+
+const acc_integration_clock_profile_info_t *acc_integration_clock_profile_info_get(acc_integration_clock_profile_t profile)
+{
+	if (profile >= ACC_INTEGRATION_CLOCK_PROFILE_COUNT)
+	{
+		return NULL;
+	}
+
+	return &clock_profiles[profile].info;
+}
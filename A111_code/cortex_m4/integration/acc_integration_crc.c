@@ -0,0 +1,37 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "acc_integration_crc.h"
+
+
+/**
+ * CRC-32 with polynomial 0xEDB88320, four bits at a time
+ */
+static const uint32_t crc_table[16] =
+{
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+
+uint32_t acc_integration_crc32_update(uint32_t crc, const void *data, size_t length)
+{
+	const uint8_t *bytes = data;
+
+	crc = ~crc;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		crc ^= bytes[i];
+		crc  = (crc >> 4) ^ crc_table[crc & 0xF];
+		crc  = (crc >> 4) ^ crc_table[crc & 0xF];
+	}
+
+	return ~crc;
+}
@@ -0,0 +1,26 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_INTEGRATION_CRC_H_
+#define ACC_INTEGRATION_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * @brief Update a CRC-32 with more data
+ *
+ * The CRC is the same as zlib crc32 and binascii.crc32 in Python. Start with 0 and pass
+ * the returned value with the next block of data, the result does not depend on how the
+ * data is split into blocks.
+ *
+ * @param[in] crc The CRC of the data so far, 0 for the first block
+ * @param[in] data The data
+ * @param[in] length The number of bytes in data
+ * @return The CRC of the data so far including this block
+ */
+uint32_t acc_integration_crc32_update(uint32_t crc, const void *data, size_t length);
+
+
+#endif
@@ -0,0 +1,85 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "acc_integration.h"
+
+
+/**
+ * Integration for host builds of the processing libraries and benchmarks, on a POSIX system.
+ * There is no cycle counter, acc_integration_get_cycle_count returns the time in ns.
+ */
+
+
+static uint64_t time_ns_get(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec;
+}
+
+
+void acc_integration_sleep_us(uint32_t time_usec)
+{
+	struct timespec duration;
+
+	duration.tv_sec  = (time_t)(time_usec / 1000000U);
+	duration.tv_nsec = (long)(time_usec % 1000000U) * 1000L;
+
+	while (nanosleep(&duration, &duration) != 0)
+	{
+		// Sleep the remaining time if interrupted by a signal
+	}
+}
+
+
+void acc_integration_sleep_ms(uint32_t time_msec)
+{
+	acc_integration_sleep_us(time_msec * 1000U);
+}
+
+
+void *acc_integration_mem_alloc(size_t size)
+{
+	return malloc(size);
+}
+
+
+void *acc_integration_mem_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+
+void acc_integration_mem_free(void *ptr)
+{
+	free(ptr);
+}
+
+
+uint32_t acc_integration_get_time(void)
+{
+	return (uint32_t)(time_ns_get() / 1000000U);
+}
+
+
+uint32_t acc_integration_get_time_us(void)
+{
+	return (uint32_t)(time_ns_get() / 1000U);
+}
+
+
+uint32_t acc_integration_get_cycle_count(void)
+{
+	return (uint32_t)time_ns_get();
+}
@@ -0,0 +1,25 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdlib.h>
+
+
+/**
+ * Entry point of host builds, runs the example or reference application selected with
+ * ACC_APP_MAIN, for example -DACC_APP_MAIN=acc_example_benchmark_dsp
+ */
+#ifndef ACC_APP_MAIN
+#error "ACC_APP_MAIN must be defined to the entry function of the application"
+#endif
+
+
+int ACC_APP_MAIN(int argc, char *argv[]);
+
+
+int main(int argc, char *argv[])
+{
+	return ACC_APP_MAIN(argc, argv);
+}
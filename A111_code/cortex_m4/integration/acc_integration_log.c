@@ -5,9 +5,11 @@
 // of this source code package.
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "acc_definitions_common.h"
 #include "acc_integration.h"
@@ -18,11 +20,19 @@
 #define LOG_FORMAT "%02u:%02u:%02u.%03u (%c) (%s) %s\n"
 
 
+static acc_log_level_t log_level = ACC_INTEGRATION_LOG_LEVEL;
+
+
 void acc_integration_log(acc_log_level_t level, const char *module, const char *format, ...)
 {
 	char    log_buffer[LOG_BUFFER_MAX_SIZE];
 	va_list ap;
 
+	if (level > log_level)
+	{
+		return;
+	}
+
 	va_start(ap, format);
 
 	int ret = vsnprintf(log_buffer, LOG_BUFFER_MAX_SIZE, format, ap);
@@ -52,3 +62,38 @@ void acc_integration_log(acc_log_level_t level, const char *module, const char *
 
 	va_end(ap);
 }
+
+
+void acc_integration_log_level_set(acc_log_level_t level)
+{
+	log_level = level;
+}
+
+
+acc_log_level_t acc_integration_log_level_get(void)
+{
+	return log_level;
+}
+
+
+void acc_integration_log_output_set(acc_integration_log_write_func_t write_func, bool asynchronous)
+{
+	(void)write_func;
+	(void)asynchronous;
+}
+
+
+void acc_integration_log_output_complete(void)
+{
+}
+
+
+void acc_integration_log_drain(void)
+{
+}
+
+
+void acc_integration_log_stats_get(acc_integration_log_stats_t *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
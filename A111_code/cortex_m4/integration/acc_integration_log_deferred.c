@@ -0,0 +1,380 @@
+// Copyright (c) Acconeer AB, 2019-2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_definitions_common.h"
+#include "acc_integration.h"
+#include "acc_integration_log.h"
+
+
+/**
+ * Deferred log backend, an alternative to acc_integration_log.c
+ *
+ * Instead of formatting and printing, acc_integration_log stores a binary record
+ * in a ring buffer. The text is reconstructed on the host by script/log_decoder.py
+ * using the ELF file to resolve the module and format string pointers.
+ *
+ * Record layout, all values little endian:
+ *   0      Sync byte, written last to commit the record
+ *   1      Log level, bit 7 set if the arguments were truncated
+ *   2      Number of argument bytes
+ *   3      Number of records dropped before this one, saturated at 255
+ *   4-7    Time in ms
+ *   8-11   Module string address
+ *   12-15  Format string address
+ *   16-    Arguments in format order. Integers and pointers use 4 bytes, long long
+ *          8 bytes and floating point values 8 bytes (double). Strings are copied as
+ *          one length byte followed by the characters, a NULL string is only the length
+ *          byte LOG_STRING_NULL and is printed as "(null)".
+ *
+ * Producers reserve space with a compare and swap on the head index and may run in
+ * any context. acc_integration_log_drain is the single consumer.
+ */
+
+#ifndef ACC_INTEGRATION_LOG_BUFFER_SIZE
+#define ACC_INTEGRATION_LOG_BUFFER_SIZE 2048
+#endif
+
+#define LOG_BUFFER_MASK (ACC_INTEGRATION_LOG_BUFFER_SIZE - 1)
+
+#define LOG_RECORD_SYNC        0xA5
+#define LOG_RECORD_HEADER_SIZE 16
+#define LOG_RECORD_MAX_ARGS    64
+#define LOG_STRING_MAX_LENGTH  32
+#define LOG_STRING_NULL        0xFF
+#define LOG_LEVEL_TRUNCATED    0x80
+
+typedef char log_buffer_size_must_be_power_of_two[((ACC_INTEGRATION_LOG_BUFFER_SIZE & LOG_BUFFER_MASK) == 0) ? 1 : -1];
+
+
+static uint8_t  log_buffer[ACC_INTEGRATION_LOG_BUFFER_SIZE];
+static uint32_t log_head;
+static uint32_t log_tail;
+static uint32_t log_drain_end;
+static uint32_t log_in_flight;
+static uint8_t  log_draining;
+static uint32_t log_dropped_since_record;
+
+static acc_integration_log_stats_t log_stats;
+static acc_log_level_t             log_level = ACC_INTEGRATION_LOG_LEVEL;
+
+static acc_integration_log_write_func_t log_write_func;
+static bool                             log_write_asynchronous;
+
+
+static bool stdout_write(const void *buffer, size_t buffer_size)
+{
+	bool success = fwrite(buffer, 1, buffer_size, stdout) == buffer_size;
+
+	fflush(stdout);
+
+	return success;
+}
+
+
+static void put_u32(uint8_t *dest, uint32_t value)
+{
+	dest[0] = (uint8_t)value;
+	dest[1] = (uint8_t)(value >> 8);
+	dest[2] = (uint8_t)(value >> 16);
+	dest[3] = (uint8_t)(value >> 24);
+}
+
+
+static bool put_bytes(uint8_t *args, size_t *length, const void *data, size_t data_size)
+{
+	if (*length + data_size > LOG_RECORD_MAX_ARGS)
+	{
+		return false;
+	}
+
+	memcpy(&args[*length], data, data_size);
+	*length += data_size;
+
+	return true;
+}
+
+
+/**
+ * @brief Copy the arguments described by format into args
+ *
+ * @return False if the arguments did not fit and were truncated
+ */
+static bool encode_args(uint8_t *args, size_t *length, const char *format, va_list ap)
+{
+	bool fits = true;
+
+	*length = 0;
+
+	while (fits && *format != '\0')
+	{
+		if (*format++ != '%')
+		{
+			continue;
+		}
+
+		if (*format == '%')
+		{
+			format++;
+			continue;
+		}
+
+		// Flags, width and precision, a '*' takes an int argument
+		while (*format != '\0' && strchr("-+ #0123456789.*", *format) != NULL)
+		{
+			if (*format == '*')
+			{
+				int value = va_arg(ap, int);
+				fits = fits && put_bytes(args, length, &value, sizeof(value));
+			}
+
+			format++;
+		}
+
+		unsigned int long_count = 0;
+
+		while (*format != '\0' && strchr("hljztL", *format) != NULL)
+		{
+			long_count += (*format == 'l') ? 1 : 0;
+			format++;
+		}
+
+		switch (*format)
+		{
+			case 'd':
+			case 'i':
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+			case 'c':
+				if (long_count >= 2)
+				{
+					long long value = va_arg(ap, long long);
+					fits = fits && put_bytes(args, length, &value, sizeof(value));
+				}
+				else
+				{
+					uint32_t value = (long_count == 1) ? (uint32_t)va_arg(ap, long) : (uint32_t)va_arg(ap, int);
+					fits = fits && put_bytes(args, length, &value, sizeof(value));
+				}
+
+				break;
+			case 'p':
+			{
+				uint32_t value = (uint32_t)(uintptr_t)va_arg(ap, void *);
+				fits = fits && put_bytes(args, length, &value, sizeof(value));
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			{
+				double value = va_arg(ap, double);
+				fits = fits && put_bytes(args, length, &value, sizeof(value));
+				break;
+			}
+			case 's':
+			{
+				const char *string = va_arg(ap, const char *);
+				size_t     string_length;
+				uint8_t    byte_length;
+
+				if (string == NULL)
+				{
+					byte_length = LOG_STRING_NULL;
+					fits        = fits && put_bytes(args, length, &byte_length, sizeof(byte_length));
+					break;
+				}
+
+				string_length = strlen(string);
+
+				if (string_length > LOG_STRING_MAX_LENGTH)
+				{
+					string_length = LOG_STRING_MAX_LENGTH;
+				}
+
+				byte_length = (uint8_t)string_length;
+
+				fits = fits && put_bytes(args, length, &byte_length, sizeof(byte_length));
+				fits = fits && put_bytes(args, length, string, string_length);
+				break;
+			}
+			case '\0':
+				return fits;
+			default:
+				break;
+		}
+
+		format++;
+	}
+
+	return fits;
+}
+
+
+static bool reserve(uint32_t length, uint32_t *start)
+{
+	uint32_t head = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+	uint32_t used;
+
+	do
+	{
+		used = head + length - __atomic_load_n(&log_tail, __ATOMIC_ACQUIRE);
+
+		if (used > ACC_INTEGRATION_LOG_BUFFER_SIZE)
+		{
+			__atomic_fetch_add(&log_stats.dropped, 1, __ATOMIC_RELAXED);
+			__atomic_fetch_add(&log_dropped_since_record, 1, __ATOMIC_RELAXED);
+			return false;
+		}
+	} while (!__atomic_compare_exchange_n(&log_head, &head, head + length, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	if (used > __atomic_load_n(&log_stats.max_used, __ATOMIC_RELAXED))
+	{
+		__atomic_store_n(&log_stats.max_used, used, __ATOMIC_RELAXED);
+	}
+
+	*start = head;
+	return true;
+}
+
+
+void acc_integration_log(acc_log_level_t level, const char *module, const char *format, ...)
+{
+	uint8_t record[LOG_RECORD_HEADER_SIZE + LOG_RECORD_MAX_ARGS];
+	size_t  args_length;
+	va_list ap;
+
+	if (level > log_level)
+	{
+		return;
+	}
+
+	va_start(ap, format);
+	bool fits = encode_args(&record[LOG_RECORD_HEADER_SIZE], &args_length, format, ap);
+	va_end(ap);
+
+	uint32_t length = LOG_RECORD_HEADER_SIZE + args_length;
+	uint32_t start;
+
+	if (!reserve(length, &start))
+	{
+		return;
+	}
+
+	uint32_t dropped = __atomic_exchange_n(&log_dropped_since_record, 0, __ATOMIC_RELAXED);
+
+	record[1] = (uint8_t)level | (fits ? 0 : LOG_LEVEL_TRUNCATED);
+	record[2] = (uint8_t)args_length;
+	record[3] = (dropped > UINT8_MAX) ? UINT8_MAX : (uint8_t)dropped;
+	put_u32(&record[4], acc_integration_get_time());
+	put_u32(&record[8], (uint32_t)(uintptr_t)module);
+	put_u32(&record[12], (uint32_t)(uintptr_t)format);
+
+	for (uint32_t i = 1; i < length; i++)
+	{
+		log_buffer[(start + i) & LOG_BUFFER_MASK] = record[i];
+	}
+
+	__atomic_store_n(&log_buffer[start & LOG_BUFFER_MASK], LOG_RECORD_SYNC, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&log_stats.records, 1, __ATOMIC_RELAXED);
+}
+
+
+void acc_integration_log_level_set(acc_log_level_t level)
+{
+	log_level = level;
+}
+
+
+acc_log_level_t acc_integration_log_level_get(void)
+{
+	return log_level;
+}
+
+
+void acc_integration_log_output_set(acc_integration_log_write_func_t write_func, bool asynchronous)
+{
+	log_write_func         = write_func;
+	log_write_asynchronous = (write_func != NULL) && asynchronous;
+}
+
+
+void acc_integration_log_output_complete(void)
+{
+	uint32_t tail = log_tail;
+
+	for (uint32_t i = 0; i < log_in_flight; i++)
+	{
+		log_buffer[(tail + i) & LOG_BUFFER_MASK] = 0;
+	}
+
+	__atomic_store_n(&log_tail, tail + log_in_flight, __ATOMIC_RELEASE);
+	__atomic_store_n(&log_in_flight, 0, __ATOMIC_RELEASE);
+}
+
+
+void acc_integration_log_drain(void)
+{
+	if (__atomic_exchange_n(&log_draining, 1, __ATOMIC_ACQUIRE) != 0)
+	{
+		return;
+	}
+
+	acc_integration_log_write_func_t write_func = (log_write_func != NULL) ? log_write_func : stdout_write;
+
+	while (__atomic_load_n(&log_in_flight, __ATOMIC_ACQUIRE) == 0)
+	{
+		// Extend the committed region record by record
+		while (log_drain_end - log_tail < ACC_INTEGRATION_LOG_BUFFER_SIZE &&
+		       __atomic_load_n(&log_buffer[log_drain_end & LOG_BUFFER_MASK], __ATOMIC_ACQUIRE) == LOG_RECORD_SYNC)
+		{
+			log_drain_end += LOG_RECORD_HEADER_SIZE + log_buffer[(log_drain_end + 2) & LOG_BUFFER_MASK];
+		}
+
+		uint32_t pending    = log_drain_end - log_tail;
+		uint32_t contiguous = ACC_INTEGRATION_LOG_BUFFER_SIZE - (log_tail & LOG_BUFFER_MASK);
+		uint32_t chunk      = (pending < contiguous) ? pending : contiguous;
+
+		if (chunk == 0)
+		{
+			break;
+		}
+
+		__atomic_store_n(&log_in_flight, chunk, __ATOMIC_RELEASE);
+
+		if (!write_func(&log_buffer[log_tail & LOG_BUFFER_MASK], chunk))
+		{
+			__atomic_store_n(&log_in_flight, 0, __ATOMIC_RELEASE);
+			break;
+		}
+
+		if (!log_write_asynchronous)
+		{
+			acc_integration_log_output_complete();
+		}
+	}
+
+	__atomic_store_n(&log_draining, 0, __ATOMIC_RELEASE);
+}
+
+
+void acc_integration_log_stats_get(acc_integration_log_stats_t *stats)
+{
+	stats->records  = __atomic_load_n(&log_stats.records, __ATOMIC_RELAXED);
+	stats->dropped  = __atomic_load_n(&log_stats.dropped, __ATOMIC_RELAXED);
+	stats->max_used = __atomic_load_n(&log_stats.max_used, __ATOMIC_RELAXED);
+}
@@ -11,11 +11,29 @@
 #include "main.h"
 
 #include "acc_integration.h"
+#include "acc_integration_log.h"
 
 
 void acc_integration_sleep_ms(uint32_t time_msec)
 {
-	HAL_Delay(time_msec);
+	uint32_t start = HAL_GetTick();
+
+	// Sleeping is idle time, send any deferred log records first
+	acc_integration_log_drain();
+
+	// Sleep mode between interrupts, the SysTick interrupt wakes the core every ms
+	while (HAL_GetTick() - start < time_msec)
+	{
+		__disable_irq();
+
+		// Check again so that the SysTick did not occur in between
+		if (HAL_GetTick() - start < time_msec)
+		{
+			__WFI();
+		}
+
+		__enable_irq();
+	}
 }
 
 
@@ -23,7 +41,7 @@ void acc_integration_sleep_us(uint32_t time_usec)
 {
 	uint32_t time_msec = (time_usec / 1000) + 1;
 
-	HAL_Delay(time_msec);
+	acc_integration_sleep_ms(time_msec);
 }
 
 
@@ -33,6 +51,39 @@ uint32_t acc_integration_get_time(void)
 }
 
 
+uint32_t acc_integration_get_time_us(void)
+{
+	uint32_t tick;
+	uint32_t counter;
+
+	// Read again if the SysTick wrapped in between, the tick interrupt has then incremented the tick
+	do
+	{
+		tick    = HAL_GetTick();
+		counter = SysTick->VAL;
+	} while (tick != HAL_GetTick());
+
+	// The SysTick counts down from LOAD to 0 every tick
+	uint32_t reload = SysTick->LOAD + 1;
+
+	return (tick * 1000) + (uint32_t)(((uint64_t)(reload - 1 - counter) * 1000) / reload);
+}
+
+
+uint32_t acc_integration_get_cycle_count(void)
+{
+	// Start the DWT cycle counter at the first call
+	if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0)
+	{
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT       = 0;
+		DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+
+	return DWT->CYCCNT;
+}
+
+
 void *acc_integration_mem_alloc(size_t size)
 {
 	return malloc(size);
@@ -0,0 +1,229 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "acc_definitions_common.h"
+#include "acc_integration.h"
+#include "acc_integration_crc.h"
+#include "acc_integration_log.h"
+#include "acc_integration_sweep_dump.h"
+
+
+/**
+ * The payload is copied as is, both the target and the host decoder are little endian.
+ * The copy makes the sensor buffer free for the next frame while an asynchronous
+ * transfer is ongoing.
+ */
+
+#ifndef ACC_INTEGRATION_SWEEP_DUMP_BUFFER_SIZE
+#define ACC_INTEGRATION_SWEEP_DUMP_BUFFER_SIZE 4096
+#endif
+
+#define MODULE "sweep_dump"
+
+#define SWEEP_DUMP_MAGIC       0x50575341 // "ASWP"
+#define SWEEP_DUMP_VERSION     1
+#define SWEEP_DUMP_HEADER_SIZE 32
+#define SWEEP_DUMP_CRC_SIZE    4
+
+
+static uint8_t       sweep_dump_buffer[ACC_INTEGRATION_SWEEP_DUMP_BUFFER_SIZE];
+static uint32_t      sweep_dump_sequence;
+static volatile bool sweep_dump_transfer_active;
+
+static acc_integration_sweep_dump_stats_t sweep_dump_stats;
+
+static acc_integration_sweep_dump_write_func_t sweep_dump_write_func;
+static bool                                    sweep_dump_write_asynchronous;
+
+
+static bool stdout_write(const void *buffer, size_t buffer_size)
+{
+	bool success = fwrite(buffer, 1, buffer_size, stdout) == buffer_size;
+
+	fflush(stdout);
+
+	return success;
+}
+
+
+static uint8_t flags_get(bool missed_data, bool sensor_communication_error, bool data_saturated, bool data_quality_warning)
+{
+	uint8_t flags = 0;
+
+	if (missed_data)
+	{
+		flags |= ACC_INTEGRATION_SWEEP_DUMP_FLAG_MISSED_DATA;
+	}
+
+	if (sensor_communication_error)
+	{
+		flags |= ACC_INTEGRATION_SWEEP_DUMP_FLAG_SENSOR_COMMUNICATION_ERROR;
+	}
+
+	if (data_saturated)
+	{
+		flags |= ACC_INTEGRATION_SWEEP_DUMP_FLAG_DATA_SATURATED;
+	}
+
+	if (data_quality_warning)
+	{
+		flags |= ACC_INTEGRATION_SWEEP_DUMP_FLAG_DATA_QUALITY_WARNING;
+	}
+
+	return flags;
+}
+
+
+static void put_u16(uint8_t *dest, uint16_t value)
+{
+	dest[0] = (uint8_t)value;
+	dest[1] = (uint8_t)(value >> 8);
+}
+
+
+static void put_u32(uint8_t *dest, uint32_t value)
+{
+	dest[0] = (uint8_t)value;
+	dest[1] = (uint8_t)(value >> 8);
+	dest[2] = (uint8_t)(value >> 16);
+	dest[3] = (uint8_t)(value >> 24);
+}
+
+
+static bool send_frame(const acc_integration_sweep_dump_info_t *info, acc_integration_sweep_dump_data_type_t data_type,
+                       const void *data, size_t sample_size)
+{
+	size_t   payload_size = (size_t)info->sweep_length * info->sweeps * sample_size;
+	size_t   frame_size   = SWEEP_DUMP_HEADER_SIZE + payload_size + SWEEP_DUMP_CRC_SIZE;
+	uint32_t sequence     = sweep_dump_sequence++;
+
+	if (frame_size > sizeof(sweep_dump_buffer))
+	{
+		if (sweep_dump_stats.too_large == 0)
+		{
+			ACC_LOG_WARNING("Frame of %u bytes dropped, the buffer is %u bytes", (unsigned int)frame_size,
+			                (unsigned int)sizeof(sweep_dump_buffer));
+		}
+
+		sweep_dump_stats.too_large++;
+		sweep_dump_stats.dropped++;
+		return false;
+	}
+
+	if (sweep_dump_transfer_active)
+	{
+		sweep_dump_stats.dropped++;
+		return false;
+	}
+
+	uint8_t *frame = sweep_dump_buffer;
+
+	put_u32(&frame[0], SWEEP_DUMP_MAGIC);
+	frame[4] = SWEEP_DUMP_VERSION;
+	frame[5] = (uint8_t)data_type;
+	frame[6] = info->stream_id;
+	frame[7] = info->flags;
+	put_u32(&frame[8], sequence);
+	put_u32(&frame[12], acc_integration_get_time());
+	memcpy(&frame[16], &info->start_m, sizeof(info->start_m));
+	memcpy(&frame[20], &info->step_length_m, sizeof(info->step_length_m));
+	put_u16(&frame[24], info->sweep_length);
+	put_u16(&frame[26], info->sweeps);
+	put_u32(&frame[28], (uint32_t)payload_size);
+	memcpy(&frame[SWEEP_DUMP_HEADER_SIZE], data, payload_size);
+
+	size_t crc_offset = SWEEP_DUMP_HEADER_SIZE + payload_size;
+
+	put_u32(&frame[crc_offset], acc_integration_crc32_update(0, frame, crc_offset));
+
+	acc_integration_sweep_dump_write_func_t write_func = (sweep_dump_write_func != NULL) ? sweep_dump_write_func : stdout_write;
+
+	sweep_dump_transfer_active = sweep_dump_write_asynchronous;
+
+	if (!write_func(frame, frame_size))
+	{
+		sweep_dump_transfer_active = false;
+		sweep_dump_stats.dropped++;
+		return false;
+	}
+
+	sweep_dump_stats.frames++;
+
+	return true;
+}
+
+
+void acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_write_func_t write_func, bool asynchronous)
+{
+	sweep_dump_write_func         = write_func;
+	sweep_dump_write_asynchronous = (write_func != NULL) && asynchronous;
+}
+
+
+void acc_integration_sweep_dump_output_complete(void)
+{
+	sweep_dump_transfer_active = false;
+}
+
+
+void acc_integration_sweep_dump_flush(void)
+{
+	while (sweep_dump_transfer_active)
+	{
+		// Cleared by acc_integration_sweep_dump_output_complete from the transfer complete interrupt
+	}
+}
+
+
+uint8_t acc_integration_sweep_dump_flags_envelope(const acc_service_envelope_result_info_t *result_info)
+{
+	return flags_get(result_info->missed_data, result_info->sensor_communication_error, result_info->data_saturated,
+	                 result_info->data_quality_warning);
+}
+
+
+uint8_t acc_integration_sweep_dump_flags_iq(const acc_service_iq_result_info_t *result_info)
+{
+	return flags_get(result_info->missed_data, result_info->sensor_communication_error, result_info->data_saturated,
+	                 result_info->data_quality_warning);
+}
+
+
+uint8_t acc_integration_sweep_dump_flags_power_bins(const acc_service_power_bins_result_info_t *result_info)
+{
+	return flags_get(result_info->missed_data, result_info->sensor_communication_error, result_info->data_saturated,
+	                 result_info->data_quality_warning);
+}
+
+
+uint8_t acc_integration_sweep_dump_flags_sparse(const acc_service_sparse_result_info_t *result_info)
+{
+	return flags_get(result_info->missed_data, result_info->sensor_communication_error, result_info->data_saturated, false);
+}
+
+
+bool acc_integration_sweep_dump_uint16(const acc_integration_sweep_dump_info_t *info, const uint16_t *data)
+{
+	return send_frame(info, ACC_INTEGRATION_SWEEP_DUMP_DATA_TYPE_UINT16, data, sizeof(*data));
+}
+
+
+bool acc_integration_sweep_dump_complex(const acc_integration_sweep_dump_info_t *info, const acc_int16_complex_t *data)
+{
+	return send_frame(info, ACC_INTEGRATION_SWEEP_DUMP_DATA_TYPE_INT16_COMPLEX, data, sizeof(*data));
+}
+
+
+void acc_integration_sweep_dump_stats_get(acc_integration_sweep_dump_stats_t *stats)
+{
+	*stats = sweep_dump_stats;
+}
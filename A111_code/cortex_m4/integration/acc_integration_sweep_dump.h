@@ -0,0 +1,221 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef ACC_INTEGRATION_SWEEP_DUMP_H_
+#define ACC_INTEGRATION_SWEEP_DUMP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "acc_definitions_common.h"
+#include "acc_service_envelope.h"
+#include "acc_service_iq.h"
+#include "acc_service_power_bins.h"
+#include "acc_service_sparse.h"
+
+
+/**
+ * Binary sweep dump channel
+ *
+ * Each call sends one frame, decoded on the host by script/sweep_dump_decoder.py.
+ * Frame layout, all values little endian:
+ *   0-3    Magic, "ASWP"
+ *   4      Frame format version
+ *   5      Data type, see acc_integration_sweep_dump_data_type_t
+ *   6      Stream id, to tell several services apart
+ *   7      Flags, see ACC_INTEGRATION_SWEEP_DUMP_FLAG_*
+ *   8-11   Sequence number, incremented for every frame including dropped ones
+ *   12-15  Time in ms
+ *   16-19  Start in m, float
+ *   20-23  Step length in m, float
+ *   24-25  Number of points per sweep
+ *   26-27  Number of sweeps in the frame
+ *   28-31  Payload size in bytes
+ *   32-    Payload, uint16 or int16 real followed by int16 imaginary
+ *   last 4 CRC-32 (same as zlib) of everything before it
+ *
+ * Text written to the same output between frames is passed through by the decoder.
+ */
+
+#define ACC_INTEGRATION_SWEEP_DUMP_FLAG_MISSED_DATA                0x01
+#define ACC_INTEGRATION_SWEEP_DUMP_FLAG_SENSOR_COMMUNICATION_ERROR 0x02
+#define ACC_INTEGRATION_SWEEP_DUMP_FLAG_DATA_SATURATED             0x04
+#define ACC_INTEGRATION_SWEEP_DUMP_FLAG_DATA_QUALITY_WARNING       0x08
+
+
+/**
+ * @brief Sample type of the payload
+ */
+typedef enum
+{
+	ACC_INTEGRATION_SWEEP_DUMP_DATA_TYPE_UINT16        = 1,
+	ACC_INTEGRATION_SWEEP_DUMP_DATA_TYPE_INT16_COMPLEX = 2,
+} acc_integration_sweep_dump_data_type_t;
+
+
+/**
+ * @brief Metadata sent in the frame header
+ */
+typedef struct
+{
+	/** Stream id, for example the index of the service */
+	uint8_t  stream_id;
+	/** Combination of ACC_INTEGRATION_SWEEP_DUMP_FLAG_* */
+	uint8_t  flags;
+	/** Start of sweep */
+	float    start_m;
+	/** Distance between adjacent data points */
+	float    step_length_m;
+	/** Number of data points in each sweep */
+	uint16_t sweep_length;
+	/** Number of sweeps in the frame, 1 for all services except sparse */
+	uint16_t sweeps;
+} acc_integration_sweep_dump_info_t;
+
+
+/**
+ * @brief Function used to send a frame
+ *
+ * @param[in] buffer The data to send
+ * @param[in] buffer_size The number of bytes to send
+ * @return True if the data was sent, or the transfer was started for an asynchronous output
+ */
+typedef bool (*acc_integration_sweep_dump_write_func_t)(const void *buffer, size_t buffer_size);
+
+
+/**
+ * @brief Sweep dump statistics
+ */
+typedef struct
+{
+	/** Number of frames sent */
+	uint32_t frames;
+	/** Number of frames dropped because the previous frame was still being sent or was too large */
+	uint32_t dropped;
+	/** Number of the dropped frames that were larger than ACC_INTEGRATION_SWEEP_DUMP_BUFFER_SIZE */
+	uint32_t too_large;
+} acc_integration_sweep_dump_stats_t;
+
+
+/**
+ * @brief Set the output of the sweep dump channel
+ *
+ * The default output is a synchronous write to stdout. An asynchronous output, for
+ * example HAL_UART_Transmit_DMA, must call acc_integration_sweep_dump_output_complete
+ * when the transfer is done. Frames are dropped, not queued, while a transfer is ongoing
+ * so that the sensor loop is never blocked.
+ *
+ * @param[in] write_func The output function, NULL for the default output
+ * @param[in] asynchronous True if write_func only starts the transfer
+ */
+void acc_integration_sweep_dump_output_set(acc_integration_sweep_dump_write_func_t write_func, bool asynchronous);
+
+
+/**
+ * @brief Start sending a frame over the UART with DMA
+ *
+ * Write function for acc_integration_sweep_dump_output_set with asynchronous output,
+ * the transfer complete interrupt calls acc_integration_sweep_dump_output_complete.
+ * Text written to the UART with blocking writes while a frame is sent is lost.
+ *
+ * @param[in] buffer The data to send, must be valid until the transfer is complete
+ * @param[in] buffer_size The number of bytes to send
+ * @return True if the transfer was started
+ */
+bool acc_integration_sweep_dump_uart_dma_write(const void *buffer, size_t buffer_size);
+
+
+/**
+ * @brief Signal that an asynchronous sweep dump transfer is complete
+ *
+ * May be called from interrupt context.
+ */
+void acc_integration_sweep_dump_output_complete(void);
+
+
+/**
+ * @brief Handle a transfer complete or error callback of a UART
+ *
+ * Called from the HAL_UART_TxCpltCallback and HAL_UART_ErrorCallback of the board when it
+ * defines them, see acc_integration_sweep_dump_stm32.c. Other UARTs are left to the board.
+ *
+ * @param[in] uart The UART_HandleTypeDef of the callback
+ * @return True if the UART is the one of the sweep dump and the transfer was completed
+ */
+bool acc_integration_sweep_dump_uart_event(const void *uart);
+
+
+/**
+ * @brief Wait until an ongoing asynchronous transfer is complete
+ *
+ * Call before writing text to an output that is shared with an asynchronous sweep dump output.
+ */
+void acc_integration_sweep_dump_flush(void);
+
+
+/**
+ * @brief Get the frame flags of an envelope result
+ *
+ * @param[in] result_info The result info of the frame
+ * @return Combination of ACC_INTEGRATION_SWEEP_DUMP_FLAG_*
+ */
+uint8_t acc_integration_sweep_dump_flags_envelope(const acc_service_envelope_result_info_t *result_info);
+
+
+/**
+ * @brief Get the frame flags of an IQ result
+ *
+ * @param[in] result_info The result info of the frame
+ * @return Combination of ACC_INTEGRATION_SWEEP_DUMP_FLAG_*
+ */
+uint8_t acc_integration_sweep_dump_flags_iq(const acc_service_iq_result_info_t *result_info);
+
+
+/**
+ * @brief Get the frame flags of a power bins result
+ *
+ * @param[in] result_info The result info of the frame
+ * @return Combination of ACC_INTEGRATION_SWEEP_DUMP_FLAG_*
+ */
+uint8_t acc_integration_sweep_dump_flags_power_bins(const acc_service_power_bins_result_info_t *result_info);
+
+
+/**
+ * @brief Get the frame flags of a sparse result
+ *
+ * @param[in] result_info The result info of the frame
+ * @return Combination of ACC_INTEGRATION_SWEEP_DUMP_FLAG_*
+ */
+uint8_t acc_integration_sweep_dump_flags_sparse(const acc_service_sparse_result_info_t *result_info);
+
+
+/**
+ * @brief Send a frame of uint16 data, for example envelope, power bins or sparse data
+ *
+ * @param[in] info Metadata of the frame
+ * @param[in] data The data, sweep_length * sweeps values
+ * @return True if the frame was sent, false if it was dropped
+ */
+bool acc_integration_sweep_dump_uint16(const acc_integration_sweep_dump_info_t *info, const uint16_t *data);
+
+
+/**
+ * @brief Send a frame of complex IQ data
+ *
+ * @param[in] info Metadata of the frame
+ * @param[in] data The data, sweep_length * sweeps values
+ * @return True if the frame was sent, false if it was dropped
+ */
+bool acc_integration_sweep_dump_complex(const acc_integration_sweep_dump_info_t *info, const acc_int16_complex_t *data);
+
+
+/**
+ * @brief Get sweep dump statistics
+ *
+ * @param[out] stats The sweep dump statistics
+ */
+void acc_integration_sweep_dump_stats_get(acc_integration_sweep_dump_stats_t *stats);
+
+
+#endif
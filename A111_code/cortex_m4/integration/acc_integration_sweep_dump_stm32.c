@@ -0,0 +1,142 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "main.h"
+
+#include "acc_integration_sweep_dump.h"
+
+
+/**
+ * UART DMA output of the sweep dump channel
+ *
+ * The UART is the one used for stdout. The CubeMX projects of the boards configure it
+ * without DMA, so the TX DMA channel is set up and linked to the UART at the first write.
+ * The defaults are USART2 TX on DMA1 channel 7. Define
+ * ACC_INTEGRATION_SWEEP_DUMP_NO_IRQ_HANDLERS if the CubeMX project already has the
+ * DMA and UART interrupt handlers or the HAL_UART_TxCpltCallback and
+ * HAL_UART_ErrorCallback callbacks. The interrupt handlers must then call
+ * HAL_DMA_IRQHandler and HAL_UART_IRQHandler for these handles and the callbacks must
+ * call acc_integration_sweep_dump_uart_event.
+ */
+
+#ifndef ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE
+#define ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE huart2
+#endif
+
+#ifndef ACC_INTEGRATION_SWEEP_DUMP_DMA_CHANNEL
+#define ACC_INTEGRATION_SWEEP_DUMP_DMA_CHANNEL      DMA1_Channel7
+#define ACC_INTEGRATION_SWEEP_DUMP_DMA_REQUEST      DMA_REQUEST_2
+#define ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ          DMA1_Channel7_IRQn
+#define ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ_HANDLER  DMA1_Channel7_IRQHandler
+#define ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ         USART2_IRQn
+#define ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ_HANDLER USART2_IRQHandler
+#endif
+
+
+extern UART_HandleTypeDef ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE;
+
+static DMA_HandleTypeDef sweep_dump_dma_tx;
+
+
+#ifndef ACC_INTEGRATION_SWEEP_DUMP_NO_IRQ_HANDLERS
+void ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ_HANDLER(void);
+
+
+void ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ_HANDLER(void);
+
+
+void ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ_HANDLER(void)
+{
+	HAL_DMA_IRQHandler(&sweep_dump_dma_tx);
+}
+
+
+void ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ_HANDLER(void)
+{
+	HAL_UART_IRQHandler(&ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE);
+}
+
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *h_uart)
+{
+	acc_integration_sweep_dump_uart_event(h_uart);
+}
+
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *h_uart)
+{
+	acc_integration_sweep_dump_uart_event(h_uart);
+}
+
+
+#endif
+
+
+static bool dma_setup(UART_HandleTypeDef *uart)
+{
+	if (uart->hdmatx != NULL)
+	{
+		return true;
+	}
+
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	sweep_dump_dma_tx.Instance                 = ACC_INTEGRATION_SWEEP_DUMP_DMA_CHANNEL;
+	sweep_dump_dma_tx.Init.Request             = ACC_INTEGRATION_SWEEP_DUMP_DMA_REQUEST;
+	sweep_dump_dma_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	sweep_dump_dma_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+	sweep_dump_dma_tx.Init.MemInc              = DMA_MINC_ENABLE;
+	sweep_dump_dma_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	sweep_dump_dma_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	sweep_dump_dma_tx.Init.Mode                = DMA_NORMAL;
+	sweep_dump_dma_tx.Init.Priority            = DMA_PRIORITY_LOW;
+
+	if (HAL_DMA_Init(&sweep_dump_dma_tx) != HAL_OK)
+	{
+		return false;
+	}
+
+	__HAL_LINKDMA(uart, hdmatx, sweep_dump_dma_tx);
+
+	// Below the sensor interrupt, a frame transfer must never delay the sensor
+	HAL_NVIC_SetPriority(ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ, 5, 0);
+	HAL_NVIC_EnableIRQ(ACC_INTEGRATION_SWEEP_DUMP_DMA_IRQ);
+	HAL_NVIC_SetPriority(ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ, 5, 0);
+	HAL_NVIC_EnableIRQ(ACC_INTEGRATION_SWEEP_DUMP_UART_IRQ);
+
+	return true;
+}
+
+
+bool acc_integration_sweep_dump_uart_event(const void *uart)
+{
+	if (uart != &ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE)
+	{
+		return false;
+	}
+
+	acc_integration_sweep_dump_output_complete();
+
+	return true;
+}
+
+
+bool acc_integration_sweep_dump_uart_dma_write(const void *buffer, size_t buffer_size)
+{
+	UART_HandleTypeDef *uart = &ACC_INTEGRATION_SWEEP_DUMP_UART_HANDLE;
+
+	if (buffer_size > UINT16_MAX || !dma_setup(uart))
+	{
+		return false;
+	}
+
+	// The HAL takes a non-const pointer but only reads from it
+	return HAL_UART_Transmit_DMA(uart, (uint8_t *)(uintptr_t)buffer, (uint16_t)buffer_size) == HAL_OK;
+}
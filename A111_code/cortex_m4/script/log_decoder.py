@@ -0,0 +1,220 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2020-2023
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Decoder for the binary log records written by the deferred log backend,
+integration/acc_integration_log_deferred.c. The module and format strings
+are looked up in the ELF file of the firmware and the log lines are printed
+in the same format as the immediate log backend.
+"""
+import argparse
+import re
+import struct
+import sys
+
+RECORD_SYNC = 0xA5
+RECORD_HEADER_SIZE = 16
+LEVEL_TRUNCATED = 0x80
+STRING_NULL = 0xFF
+LEVEL_CHARACTERS = 'EWIVD'
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diuxXocpfFeEgGs%])')
+
+
+class ElfStrings:
+    """
+    Read NUL terminated strings from the loadable sections of an ELF file
+    """
+    def __init__(self, path):
+        with open(path, 'rb') as elf_file:
+            self._data = elf_file.read()
+
+        assert self._data[:4] == b'\x7fELF', 'Not an ELF file'
+        is_64 = self._data[4] == 2
+        endian = '<' if self._data[5] == 1 else '>'
+
+        if is_64:
+            shoff, = struct.unpack_from(endian + 'Q', self._data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self._data, 0x3A)
+            section_format = endian + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', self._data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self._data, 0x2E)
+            section_format = endian + 'IIIIII'
+
+        self._sections = []
+        for index in range(shnum):
+            _name, section_type, flags, addr, offset, size = struct.unpack_from(
+                section_format, self._data, shoff + index * shentsize)
+            if flags & SHF_ALLOC and section_type != SHT_NOBITS and size > 0:
+                self._sections.append((addr & 0xFFFFFFFF, offset, size))
+
+    def string(self, address):
+        """
+        Get the string at address, None if it is not in the ELF file
+        """
+        for addr, offset, size in self._sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self._data.index(b'\0', start, offset + size)
+                return self._data[start:end].decode('utf-8', errors='replace')
+        return None
+
+
+def _format_message(format_string, args, truncated):
+    """
+    Apply the printf format string to the raw argument bytes
+    """
+    offset = 0
+    missing = False
+
+    def take(size, fmt):
+        nonlocal offset, missing
+        if missing or offset + size > len(args):
+            missing = True
+            return None
+        value, = struct.unpack_from(fmt, args, offset)
+        offset += size
+        return value
+
+    def convert(match):
+        nonlocal offset, missing
+        flags, width, precision, length, conversion = match.groups()
+
+        if conversion == '%':
+            return '%'
+
+        if width == '*':
+            width = take(4, '<i')
+            width = '' if width is None else str(width)
+        if precision == '*':
+            precision = take(4, '<i')
+            precision = '' if precision is None else str(precision)
+
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+        if conversion == 's':
+            size = take(1, '<B')
+            if size == STRING_NULL:
+                return (spec + 's') % '(null)'
+            if size is None or offset + size > len(args):
+                missing = True
+                return '?'
+            value = args[offset:offset + size].decode('utf-8', errors='replace')
+            offset += size
+            return (spec + 's') % value
+
+        if conversion in 'fFeEgG':
+            value = take(8, '<d')
+            return '?' if value is None else (spec + conversion) % value
+
+        if conversion == 'p':
+            value = take(4, '<I')
+            return '?' if value is None else f'0x{value:08x}'
+
+        signed = conversion in 'di'
+        if length == 'll':
+            value = take(8, '<q' if signed else '<Q')
+        else:
+            value = take(4, '<i' if signed else '<I')
+
+        if value is None:
+            return '?'
+        if conversion == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        return (spec + {'i': 'd', 'u': 'd'}.get(conversion, conversion)) % value
+
+    message = CONVERSION.sub(convert, format_string)
+    if truncated or missing:
+        message += '...'
+    return message
+
+
+def decode(stream, strings):
+    """
+    Decode log records from a byte stream, yields text lines
+    """
+    buffer = bytearray()
+
+    while True:
+        data = stream.read(256)
+        if not data:
+            return
+        buffer.extend(data)
+
+        while len(buffer) >= RECORD_HEADER_SIZE:
+            if buffer[0] != RECORD_SYNC:
+                del buffer[0]
+                continue
+
+            level, args_length, dropped, time_ms, module_addr, format_addr = struct.unpack_from(
+                '<BBBIII', buffer, 1)
+            length = RECORD_HEADER_SIZE + args_length
+            if len(buffer) < length:
+                break
+
+            args = bytes(buffer[RECORD_HEADER_SIZE:length])
+            del buffer[:length]
+
+            module = strings.string(module_addr)
+            format_string = strings.string(format_addr)
+            if module is None or format_string is None:
+                # Not a record, resynchronize on the next sync byte
+                buffer[0:0] = args
+                continue
+
+            if dropped > 0:
+                yield f'<{dropped}{"+" if dropped == 255 else ""} log records dropped>'
+
+            level_value = level & ~LEVEL_TRUNCATED
+            level_ch = LEVEL_CHARACTERS[level_value] if level_value < len(LEVEL_CHARACTERS) else '?'
+            message = _format_message(format_string, args, level & LEVEL_TRUNCATED)
+
+            hours = time_ms // 1000 // 60 // 60
+            minutes = time_ms // 1000 // 60 % 60
+            seconds = time_ms // 1000 % 60
+            milliseconds = time_ms % 1000
+
+            yield f'{hours:02}:{minutes:02}:{seconds:02}.{milliseconds:03} ({level_ch}) ({module}) {message}'
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Decode binary log records from the deferred log backend')
+    parser.add_argument('elf', help='ELF file of the firmware that produced the log')
+    parser.add_argument('--input', help='File with captured log data')
+    parser.add_argument('--port', help='Serial port to read the log from, e.g. /dev/ttyACM0')
+    parser.add_argument('--baudrate', default=115200, type=int, help='Baudrate of the serial port')
+
+    args = parser.parse_args()
+    strings = ElfStrings(args.elf)
+
+    if args.port is not None:
+        import serial  # pylint: disable=import-outside-toplevel
+        stream = serial.Serial(args.port, args.baudrate, timeout=None)
+    elif args.input is not None:
+        stream = open(args.input, 'rb')  # pylint: disable=consider-using-with
+    else:
+        stream = sys.stdin.buffer
+
+    with stream:
+        for line in decode(stream, strings):
+            print(line, flush=True)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
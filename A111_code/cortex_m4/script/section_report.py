@@ -0,0 +1,170 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Section size report of an STM32L476 ELF file.
+Lists the size of each allocated section grouped by memory region, FLASH,
+SRAM1 (RAM) and SRAM2 (RAM2) as in STM32L476RGTX_FLASH.ld, and the usage of
+each region. Sections with a load address in flash, .data and the SRAM2
+code copied by the startup, are also counted in the flash usage.
+
+With a second ELF file the sizes are compared, for example a build with
+ACC_INTEGRATION_NO_RAM_PLACEMENT against the default build.
+Only the ELF headers are read, no toolchain is needed.
+"""
+import argparse
+import struct
+import sys
+
+# Must match STM32L476RGTX_FLASH.ld
+REGIONS = [
+    ('FLASH', 0x08000000, 1024 * 1024),
+    ('RAM', 0x20000000, 96 * 1024),
+    ('RAM2', 0x10000000, 32 * 1024),
+]
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+PT_LOAD = 1
+
+
+def region_get(address):
+    """
+    Name of the region containing an address, None if outside all regions
+    """
+    for name, origin, length in REGIONS:
+        if origin <= address < origin + length:
+            return name
+
+    return None
+
+
+def read_elf(path):
+    """
+    Read the allocated sections of an ELF32 little endian file.
+    Returns a list of (name, address, load address, size, nobits)
+    """
+    with open(path, 'rb') as elf_file:
+        data = elf_file.read()
+
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        raise ValueError(f'{path} is not a 32 bit little endian ELF file')
+
+    (phoff, shoff) = struct.unpack_from('<II', data, 28)
+    (phentsize, phnum, shentsize, shnum, shstrndx) = struct.unpack_from('<HHHHH', data, 42)
+
+    segments = []
+    for index in range(phnum):
+        (p_type, _, p_vaddr, p_paddr, p_filesz, _) = struct.unpack_from('<IIIIII', data, phoff + index * phentsize)
+        if p_type == PT_LOAD:
+            segments.append((p_vaddr, p_paddr, p_filesz))
+
+    headers = [struct.unpack_from('<IIIIIIIIII', data, shoff + index * shentsize) for index in range(shnum)]
+    strtab_offset = headers[shstrndx][4]
+
+    sections = []
+    for (name_offset, sh_type, sh_flags, sh_addr, _, sh_size, _, _, _, _) in headers:
+        if not sh_flags & SHF_ALLOC or sh_size == 0:
+            continue
+
+        name_end = data.index(b'\0', strtab_offset + name_offset)
+        name = data[strtab_offset + name_offset:name_end].decode('ascii', errors='replace')
+        nobits = sh_type == SHT_NOBITS
+
+        load_address = sh_addr
+        if not nobits:
+            for (vaddr, paddr, filesz) in segments:
+                if vaddr <= sh_addr < vaddr + filesz:
+                    load_address = paddr + sh_addr - vaddr
+                    break
+
+        sections.append((name, sh_addr, load_address, sh_size, nobits))
+
+    return sections
+
+
+def usage_get(sections):
+    """
+    Bytes used in each region, including flash load images of sections placed in RAM
+    """
+    usage = {name: 0 for name, _, _ in REGIONS}
+
+    for (_, address, load_address, size, nobits) in sections:
+        region = region_get(address)
+        if region is not None:
+            usage[region] += size
+
+        load_region = region_get(load_address)
+        if not nobits and load_address != address and load_region is not None:
+            usage[load_region] += size
+
+    return usage
+
+
+def print_report(sections, reference):
+    """
+    Print the sections and the region usage, with the difference to the reference if given
+    """
+    reference_sizes = {}
+    if reference is not None:
+        reference_sizes = {name: size for (name, _, _, size, _) in reference}
+
+    def difference(size, reference_size):
+        return f' {size - reference_size:+9d}' if reference is not None else ''
+
+    for (region_name, _, _) in REGIONS:
+        print(f'{region_name}')
+        for (name, address, load_address, size, _) in sections:
+            if region_get(address) != region_name:
+                continue
+            load = f' (load 0x{load_address:08x})' if load_address != address else ''
+            print(f'  {name:<20} 0x{address:08x} {size:9d}{difference(size, reference_sizes.get(name, 0))}{load}')
+
+    usage = usage_get(sections)
+    reference_usage = usage_get(reference) if reference is not None else {}
+
+    print('Region usage')
+    for (region_name, _, length) in REGIONS:
+        used = usage[region_name]
+        print(f'  {region_name:<20} {used:9d} of {length:9d} bytes, {100.0 * used / length:5.1f} %'
+              f'{difference(used, reference_usage.get(region_name, 0))}')
+
+    return usage
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Report section sizes and memory region usage of an ELF file')
+    parser.add_argument('elf', help='ELF file to report')
+    parser.add_argument('--compare', help='Reference ELF file, the difference to it is reported')
+
+    args = parser.parse_args()
+
+    try:
+        sections = read_elf(args.elf)
+        reference = read_elf(args.compare) if args.compare is not None else None
+    except (OSError, ValueError, struct.error) as error:
+        print(error, file=sys.stderr)
+        return 2
+
+    usage = print_report(sections, reference)
+
+    for (region_name, _, length) in REGIONS:
+        if usage[region_name] > length:
+            print(f'{region_name} overflowed by {usage[region_name] - length} bytes', file=sys.stderr)
+            return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,196 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Decoder for the binary sweep dump frames written by
+integration/acc_integration_sweep_dump.c. Frames are written to a CSV file,
+one row per sweep, or to a NumPy .npz file with one array per stream.
+Text between frames, for example from printf, is passed through to stderr.
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b'ASWP'
+HEADER_FORMAT = '<4sBBBBIIffHHI'
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+CRC_SIZE = 4
+VERSION = 1
+
+DATA_TYPE_UINT16 = 1
+DATA_TYPE_INT16_COMPLEX = 2
+
+FLAG_NAMES = {
+    0x01: 'missed_data',
+    0x02: 'sensor_communication_error',
+    0x04: 'data_saturated',
+    0x08: 'data_quality_warning',
+}
+
+
+class Frame:
+    """
+    One decoded sweep dump frame
+    """
+    def __init__(self, header, payload):
+        (_magic, _version, self.data_type, self.stream_id, self.flags, self.sequence, self.time_ms,
+         self.start_m, self.step_length_m, self.sweep_length, self.sweeps, _payload_size) = header
+
+        if self.data_type == DATA_TYPE_INT16_COMPLEX:
+            values = struct.unpack(f'<{len(payload) // 2}h', payload)
+            values = [complex(re, im) for re, im in zip(values[0::2], values[1::2])]
+        else:
+            values = list(struct.unpack(f'<{len(payload) // 2}H', payload))
+
+        self.sweep_data = [values[i * self.sweep_length:(i + 1) * self.sweep_length]
+                           for i in range(self.sweeps)]
+
+    def flag_names(self):
+        """
+        Names of the flags set in the frame
+        """
+        return [name for bit, name in FLAG_NAMES.items() if self.flags & bit]
+
+
+def decode(stream, text_output=sys.stderr):
+    """
+    Decode frames from a byte stream, yields Frame objects
+    """
+    buffer = bytearray()
+
+    while True:
+        data = stream.read(4096)
+        if not data:
+            if buffer:
+                text_output.write(buffer.decode('utf-8', errors='replace'))
+            return
+        buffer.extend(data)
+
+        while True:
+            start = buffer.find(MAGIC)
+            if start < 0:
+                # Keep a possible partial magic at the end
+                keep = len(MAGIC) - 1
+                text_output.write(buffer[:-keep].decode('utf-8', errors='replace'))
+                del buffer[:-keep]
+                break
+
+            if start > 0:
+                text_output.write(buffer[:start].decode('utf-8', errors='replace'))
+                del buffer[:start]
+
+            if len(buffer) < HEADER_SIZE:
+                break
+
+            header = struct.unpack_from(HEADER_FORMAT, buffer)
+            payload_size = header[-1]
+            frame_size = HEADER_SIZE + payload_size + CRC_SIZE
+
+            if header[1] != VERSION or payload_size > 0x10000:
+                del buffer[:1]
+                continue
+
+            if len(buffer) < frame_size:
+                break
+
+            crc, = struct.unpack_from('<I', buffer, HEADER_SIZE + payload_size)
+            if crc != zlib.crc32(bytes(buffer[:HEADER_SIZE + payload_size])):
+                print('Sweep dump frame with bad CRC dropped', file=sys.stderr)
+                del buffer[:1]
+                continue
+
+            frame = Frame(header, bytes(buffer[HEADER_SIZE:HEADER_SIZE + payload_size]))
+            del buffer[:frame_size]
+            yield frame
+
+
+def write_csv(frames, csv_file):
+    """
+    Write one row per sweep, complex values as real and imaginary columns
+    """
+    csv_file.write('stream,sequence,time_ms,sweep,flags,start_m,step_length_m,data\n')
+    count = 0
+    for frame in frames:
+        for index, sweep in enumerate(frame.sweep_data):
+            if frame.data_type == DATA_TYPE_INT16_COMPLEX:
+                values = ','.join(f'{int(v.real)},{int(v.imag)}' for v in sweep)
+            else:
+                values = ','.join(str(v) for v in sweep)
+            csv_file.write(f'{frame.stream_id},{frame.sequence},{frame.time_ms},{index},'
+                           f'{"|".join(frame.flag_names())},{frame.start_m:.4f},'
+                           f'{frame.step_length_m:.6f},{values}\n')
+        csv_file.flush()
+        count += 1
+    return count
+
+
+def write_npz(frames, path):
+    """
+    Write one array per stream with shape (frames, sweeps, sweep length)
+    """
+    import numpy as np  # pylint: disable=import-outside-toplevel
+
+    streams = {}
+    for frame in frames:
+        streams.setdefault(frame.stream_id, []).append(frame)
+
+    arrays = {}
+    for stream_id, stream_frames in streams.items():
+        dtype = np.complex64 if stream_frames[0].data_type == DATA_TYPE_INT16_COMPLEX else np.uint16
+        arrays[f'stream_{stream_id}'] = np.array([f.sweep_data for f in stream_frames], dtype=dtype)
+        arrays[f'stream_{stream_id}_sequence'] = np.array([f.sequence for f in stream_frames], dtype=np.uint32)
+        arrays[f'stream_{stream_id}_time_ms'] = np.array([f.time_ms for f in stream_frames], dtype=np.uint32)
+        arrays[f'stream_{stream_id}_flags'] = np.array([f.flags for f in stream_frames], dtype=np.uint8)
+        arrays[f'stream_{stream_id}_range_m'] = (stream_frames[0].start_m + stream_frames[0].step_length_m *
+                                                 np.arange(stream_frames[0].sweep_length))
+
+    np.savez(path, **arrays)
+    return sum(len(stream_frames) for stream_frames in streams.values())
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Decode binary sweep dump frames')
+    parser.add_argument('--input', help='File with captured data')
+    parser.add_argument('--port', help='Serial port to read from, e.g. /dev/ttyACM0')
+    parser.add_argument('--baudrate', default=115200, type=int, help='Baudrate of the serial port')
+    parser.add_argument('--csv', help='CSV file to write, default is stdout')
+    parser.add_argument('--npz', help='NumPy .npz file to write when the input ends')
+
+    args = parser.parse_args()
+
+    if args.port is not None:
+        import serial  # pylint: disable=import-outside-toplevel
+        stream = serial.Serial(args.port, args.baudrate, timeout=None)
+    elif args.input is not None:
+        stream = open(args.input, 'rb')  # pylint: disable=consider-using-with
+    else:
+        stream = sys.stdin.buffer
+
+    with stream:
+        frames = decode(stream)
+        if args.npz is not None:
+            count = write_npz(frames, args.npz)
+        elif args.csv is not None:
+            with open(args.csv, 'w', encoding='utf-8') as csv_file:
+                count = write_csv(frames, csv_file)
+        else:
+            count = write_csv(frames, sys.stdout)
+
+    print(f'{count} frames decoded', file=sys.stderr)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
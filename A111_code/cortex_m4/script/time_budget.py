@@ -0,0 +1,243 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Measurement time budget estimator, the host side of examples/acc_time_budget.c.
+Estimates the sweep, SPI readout and RSS processing time of service
+configurations and flags the configurations that cannot reach their sweep or
+update rate. The model coefficients are read from the 'time_budget' lines
+printed by example_time_budget on target, other lines are ignored, so the
+captured output of the example can be passed as is. Without a model file the
+nominal coefficients are used.
+
+Configurations are given on the command line or as a JSON list of objects with
+the same names as the command line options, for example
+[{"name": "far range", "service": "envelope", "length": 1.3, "downsampling": 4,
+  "update_rate": 10}]
+
+The exit status is 1 if any configuration does not fit its time budget.
+"""
+import argparse
+import json
+import sys
+
+SERVICES = ['envelope', 'iq', 'power_bins', 'sparse']
+
+# Must match acc_time_budget.c
+POINT_STEP_M = 0.000484
+SPARSE_POINT_STEP_M = 0.06
+POINT_BYTES = 4
+SPARSE_POINT_BYTES = 2
+MUR_6_PRF_MHZ = 13.0
+MUR_9_PRF_MHZ = 8.7
+PROFILE_COUNT = 5
+
+DEFAULTS = {
+    'name': '',
+    'service': 'envelope',
+    'profile': 2,
+    'mur': 6,
+    'hwaas': 10,
+    'start': 0.2,
+    'length': 0.5,
+    'downsampling': 1,
+    'sweeps_per_frame': 1,
+    'sweep_rate': 0.0,
+    'update_rate': 0.0,
+    'asynchronous': True,
+    'spi_clock': 1250000,
+}
+
+
+def default_model():
+    """
+    The nominal model, as acc_time_budget_model_default
+    """
+    model = {
+        'sweep_overhead_us': 250.0,
+        'spi_overhead_us': 60.0,
+        'spi_scale': 1.0,
+    }
+
+    for profile in range(1, PROFILE_COUNT + 1):
+        model[f'point_us.{profile}'] = 1.0 / MUR_6_PRF_MHZ
+
+    for service, overhead, point in zip(SERVICES, [400.0, 400.0, 300.0, 200.0], [1.2, 0.8, 0.6, 0.1]):
+        model[f'processing_overhead_us.{service}'] = overhead
+        model[f'processing_point_us.{service}'] = point
+
+    return model
+
+
+def read_model(stream, model):
+    """
+    Update the model with the 'time_budget <key> <value>' lines of a stream
+    """
+    for line in stream:
+        fields = line.split()
+        if len(fields) == 3 and fields[0] == 'time_budget' and fields[1] in model:
+            model[fields[1]] = float(fields[2])
+
+    return model
+
+
+def points_get(config):
+    """
+    Number of points measured in each sweep
+    """
+    step_m = SPARSE_POINT_STEP_M if config['service'] == 'sparse' else POINT_STEP_M
+    points = config['length'] / (step_m * max(config['downsampling'], 1))
+
+    return 1 if points < 0 else min(int(points) + 1, 0xffff)
+
+
+def estimate(model, config):
+    """
+    Estimate the time budget of a configuration, as acc_time_budget_estimate
+    """
+    service = config['service']
+    points = points_get(config)
+    sweeps = max(config['sweeps_per_frame'], 1)
+    prf_factor = MUR_6_PRF_MHZ / MUR_9_PRF_MHZ if config['mur'] == 9 else 1.0
+    point_us = model[f'point_us.{config["profile"]}'] * prf_factor
+    violations = []
+
+    sweep_us = model['sweep_overhead_us'] + points * config['hwaas'] * point_us
+    sweep_period_us = sweep_us
+
+    if config['sweep_rate'] > 0:
+        requested_period_us = 1e6 / config['sweep_rate']
+        if sweep_us > requested_period_us:
+            violations.append('sweep rate too high')
+        else:
+            sweep_period_us = requested_period_us
+
+    measure_us = (sweeps - 1) * sweep_period_us + sweep_us
+
+    transfer_us = 0.0
+    if config['spi_clock'] > 0:
+        point_bytes = SPARSE_POINT_BYTES if service == 'sparse' else POINT_BYTES
+        transfer_us = points * point_bytes * 8 * 1e6 / config['spi_clock']
+
+    spi_us = sweeps * (transfer_us * model['spi_scale'] + model['spi_overhead_us'])
+    processing_us = (model[f'processing_overhead_us.{service}'] +
+                     points * sweeps * model[f'processing_point_us.{service}'])
+
+    if config['asynchronous']:
+        frame_us = spi_us + max(measure_us, processing_us)
+    else:
+        frame_us = measure_us + spi_us + processing_us
+
+    max_update_rate_hz = 1e6 / frame_us
+
+    if config['update_rate'] > max_update_rate_hz:
+        violations.append('update rate too high')
+
+    return {
+        'points': points,
+        'sweep_us': sweep_us,
+        'measure_us': measure_us,
+        'spi_us': spi_us,
+        'processing_us': processing_us,
+        'frame_us': frame_us,
+        'max_update_rate_hz': max_update_rate_hz,
+        'violations': violations,
+    }
+
+
+def config_from_args(args):
+    """
+    A configuration from the command line options
+    """
+    config = dict(DEFAULTS)
+    for key in DEFAULTS:
+        value = getattr(args, key, None)
+        if value is not None:
+            config[key] = value
+
+    return config
+
+
+def check_config(config):
+    """
+    Validate a configuration, raises ValueError
+    """
+    if config['service'] not in SERVICES:
+        raise ValueError(f'unknown service {config["service"]}, use one of {", ".join(SERVICES)}')
+    if not 1 <= config['profile'] <= PROFILE_COUNT:
+        raise ValueError(f'profile {config["profile"]} out of range')
+    if config['mur'] not in (6, 9):
+        raise ValueError(f'mur {config["mur"]} is not 6 or 9')
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Estimate the measurement time budget of service configurations')
+    parser.add_argument('--model', help='Captured output of example_time_budget with the calibrated model')
+    parser.add_argument('--configs', help='JSON file with a list of configurations')
+    parser.add_argument('--name', help='Name of the configuration')
+    parser.add_argument('--service', choices=SERVICES, help='Service type')
+    parser.add_argument('--profile', type=int, help='Profile, 1 to 5')
+    parser.add_argument('--mur', type=int, help='Maximum unambiguous range, 6 or 9')
+    parser.add_argument('--hwaas', type=int, help='Hardware accelerated average samples')
+    parser.add_argument('--start', type=float, help='Start in m')
+    parser.add_argument('--length', type=float, help='Length in m')
+    parser.add_argument('--downsampling', type=int, help='Downsampling factor')
+    parser.add_argument('--sweeps-per-frame', dest='sweeps_per_frame', type=int, help='Sparse sweeps per frame')
+    parser.add_argument('--sweep-rate', dest='sweep_rate', type=float, help='Sparse sweep rate in Hz')
+    parser.add_argument('--update-rate', dest='update_rate', type=float, help='Update rate in Hz to check')
+    parser.add_argument('--synchronous', dest='asynchronous', action='store_false', default=None,
+                        help='Asynchronous measurement disabled')
+    parser.add_argument('--spi-clock', dest='spi_clock', type=int, help='SPI clock in Hz')
+
+    args = parser.parse_args()
+
+    model = default_model()
+    if args.model is not None:
+        with open(args.model, 'r', encoding='utf-8', errors='replace') as model_file:
+            read_model(model_file, model)
+
+    if args.configs is not None:
+        with open(args.configs, 'r', encoding='utf-8') as configs_file:
+            configs = [dict(DEFAULTS, **config) for config in json.load(configs_file)]
+    else:
+        configs = [config_from_args(args)]
+
+    infeasible = 0
+
+    for index, config in enumerate(configs):
+        try:
+            check_config(config)
+        except ValueError as error:
+            print(f'{config["name"] or index}: {error}', file=sys.stderr)
+            return 2
+
+        result = estimate(model, config)
+        status = ', '.join(result['violations']) if result['violations'] else 'ok'
+
+        print(f'{config["name"] or index}: {result["points"]} points, '
+              f'sweep {result["sweep_us"]:.0f} us, measure {result["measure_us"]:.0f} us, '
+              f'spi {result["spi_us"]:.0f} us, processing {result["processing_us"]:.0f} us, '
+              f'frame {result["frame_us"]:.0f} us, max rate {result["max_update_rate_hz"]:.1f} Hz: {status}')
+
+        if result['violations']:
+            infeasible += 1
+
+    if infeasible > 0:
+        print(f'{infeasible} of {len(configs)} configurations do not fit their time budget', file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,119 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+
+#ifndef CMSIS_COMPILER_H_
+#define CMSIS_COMPILER_H_
+
+#include <stdint.h>
+
+
+/**
+ * Host emulation of the CMSIS DSP extension intrinsics used by acc_simd.h
+ *
+ * Only for the host tests. Built with __ARM_FEATURE_DSP=1 and this directory on the
+ * include path, acc_simd.h takes the intrinsic path, so that the kernels can be compared
+ * with the ACC_SIMD_DISABLE build without a Cortex-M4. The emulation follows the
+ * instruction descriptions in the Armv7-M Architecture Reference Manual and is written
+ * independently of the portable C in acc_simd.h. The GE flags are not emulated.
+ */
+
+
+static inline int32_t emulation_half(uint32_t x, unsigned int half)
+{
+	return (int32_t)(int16_t)(uint16_t)(x >> (16U * half));
+}
+
+
+static inline uint32_t emulation_uhalf(uint32_t x, unsigned int half)
+{
+	return (x >> (16U * half)) & 0xffffU;
+}
+
+
+static inline uint32_t emulation_signed_sat16(int32_t value)
+{
+	if (value > 32767)
+	{
+		value = 32767;
+	}
+	else if (value < -32768)
+	{
+		value = -32768;
+	}
+
+	return (uint32_t)value & 0xffffU;
+}
+
+
+static inline uint32_t __QADD16(uint32_t x, uint32_t y)
+{
+	return emulation_signed_sat16(emulation_half(x, 0) + emulation_half(y, 0)) |
+	       (emulation_signed_sat16(emulation_half(x, 1) + emulation_half(y, 1)) << 16);
+}
+
+
+static inline uint32_t __QSUB16(uint32_t x, uint32_t y)
+{
+	return emulation_signed_sat16(emulation_half(x, 0) - emulation_half(y, 0)) |
+	       (emulation_signed_sat16(emulation_half(x, 1) - emulation_half(y, 1)) << 16);
+}
+
+
+static inline uint32_t __UADD16(uint32_t x, uint32_t y)
+{
+	return ((emulation_uhalf(x, 0) + emulation_uhalf(y, 0)) & 0xffffU) |
+	       (((emulation_uhalf(x, 1) + emulation_uhalf(y, 1)) & 0xffffU) << 16);
+}
+
+
+static inline uint32_t __UQSUB16(uint32_t x, uint32_t y)
+{
+	int32_t low  = (int32_t)emulation_uhalf(x, 0) - (int32_t)emulation_uhalf(y, 0);
+	int32_t high = (int32_t)emulation_uhalf(x, 1) - (int32_t)emulation_uhalf(y, 1);
+
+	return (uint32_t)(low < 0 ? 0 : low) | ((uint32_t)(high < 0 ? 0 : high) << 16);
+}
+
+
+static inline uint32_t __UHSUB16(uint32_t x, uint32_t y)
+{
+	// Bits 16:1 of the 17 bit signed difference
+	int32_t low  = (int32_t)emulation_uhalf(x, 0) - (int32_t)emulation_uhalf(y, 0);
+	int32_t high = (int32_t)emulation_uhalf(x, 1) - (int32_t)emulation_uhalf(y, 1);
+
+	return (((uint32_t)low >> 1) & 0xffffU) | ((((uint32_t)high >> 1) & 0xffffU) << 16);
+}
+
+
+static inline uint32_t __SMUAD(uint32_t x, uint32_t y)
+{
+	int64_t sum = (int64_t)emulation_half(x, 0) * emulation_half(y, 0) + (int64_t)emulation_half(x, 1) * emulation_half(y, 1);
+
+	return (uint32_t)(uint64_t)sum;
+}
+
+
+static inline uint32_t __SMUSDX(uint32_t x, uint32_t y)
+{
+	int64_t difference = (int64_t)emulation_half(x, 0) * emulation_half(y, 1) -
+	                     (int64_t)emulation_half(x, 1) * emulation_half(y, 0);
+
+	return (uint32_t)(uint64_t)difference;
+}
+
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t acc)
+{
+	return __SMUAD(x, y) + acc;
+}
+
+
+static inline uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t acc)
+{
+	int64_t sum = (int64_t)emulation_half(x, 0) * emulation_half(y, 0) + (int64_t)emulation_half(x, 1) * emulation_half(y, 1);
+
+	return acc + (uint64_t)sum;
+}
+
+
+#endif
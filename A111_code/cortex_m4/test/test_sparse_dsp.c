@@ -0,0 +1,333 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acc_sparse_dsp.h"
+
+
+/**
+ * Host test of the sparse frame processing
+ *
+ * The kernels are compared with a scalar reference of the same algorithm: the mean is
+ * rounded to an integer before the DC removal, the deviations saturate to signed 16 bit
+ * and the sums are exact. Mean, variance, energy and correlation are compared for even and
+ * odd sweep counts and sweep lengths, with random, full scale and saturating input.
+ *
+ * The test is built once with ACC_SIMD_DISABLE, the portable C kernels, and once with
+ * __ARM_FEATURE_DSP and the emulated intrinsics in test/cmsis_emulation, see
+ * cmake/host.cmake. Both must match the reference, and so each other.
+ */
+
+#ifndef TEST_SPARSE_DSP_KERNEL
+#define TEST_SPARSE_DSP_KERNEL "portable C"
+#endif
+
+#define MAX_SWEEPS_PER_FRAME 64
+#define MAX_SWEEP_LENGTH     16
+#define FILTER_FACTOR        0.75f
+
+#define SPARSE_OFFSET 32768
+
+
+typedef enum
+{
+	INPUT_RANDOM,
+	INPUT_FULL_SCALE_HIGH,
+	INPUT_FULL_SCALE_LOW,
+	INPUT_FULL_SCALE_ALTERNATING,
+	INPUT_SPIKE,
+	INPUT_SINUSOID,
+	INPUT_COUNT
+} input_t;
+
+
+static const char *input_names[INPUT_COUNT] =
+{
+	[INPUT_RANDOM]                 = "random",
+	[INPUT_FULL_SCALE_HIGH]        = "full scale high",
+	[INPUT_FULL_SCALE_LOW]         = "full scale low",
+	[INPUT_FULL_SCALE_ALTERNATING] = "full scale alternating",
+	[INPUT_SPIKE]                  = "spike",
+	[INPUT_SINUSOID]               = "sinusoid",
+};
+
+
+/**
+ * @brief The reference results of one point
+ */
+typedef struct
+{
+	float   mean;
+	int64_t energy;
+	int64_t correlation;
+	/** Sum of the squared deviations from the exact mean, without rounding or saturation */
+	double  exact_energy;
+	bool    saturated;
+} reference_t;
+
+
+static uint32_t random_state = 1;
+
+
+static uint16_t random_u16(void);
+
+
+static void generate_frame(uint16_t *frame, input_t input, uint16_t sweeps, uint16_t length, uint32_t frame_index);
+
+
+static void reference_point(const uint16_t *frame, uint16_t sweeps, uint16_t length, uint16_t point, reference_t *reference);
+
+
+static uint32_t check_frame(const acc_sparse_dsp_t *dsp, const uint16_t *frame, const float *previous_filtered, const char *name);
+
+
+static uint32_t failure(const char *name, uint16_t point, const char *quantity, double value, double expected);
+
+
+int main(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	static const uint16_t sweep_counts[]  = { 1, 2, 3, 7, 16, 31, 32, 63, 64 };
+	static const uint16_t sweep_lengths[] = { 1, 2, 5, 16 };
+
+	printf("Sparse DSP kernels: %s\n", acc_sparse_dsp_kernel_name());
+
+	if (strcmp(acc_sparse_dsp_kernel_name(), TEST_SPARSE_DSP_KERNEL) != 0)
+	{
+		printf("Expected the %s kernels\n", TEST_SPARSE_DSP_KERNEL);
+		return EXIT_FAILURE;
+	}
+
+	uint32_t cases    = 0;
+	uint32_t failures = 0;
+
+	for (size_t s = 0; s < sizeof(sweep_counts) / sizeof(sweep_counts[0]); s++)
+	{
+		for (size_t l = 0; l < sizeof(sweep_lengths) / sizeof(sweep_lengths[0]); l++)
+		{
+			for (input_t input = 0; input < INPUT_COUNT; input++)
+			{
+				uint16_t         sweeps = sweep_counts[s];
+				uint16_t         length = sweep_lengths[l];
+				acc_sparse_dsp_t dsp;
+
+				if (!acc_sparse_dsp_create(&dsp, sweeps, length, 1000.0f, FILTER_FACTOR))
+				{
+					printf("acc_sparse_dsp_create() failed\n");
+					return EXIT_FAILURE;
+				}
+
+				char name[64];
+
+				snprintf(name, sizeof(name), "%u sweeps x %u points, %s", (unsigned int)sweeps, (unsigned int)length,
+				         input_names[input]);
+
+				uint16_t frame[MAX_SWEEPS_PER_FRAME * MAX_SWEEP_LENGTH];
+				float    previous_filtered[MAX_SWEEP_LENGTH];
+
+				// Two frames, the second also checks the filtered energy
+				for (uint32_t frame_index = 0; frame_index < 2; frame_index++)
+				{
+					memcpy(previous_filtered, dsp.filtered_energy, length * sizeof(previous_filtered[0]));
+
+					generate_frame(frame, input, sweeps, length, frame_index);
+					acc_sparse_dsp_process(&dsp, frame);
+
+					failures += check_frame(&dsp, frame, previous_filtered, name);
+					cases++;
+				}
+
+				acc_sparse_dsp_destroy(&dsp);
+			}
+		}
+	}
+
+	printf("%u frames checked, %u failures\n", (unsigned int)cases, (unsigned int)failures);
+
+	return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+uint16_t random_u16(void)
+{
+	random_state = (random_state * 1103515245U) + 12345U;
+
+	return (uint16_t)(random_state >> 16);
+}
+
+
+void generate_frame(uint16_t *frame, input_t input, uint16_t sweeps, uint16_t length, uint32_t frame_index)
+{
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		for (uint16_t point = 0; point < length; point++)
+		{
+			uint16_t value;
+
+			switch (input)
+			{
+				case INPUT_FULL_SCALE_HIGH:
+					value = UINT16_MAX;
+					break;
+				case INPUT_FULL_SCALE_LOW:
+					value = 0;
+					break;
+				case INPUT_FULL_SCALE_ALTERNATING:
+					value = ((sweep + point + frame_index) % 2 == 0) ? UINT16_MAX : 0;
+					break;
+				case INPUT_SPIKE:
+					// Deviations beyond the signed 16 bit range, the DC removal saturates
+					value = (sweep == (point + frame_index) % sweeps) ? UINT16_MAX : (uint16_t)(random_u16() % 16U);
+					break;
+				case INPUT_SINUSOID:
+				{
+					double phase = (0.3 + 0.1 * point) * sweep + frame_index;
+
+					value = (uint16_t)lround(SPARSE_OFFSET + (point + 1) * 2000.0 * sin(phase));
+					break;
+				}
+				case INPUT_RANDOM:
+				default:
+					value = random_u16();
+					break;
+			}
+
+			frame[(sweep * length) + point] = value;
+		}
+	}
+}
+
+
+void reference_point(const uint16_t *frame, uint16_t sweeps, uint16_t length, uint16_t point, reference_t *reference)
+{
+	uint32_t sum = 0;
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		sum += frame[(sweep * length) + point];
+	}
+
+	double  exact_mean   = (double)sum / sweeps;
+	int32_t rounded_mean = (int32_t)((sum + (sweeps / 2U)) / sweeps);
+	int32_t deviation[MAX_SWEEPS_PER_FRAME];
+
+	reference->mean         = (float)sum / (float)sweeps;
+	reference->energy       = 0;
+	reference->correlation  = 0;
+	reference->exact_energy = 0.0;
+	reference->saturated    = false;
+
+	for (uint16_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		int32_t value = frame[(sweep * length) + point];
+		double  exact = value - exact_mean;
+
+		deviation[sweep] = value - rounded_mean;
+
+		if (deviation[sweep] > INT16_MAX || deviation[sweep] < INT16_MIN)
+		{
+			deviation[sweep]     = (deviation[sweep] > INT16_MAX) ? INT16_MAX : INT16_MIN;
+			reference->saturated = true;
+		}
+
+		reference->energy       += (int64_t)deviation[sweep] * deviation[sweep];
+		reference->exact_energy += exact * exact;
+
+		if (sweep > 0)
+		{
+			reference->correlation += (int64_t)deviation[sweep - 1] * deviation[sweep];
+		}
+	}
+}
+
+
+uint32_t check_frame(const acc_sparse_dsp_t *dsp, const uint16_t *frame, const float *previous_filtered, const char *name)
+{
+	uint16_t sweeps         = dsp->sweeps_per_frame;
+	uint16_t length         = dsp->sweep_length;
+	uint32_t failures       = 0;
+	float    highest_energy = -1.0f;
+	uint16_t strongest      = 0;
+
+	for (uint16_t point = 0; point < length; point++)
+	{
+		reference_t reference;
+
+		reference_point(frame, sweeps, length, point, &reference);
+
+		if (dsp->mean[point] != reference.mean)
+		{
+			failures += failure(name, point, "mean", (double)dsp->mean[point], (double)reference.mean);
+		}
+
+		if (dsp->energy[point] != (float)reference.energy)
+		{
+			failures += failure(name, point, "energy", (double)dsp->energy[point], (double)reference.energy);
+		}
+
+		if (dsp->variance[point] != (float)reference.energy / (float)sweeps)
+		{
+			failures += failure(name, point, "variance", (double)dsp->variance[point], (double)reference.energy / sweeps);
+		}
+
+		// The mean is rounded by at most one half, which adds at most sweeps / 4 to the energy
+		if (!reference.saturated &&
+		    fabs((double)reference.energy - reference.exact_energy) > sweeps / 4.0 + 1e-9 * reference.exact_energy)
+		{
+			failures += failure(name, point, "exact energy", (double)reference.energy, reference.exact_energy);
+		}
+
+		double correlation = 0.0;
+
+		if (reference.energy > 0 && sweeps > 1)
+		{
+			correlation = (double)reference.correlation * sweeps / (sweeps - 1.0) / (double)reference.energy;
+		}
+
+		if (fabs((double)dsp->correlation[point] - correlation) > 1e-5)
+		{
+			failures += failure(name, point, "correlation", (double)dsp->correlation[point], correlation);
+		}
+
+		double filter_factor = (dsp->frames > 1) ? (double)FILTER_FACTOR : 0.0;
+		double filtered      = filter_factor * (double)previous_filtered[point] + (1.0 - filter_factor) * (double)reference.energy;
+
+		if (fabs((double)dsp->filtered_energy[point] - filtered) > 1e-6 * fabs(filtered) + 1e-6)
+		{
+			failures += failure(name, point, "filtered energy", (double)dsp->filtered_energy[point], filtered);
+		}
+
+		// Compared as float, as in the processing
+		if ((float)reference.energy > highest_energy)
+		{
+			highest_energy = (float)reference.energy;
+			strongest      = point;
+		}
+	}
+
+	if (dsp->strongest_point != strongest)
+	{
+		failures += failure(name, dsp->strongest_point, "strongest point", dsp->strongest_point, strongest);
+	}
+
+	return failures;
+}
+
+
+uint32_t failure(const char *name, uint16_t point, const char *quantity, double value, double expected)
+{
+	printf("%s, point %u: %s %.9g, expected %.9g\n", name, (unsigned int)point, quantity, value, expected);
+
+	return 1;
+}
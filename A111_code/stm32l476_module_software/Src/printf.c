@@ -64,6 +64,15 @@
 #define PRINTF_SUPPORT_FLOAT
 #endif
 
+// support for the floating point type (%f) using integer math only, the IEEE 754
+// bits of the argument are decoded and formatted without any floating point
+// operations. Preferred over PRINTF_SUPPORT_FLOAT for %f on targets where double
+// is software emulated, for example a Cortex-M4F. Works with float support disabled.
+// default: activated
+#ifndef PRINTF_DISABLE_SUPPORT_FLOAT_FIXED_POINT
+#define PRINTF_SUPPORT_FLOAT_FIXED_POINT
+#endif
+
 // support for exponential floating point notation (%e/%g)
 // default: activated
 #ifndef PRINTF_DISABLE_SUPPORT_EXPONENTIAL
@@ -76,7 +85,8 @@
 #define PRINTF_DEFAULT_FLOAT_PRECISION  6U
 #endif
 
-// define the largest float suitable to print with %f
+// define the largest float suitable to print with %f by the double formatter, the
+// integer only formatter prints whole parts up to 2^64
 // default: 1e9
 #ifndef PRINTF_MAX_FLOAT
 #define PRINTF_MAX_FLOAT  1e9
@@ -334,6 +344,7 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 #endif
 
 
+#if !defined(PRINTF_SUPPORT_FLOAT_FIXED_POINT) || defined(PRINTF_SUPPORT_EXPONENTIAL)
 // internal ftoa for fixed decimal floating point
 static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, double value, unsigned int prec, unsigned int width, unsigned int flags)
 {
@@ -459,6 +470,7 @@ static size_t _ftoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 
   return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
 }
+#endif
 
 
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
@@ -572,6 +584,158 @@ static size_t _etoa(out_fct_type out, char* buffer, size_t idx, size_t maxlen, d
 #endif  // PRINTF_SUPPORT_FLOAT
 
 
+#if defined(PRINTF_SUPPORT_FLOAT_FIXED_POINT)
+// internal ftoa for fixed decimal floating point using integer math only
+// value is the IEEE 754 double precision bit pattern, which is exact for float arguments
+// promoted to double. The result is correctly rounded, round half to even.
+static size_t _ftoa_fixed(out_fct_type out, char* buffer, size_t idx, size_t maxlen, uint64_t value, unsigned int prec, unsigned int width, unsigned int flags)
+{
+  char buf[PRINTF_FTOA_BUFFER_SIZE];
+  size_t len = 0U;
+
+  // powers of 10
+  static const uint32_t pow10[] = { 1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U };
+
+  const bool negative = (value >> 63U) != 0U;
+  const unsigned int exp2 = (unsigned int)((value >> 52U) & 0x07FFU);
+  uint64_t mantissa = value & ((1ULL << 52U) - 1U);
+
+  // test for special values
+  if (exp2 == 0x07FFU) {
+    if (mantissa) {
+      return _out_rev(out, buffer, idx, maxlen, "nan", 3, width, flags);
+    }
+    if (negative) {
+      return _out_rev(out, buffer, idx, maxlen, "fni-", 4, width, flags);
+    }
+    return _out_rev(out, buffer, idx, maxlen, (flags & FLAGS_PLUS) ? "fni+" : "fni", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
+  }
+
+  // value is mantissa / 2^shift
+  unsigned int shift = 1074U;
+  if (exp2) {
+    mantissa |= 1ULL << 52U;
+    shift = 1075U - exp2;
+  }
+
+  // split in whole part and fractional part, the fraction is scaled by 2^64
+  uint64_t whole = 0U;
+  uint64_t frac = 0U;
+  bool sticky = false;
+  if (exp2 >= 1075U) {
+    // integer value, the whole part fits in 64 bits up to 2^64
+    if (exp2 - 1075U > 11U) {
+#if defined(PRINTF_SUPPORT_FLOAT) && defined(PRINTF_SUPPORT_EXPONENTIAL)
+      union {
+        uint64_t U;
+        double   F;
+      } conv;
+      conv.U = value;
+      return _etoa(out, buffer, idx, maxlen, conv.F, prec, width, flags);
+#else
+      // overflow marker
+      if (negative) {
+        return _out_rev(out, buffer, idx, maxlen, "fvo-", 4, width, flags);
+      }
+      return _out_rev(out, buffer, idx, maxlen, (flags & FLAGS_PLUS) ? "fvo+" : "fvo", (flags & FLAGS_PLUS) ? 4U : 3U, width, flags);
+#endif
+    }
+    whole = mantissa << (exp2 - 1075U);
+  }
+  else if (shift < 64U) {
+    whole = mantissa >> shift;
+    frac = (mantissa & ((1ULL << shift) - 1U)) << (64U - shift);
+  }
+  else if (shift == 64U) {
+    frac = mantissa;
+  }
+  else if (shift < 128U) {
+    frac = mantissa >> (shift - 64U);
+    sticky = (mantissa & ((1ULL << (shift - 64U)) - 1U)) != 0U;
+  }
+  else {
+    sticky = mantissa != 0U;
+  }
+
+  // set default precision, if not set explicitly
+  if (!(flags & FLAGS_PRECISION)) {
+    prec = PRINTF_DEFAULT_FLOAT_PRECISION;
+  }
+  // limit precision to 9, the decimals must fit in 32 bits
+  while ((len < PRINTF_FTOA_BUFFER_SIZE) && (prec > 9U)) {
+    buf[len++] = '0';
+    prec--;
+  }
+
+  // decimals = frac * 10^prec / 2^64, the remainder is kept scaled by 2^64 for rounding
+  const uint64_t lo = (frac & 0xFFFFFFFFU) * pow10[prec];
+  const uint64_t hi = (frac >> 32U) * pow10[prec] + (lo >> 32U);
+  uint32_t decimals = (uint32_t)(hi >> 32U);
+  const uint64_t rem = (hi << 32U) | (lo & 0xFFFFFFFFU);
+  const uint64_t half = 1ULL << 63U;
+  const bool odd = ((prec ? decimals : whole) & 1U) != 0U;
+
+  if ((rem > half) || ((rem == half) && (sticky || odd))) {
+    ++decimals;
+    // handle rollover, e.g. case 0.99 with prec 1 is 1.0
+    if (decimals >= pow10[prec]) {
+      decimals = 0U;
+      ++whole;
+    }
+  }
+
+  if (prec > 0U) {
+    // do fractional part, number is reversed
+    for (unsigned int count = 0U; (count < prec) && (len < PRINTF_FTOA_BUFFER_SIZE); count++) {
+      buf[len++] = (char)(48U + (decimals % 10U));
+      decimals /= 10U;
+    }
+    if (len < PRINTF_FTOA_BUFFER_SIZE) {
+      // add decimal
+      buf[len++] = '.';
+    }
+  }
+
+  // do whole part, number is reversed, with 64-bit divisions only for the upper digits
+  while ((len < PRINTF_FTOA_BUFFER_SIZE) && (whole > 0xFFFFFFFFU)) {
+    buf[len++] = (char)(48U + (unsigned int)(whole % 10U));
+    whole /= 10U;
+  }
+  uint32_t whole32 = (uint32_t)whole;
+  while (len < PRINTF_FTOA_BUFFER_SIZE) {
+    buf[len++] = (char)(48U + (whole32 % 10U));
+    if (!(whole32 /= 10U)) {
+      break;
+    }
+  }
+
+  // pad leading zeros
+  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
+    if (width && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
+      width--;
+    }
+    while ((len < width) && (len < PRINTF_FTOA_BUFFER_SIZE)) {
+      buf[len++] = '0';
+    }
+  }
+
+  if (len < PRINTF_FTOA_BUFFER_SIZE) {
+    if (negative) {
+      buf[len++] = '-';
+    }
+    else if (flags & FLAGS_PLUS) {
+      buf[len++] = '+';  // ignore the space if the '+' exists
+    }
+    else if (flags & FLAGS_SPACE) {
+      buf[len++] = ' ';
+    }
+  }
+
+  return _out_rev(out, buffer, idx, maxlen, buf, len, width, flags);
+}
+#endif  // PRINTF_SUPPORT_FLOAT_FIXED_POINT
+
+
 // internal vsnprintf
 static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const char* format, va_list va)
 {
@@ -753,13 +917,29 @@ static int _vsnprintf(out_fct_type out, char* buffer, const size_t maxlen, const
         format++;
         break;
       }
-#if defined(PRINTF_SUPPORT_FLOAT)
+#if defined(PRINTF_SUPPORT_FLOAT_FIXED_POINT)
+      case 'f' :
+      case 'F' : {
+        // only the bits are copied, the value never goes through double math
+        union {
+          uint64_t U;
+          double   F;
+        } conv;
+        if (*format == 'F') flags |= FLAGS_UPPERCASE;
+        conv.F = va_arg(va, double);
+        idx = _ftoa_fixed(out, buffer, idx, maxlen, conv.U, precision, width, flags);
+        format++;
+        break;
+      }
+#elif defined(PRINTF_SUPPORT_FLOAT)
       case 'f' :
       case 'F' :
         if (*format == 'F') flags |= FLAGS_UPPERCASE;
         idx = _ftoa(out, buffer, idx, maxlen, va_arg(va, double), precision, width, flags);
         format++;
         break;
+#endif  // PRINTF_SUPPORT_FLOAT_FIXED_POINT
+#if defined(PRINTF_SUPPORT_FLOAT)
 #if defined(PRINTF_SUPPORT_EXPONENTIAL)
       case 'e':
       case 'E':
@@ -0,0 +1,129 @@
+// Copyright (c) Acconeer AB, 2023
+// All rights reserved
+// This file is subject to the terms and conditions defined in the file
+// 'LICENSES/license_acconeer.txt', (BSD 3-Clause License) which is part
+// of this source code package.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "acc_integration.h"
+#include "printf.h"
+
+
+/**
+ * Host benchmark of %f in the embedded printf
+ *
+ * Built once with the integer only formatter, as printf.o of the module software, and once
+ * with the double formatter, see cmake/host.cmake. The formatted strings are checked
+ * against known results before the time per call is printed. On the host double
+ * arithmetic is done in hardware, the difference on the target, where it is software
+ * emulated, is larger.
+ */
+
+#ifndef PRINTF_BENCHMARK_VARIANT
+#define PRINTF_BENCHMARK_VARIANT "fixed point"
+#endif
+
+#define ITERATIONS 100000
+#define VALUE_COUNT 8
+
+
+/**
+ * @brief A format and a value with the expected result
+ */
+typedef struct
+{
+	const char *format;
+	double     value;
+	const char *expected;
+} format_check_t;
+
+
+static const format_check_t format_checks[] =
+{
+	{ "%.3f",   0.0005,       "0.001"                 },
+	{ "%.3f",   0.0015,       "0.002"                 },
+	{ "%f",     -2.5,         "-2.500000"             },
+	{ "%.0f",   2.5,          "2"                     },
+	{ "%+8.2f", 1.005,        "   +1.00"              },
+	{ "%08.1f", -12.25,       "-00012.2"              },
+	{ "%.3f",   123456.789,   "123456.789"            },
+#if defined(PRINTF_DISABLE_SUPPORT_FLOAT)
+	// Above PRINTF_MAX_FLOAT the double formatter needs exponential support, which the module software leaves out
+	{ "%.1f",   4294967295.5, "4294967295.5"          },
+	{ "%.0f",   1e10,         "10000000000"           },
+	{ "%.0f",   -1e19,        "-10000000000000000000" },
+	{ "%.1f",   1e20,         "ovf"                   },
+#endif
+};
+
+
+static const float benchmark_values[VALUE_COUNT] =
+{
+	0.0f, 1.25f, -3.14159f, 42.5f, 0.001f, -999.999f, 123456.789f, 0.5f
+};
+
+
+static bool check_formats(void);
+
+
+void _putchar(char character);
+
+
+void _putchar(char character)
+{
+	putchar(character);
+}
+
+
+int main(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+
+	if (!check_formats())
+	{
+		return EXIT_FAILURE;
+	}
+
+	char     buffer[32];
+	uint32_t length = 0;
+	uint32_t start  = acc_integration_get_cycle_count();
+
+	for (uint32_t i = 0; i < ITERATIONS; i++)
+	{
+		length += (uint32_t)snprintf_(buffer, sizeof(buffer), "%.3f", (double)benchmark_values[i % VALUE_COUNT]);
+	}
+
+	uint32_t cycles = acc_integration_get_cycle_count() - start;
+
+	printf_("printf %%.3f %-16s %8u cycles per call, %u characters\n", PRINTF_BENCHMARK_VARIANT,
+	        (unsigned int)(cycles / ITERATIONS), (unsigned int)length);
+
+	return EXIT_SUCCESS;
+}
+
+
+bool check_formats(void)
+{
+	bool success = true;
+
+	for (size_t i = 0; i < sizeof(format_checks) / sizeof(format_checks[0]); i++)
+	{
+		char buffer[64];
+
+		snprintf_(buffer, sizeof(buffer), format_checks[i].format, format_checks[i].value);
+
+		if (strcmp(buffer, format_checks[i].expected) != 0)
+		{
+			printf_("%s: \"%s\", expected \"%s\"\n", format_checks[i].format, buffer, format_checks[i].expected);
+			success = false;
+		}
+	}
+
+	return success;
+}
@@ -0,0 +1,134 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2023
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Size and benchmark comparison of the module software build profiles.
+Builds each profile with 'make ACC_CFG_BUILD_PROFILE=<profile>' and reads the
+section sizes from the out/<profile>/acc_module_server_size.txt written by the
+link step. With --port each profile is also flashed with OpenOCD and
+benchmarked with module_server_benchmark.py on the module at that port.
+
+The report lists flash and RAM use per profile, the difference to the first
+profile and the benchmark results, to pick the profile for the flash and
+latency budget.
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+PROFILES = ['size', 'speed', 'debug']
+
+# Must match STM32L476RGTx_FLASH.ld
+FLASH_SIZE = 1024 * 1024
+RAM_SIZE = 96 * 1024
+
+MODULE_SOFTWARE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def read_size(profile):
+    """
+    Read text, data and bss from the Berkeley format output of size for a profile
+    """
+    path = os.path.join(MODULE_SOFTWARE_DIR, 'out', profile, 'acc_module_server_size.txt')
+
+    with open(path, 'r', encoding='utf-8') as size_file:
+        for line in size_file:
+            fields = line.split()
+            if len(fields) >= 3 and fields[0].isdigit():
+                text, data, bss = (int(field) for field in fields[:3])
+                return {'flash': text + data, 'ram': data + bss}
+
+    raise ValueError(f'No sizes in {path}')
+
+
+def run_make(profile, target=None):
+    """
+    Run make for a profile, returns True if successful
+    """
+    command = ['make', f'ACC_CFG_BUILD_PROFILE={profile}']
+    if target is not None:
+        command.append(target)
+
+    return subprocess.run(command, cwd=MODULE_SOFTWARE_DIR, check=False).returncode == 0
+
+
+def run_benchmark(args):
+    """
+    Run module_server_benchmark.py on the flashed module, returns the output lines
+    """
+    command = [sys.executable, os.path.join(MODULE_SOFTWARE_DIR, 'script', 'module_server_benchmark.py'),
+               '--port', args.port, '--duration', str(args.duration), '--modes'] + args.modes
+    result = subprocess.run(command, cwd=MODULE_SOFTWARE_DIR, capture_output=True, text=True, check=False)
+
+    if result.returncode != 0:
+        return [f'benchmark failed: {result.stderr.strip()}']
+
+    return [line for line in result.stdout.splitlines() if line.strip()]
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Compare size and speed of the module software build profiles')
+    parser.add_argument('--profiles', nargs='+', choices=PROFILES, default=PROFILES,
+                        help='Profiles to compare, the first is the reference')
+    parser.add_argument('--no-build', action='store_true',
+                        help='Use the existing builds in out/<profile>')
+    parser.add_argument('--port',
+                        help='Serial port of the module, flash and benchmark each profile')
+    parser.add_argument('--duration', default=5, type=float,
+                        help='Duration in seconds of each benchmark throughput test')
+    parser.add_argument('--modes', nargs='+', default=['envelope', 'sparse'],
+                        help='Streaming modes to benchmark')
+
+    args = parser.parse_args()
+
+    sizes = {}
+    benchmarks = {}
+
+    for profile in args.profiles:
+        if not args.no_build and not run_make(profile):
+            print(f'Build of profile {profile} failed', file=sys.stderr)
+            return 1
+
+        try:
+            sizes[profile] = read_size(profile)
+        except (OSError, ValueError) as error:
+            print(error, file=sys.stderr)
+            return 1
+
+        if args.port is not None:
+            if not run_make(profile, 'flash_acc_module_server'):
+                print(f'Flashing profile {profile} failed', file=sys.stderr)
+                return 1
+            benchmarks[profile] = run_benchmark(args)
+
+    reference = sizes[args.profiles[0]]
+
+    print(f'{"profile":<8} {"flash":>8} {"diff":>8} {"of 1 MB":>8} {"ram":>8} {"diff":>8} {"of 96 KB":>8}')
+    for profile in args.profiles:
+        size = sizes[profile]
+        print(f'{profile:<8} {size["flash"]:8d} {size["flash"] - reference["flash"]:+8d} '
+              f'{100.0 * size["flash"] / FLASH_SIZE:7.1f}% '
+              f'{size["ram"]:8d} {size["ram"] - reference["ram"]:+8d} '
+              f'{100.0 * size["ram"] / RAM_SIZE:7.1f}%')
+
+    for profile, lines in benchmarks.items():
+        print(f'Benchmark {profile}')
+        for line in lines:
+            print(f'  {line.strip()}')
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
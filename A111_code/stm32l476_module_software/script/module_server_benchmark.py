@@ -0,0 +1,213 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2020-2022
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+Benchmark and soak test of the module software UART protocol. Without
+hardware the client from module_software_example.py talks over a
+pseudo-terminal pair to the simulated module in module_server_simulator.py.
+With --port it talks to a module on a serial port, for example to compare
+builds of the module software.
+
+Reported per run:
+  - register read round trip latency percentiles
+  - register mode frames per second with status polling and notifications
+  - streaming frames per second and throughput per mode
+  - client side errors and module side overruns and framing errors
+"""
+import argparse
+import os
+import pty
+import sys
+import time
+import tty
+
+from module_server_simulator import (DEFAULT_MAX_BAUDRATE, MODE_DISTANCE, MODE_ENVELOPE, MODE_IQ, MODE_POWER_BINS,
+                                     MODE_PRESENCE, MODE_SPARSE, SimulatedModule)
+from module_software_example import DEFAULT_BAUDRATE, ModuleCommunication
+
+MODES = {
+    'distance': MODE_DISTANCE,
+    'presence': MODE_PRESENCE,
+    'envelope': MODE_ENVELOPE,
+    'iq': MODE_IQ,
+    'sparse': MODE_SPARSE,
+    'power_bins': MODE_POWER_BINS,
+}
+
+LINK_ERRORS = (AssertionError, IndexError, TimeoutError)
+
+
+def _percentile(sorted_values, percent):
+    index = min(len(sorted_values) - 1, int(round(percent / 100 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def _stop(com):
+    com.register_write(0x03, 0)
+    com.reset_input()
+    com.register_write(0x03, 4)
+
+
+def benchmark_latency(com, samples):
+    """
+    Round trip latency of register reads
+    """
+    latencies = []
+    errors = 0
+    for _ in range(samples):
+        start = time.perf_counter()
+        try:
+            com.register_read(0x10)
+        except LINK_ERRORS:
+            errors += 1
+            com.reset_input()
+            continue
+        latencies.append(time.perf_counter() - start)
+
+    latencies.sort()
+    print(f'Register read round trip ({len(latencies)} samples, {errors} errors):')
+    print('    ' + ', '.join(f'p{p}={_percentile(latencies, p) * 1000:.2f} ms'
+                             for p in (50, 90, 99, 100)))
+
+
+def benchmark_register_mode(com, update_rate, duration, notification):
+    """
+    Frames per second when waiting for DATA_READY and reading the result through registers
+    """
+    _stop(com)
+    com.set_status_notification(notification)
+    com.register_write(0x02, MODE_DISTANCE)
+    com.register_write(0x23, int(update_rate * 1000))
+    com.register_write(0x05, 0)
+    com.register_write(0x03, 3)
+    com.wait_start()
+
+    frames = 0
+    errors = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        try:
+            com.register_write(0x03, 4)
+            com.wait_for_data(2)
+            com.register_read(0xB0)
+            frames += 1
+        except LINK_ERRORS:
+            errors += 1
+            com.reset_input()
+    elapsed = time.monotonic() - start
+
+    _stop(com)
+    com.set_status_notification(False)
+    method = 'notification' if notification else 'polling'
+    print(f'Register mode with status {method:>12}: {frames / elapsed:7.1f} frames/s, {errors} errors')
+
+
+def benchmark_streaming(com, module, mode, update_rate, duration):
+    """
+    Streaming frames per second for one mode. Returns the number of client errors
+    """
+    _stop(com)
+    overrun_before = module.stats.frames_overrun if module is not None else 0
+    com.register_write(0x02, MODES[mode])
+    com.register_write(0x23, int(update_rate * 1000))
+    com.register_write(0x05, 1)
+    com.register_write(0x03, 3)
+
+    frames = 0
+    errors = 0
+    received = 0
+    start = time.monotonic()
+    while time.monotonic() - start < duration:
+        try:
+            received += len(com.read_stream())
+            frames += 1
+        except LINK_ERRORS:
+            errors += 1
+            com.reset_input()
+    elapsed = time.monotonic() - start
+
+    _stop(com)
+    overruns = f', {module.stats.frames_overrun - overrun_before} overruns' if module is not None else ''
+    print(f'Streaming {mode:>10}: {frames / elapsed:7.1f} frames/s, '
+          f'{received / elapsed / 1000:7.1f} kB/s, {errors} errors{overruns}')
+    return errors
+
+
+def main():
+    """
+    Main entry function
+    """
+    parser = argparse.ArgumentParser(description='Benchmark the module software protocol against a simulated or real module')
+    parser.add_argument('--port',
+                        help='Serial port of a module to benchmark instead of the simulated module')
+    parser.add_argument('--baudrate', default=DEFAULT_BAUDRATE, type=int,
+                        help='Baudrate to negotiate and to emulate on the link')
+    parser.add_argument('--sim-max-baudrate', dest='sim_max_baudrate', default=DEFAULT_MAX_BAUDRATE, type=int,
+                        help='Maximum baudrate of the simulated module, above 1000000 real modules cannot follow')
+    parser.add_argument('--no-rtscts', action='store_true',
+                        help='Open the port without hardware flow control')
+    parser.add_argument('--duration', default=5, type=float,
+                        help='Duration in seconds of each throughput test')
+    parser.add_argument('--update-rate', default=100, type=float,
+                        help='Update rate in Hz requested from the module')
+    parser.add_argument('--latency-samples', default=200, type=int,
+                        help='Number of register reads for the latency test')
+    parser.add_argument('--modes', nargs='+', choices=MODES.keys(), default=list(MODES.keys()),
+                        help='Streaming modes to benchmark')
+    parser.add_argument('--soak', default=0, type=float,
+                        help='Repeat all streaming modes for this many seconds')
+
+    args = parser.parse_args()
+
+    module = None
+    if args.port is None:
+        master, slave = pty.openpty()
+        tty.setraw(slave)
+        module = SimulatedModule(master, max_baudrate=args.sim_max_baudrate)
+        module.start()
+
+    com = ModuleCommunication(args.port or os.ttyname(slave), not args.no_rtscts)
+    _stop(com)
+
+    if args.baudrate != DEFAULT_BAUDRATE:
+        print(f'Using {com.negotiate_baudrate(args.baudrate)} baud')
+
+    benchmark_latency(com, args.latency_samples)
+
+    for notification in (False, True):
+        benchmark_register_mode(com, args.update_rate, args.duration, notification)
+
+    for mode in args.modes:
+        benchmark_streaming(com, module, mode, args.update_rate, args.duration)
+
+    if args.soak > 0:
+        errors = 0
+        rounds = 0
+        start = time.monotonic()
+        while time.monotonic() - start < args.soak:
+            for mode in args.modes:
+                errors += benchmark_streaming(com, module, mode, args.update_rate, args.duration)
+            rounds += 1
+            module_errors = ''
+            if module is not None:
+                module_errors = (f', {module.stats.frames_overrun} overruns, '
+                                 f'{module.stats.framing_errors} framing errors')
+            print(f'Soak: {rounds} rounds, {time.monotonic() - start:.0f} s, {errors} errors{module_errors}')
+
+    if module is not None:
+        module.stop()
+        os.close(slave)
+        os.close(master)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
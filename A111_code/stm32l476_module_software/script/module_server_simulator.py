@@ -0,0 +1,319 @@
+#!/usr/bin/python3
+#######################################
+# Copyright (c) Acconeer AB, 2020-2022
+# All rights reserved
+# This file is subject to the terms and
+# conditions defined in the file
+# 'LICENSES/license_acconeer.txt',
+# which is part of this source code
+# package.
+#######################################
+"""
+A simulated module software speaking the UART register and streaming
+protocol described in module_software_example.py. It is attached to the
+master side of a pseudo-terminal and the client opens the slave side as a
+normal serial port.
+
+The link speed is emulated by pacing every packet with the time it takes
+to send it at the configured baudrate (10 bits per byte). The maximum
+baudrate advertised in 0x12 is that of the module software, 1 Mbaud, higher
+rates that real hardware does not reach must be asked for explicitly.
+"""
+import os
+import random
+import select
+import struct
+import threading
+import time
+
+START_MARKER = 0xCC
+END_MARKER = 0xCD
+
+# Maximum UART baudrate of the module software
+DEFAULT_MAX_BAUDRATE = 1000000
+
+REG_WRITE_REQUEST = 0xF9
+REG_READ_REQUEST = 0xF8
+BUFFER_READ_REQUEST = 0xFA
+REG_WRITE_RESPONSE = 0xF5
+REG_READ_RESPONSE = 0xF6
+BUFFER_READ_RESPONSE = 0xF7
+STATUS_NOTIFICATION_PACKET = 0xFB
+STREAM_PACKET = 0xFE
+
+MODE_POWER_BINS = 0x01
+MODE_ENVELOPE = 0x02
+MODE_IQ = 0x03
+MODE_SPARSE = 0x04
+MODE_DISTANCE = 0x200
+MODE_PRESENCE = 0x400
+
+STATUS_CREATED = 0x00000001
+STATUS_ACTIVATED = 0x00000002
+STATUS_DATA_READY = 0x00000100
+STATUS_ERROR_MASK = 0xFFFF0000
+STATUS_OVERRUN_ERROR = 0x00010000
+STATUS_FRAMING_ERROR = 0x00100000
+
+CONTROL_CREATE = 0x1
+CONTROL_ACTIVATE = 0x2
+CONTROL_CLEAR_STATUS = 0x4
+
+ENVELOPE_STEP_MM = 0.484
+SPARSE_STEP_MM = 60.0
+PRODUCT_ID = 0xACC0
+SOFTWARE_VERSION = b'simulated_module_server'
+
+
+class SimulatorStats:
+    """
+    Counters kept by the simulated module
+    """
+    def __init__(self):
+        self.requests = 0
+        self.frames_sent = 0
+        self.frames_overrun = 0
+        self.framing_errors = 0
+        self.notifications = 0
+
+
+class SimulatedModule:
+    """
+    Module software simulator running on the master side of a pty
+    """
+    def __init__(self, fd, baudrate=115200, max_baudrate=DEFAULT_MAX_BAUDRATE):
+        self._fd = fd
+        self._baudrate = baudrate
+        self._write_lock = threading.Lock()
+        self._lock = threading.Lock()
+        self._running = False
+        self._threads = []
+        self._rx = bytearray()
+        self._next_frame = None
+        self.stats = SimulatorStats()
+        self._registers = {
+            0x02: MODE_ENVELOPE,
+            0x03: 0,
+            0x05: 0,
+            0x06: 0,
+            0x07: baudrate,
+            0x0C: 0,
+            0x10: PRODUCT_ID,
+            0x12: max_baudrate,
+            0x20: 200,
+            0x21: 500,
+            0x23: 10000,
+            0x40: 16,
+            0x81: 200,
+            0x82: 500,
+            0xB0: 0,
+            0xB1: 0,
+            0xB2: 0,
+        }
+
+    def start(self):
+        """
+        Start serving requests and streaming
+        """
+        self._running = True
+        for target in (self._serve, self._measure):
+            thread = threading.Thread(target=target, daemon=True)
+            thread.start()
+            self._threads.append(thread)
+
+    def stop(self):
+        """
+        Stop the simulator threads
+        """
+        self._running = False
+        for thread in self._threads:
+            thread.join()
+        self._threads = []
+
+    def _wire_time(self, length):
+        return length * 10 / self._baudrate
+
+    def _send(self, packet_type, payload):
+        packet = bytearray([START_MARKER])
+        packet.extend(len(payload).to_bytes(2, byteorder='little'))
+        packet.append(packet_type)
+        packet.extend(payload)
+        packet.append(END_MARKER)
+
+        with self._write_lock:
+            time.sleep(self._wire_time(len(packet)))
+            view = memoryview(packet)
+            while view:
+                written = os.write(self._fd, view)
+                view = view[written:]
+
+    def _set_status(self, set_bits=0, clear_bits=0):
+        with self._lock:
+            old = self._registers[0x06]
+            new = (old | set_bits) & ~clear_bits
+            self._registers[0x06] = new
+            notify = self._registers[0x0C] == 1 and new != old
+
+        if notify:
+            self.stats.notifications += 1
+            self._send(STATUS_NOTIFICATION_PACKET, bytes([0x06]) + new.to_bytes(4, byteorder='little'))
+
+    def _serve(self):
+        while self._running:
+            readable, _, _ = select.select([self._fd], [], [], 0.05)
+            if not readable:
+                continue
+            try:
+                data = os.read(self._fd, 4096)
+            except OSError:
+                return
+            time.sleep(self._wire_time(len(data)))
+            self._rx.extend(data)
+            self._parse()
+
+    def _parse(self):
+        while True:
+            start = self._rx.find(START_MARKER)
+            if start < 0:
+                self._rx.clear()
+                return
+            del self._rx[:start]
+            if len(self._rx) < 4:
+                return
+            length = int.from_bytes(self._rx[1:3], byteorder='little')
+            if len(self._rx) < length + 5:
+                return
+            if self._rx[length + 4] != END_MARKER:
+                self.stats.framing_errors += 1
+                self._set_status(STATUS_FRAMING_ERROR)
+                del self._rx[:1]
+                continue
+            packet_type = self._rx[3]
+            payload = bytes(self._rx[4:length + 4])
+            del self._rx[:length + 5]
+            self.stats.requests += 1
+            self._handle(packet_type, payload)
+
+    def _handle(self, packet_type, payload):
+        if packet_type == REG_WRITE_REQUEST:
+            addr = payload[0]
+            value = int.from_bytes(payload[1:5], byteorder='little')
+            self._send(REG_WRITE_RESPONSE, payload[:5])
+            self._register_write(addr, value)
+        elif packet_type == REG_READ_REQUEST:
+            addr = payload[0]
+            with self._lock:
+                value = self._registers.get(addr, 0)
+            self._send(REG_READ_RESPONSE, bytes([addr]) + value.to_bytes(4, byteorder='little'))
+        elif packet_type == BUFFER_READ_REQUEST:
+            offset = int.from_bytes(payload[1:3], byteorder='little')
+            if offset == 0 and not self._registers[0x03] & CONTROL_CREATE:
+                data = SOFTWARE_VERSION
+            else:
+                data = self._frame_buffer()[offset:]
+            self._send(BUFFER_READ_RESPONSE, bytes([payload[0]]) + data)
+
+    def _register_write(self, addr, value):
+        if addr == 0x03:
+            if value & CONTROL_CLEAR_STATUS:
+                self._set_status(clear_bits=STATUS_DATA_READY | STATUS_ERROR_MASK)
+            if value & CONTROL_CREATE and value & CONTROL_ACTIVATE:
+                self._registers[0x03] = CONTROL_CREATE | CONTROL_ACTIVATE
+                self._next_frame = time.monotonic()
+                self._set_status(STATUS_CREATED | STATUS_ACTIVATED)
+            elif value == 0:
+                self._registers[0x03] = 0
+                self._next_frame = None
+                self._set_status(clear_bits=STATUS_CREATED | STATUS_ACTIVATED | STATUS_DATA_READY)
+        elif addr == 0x07:
+            # Switch after the response, the client follows on its side
+            self._baudrate = value
+            self._registers[0x07] = value
+        elif addr == 0x0C:
+            with self._lock:
+                self._registers[0x0C] = value & 1
+        elif addr != 0x06:
+            with self._lock:
+                self._registers[addr] = value
+
+    def _data_length(self):
+        length_mm = self._registers[0x21]
+        mode = self._registers[0x02]
+        if mode in (MODE_ENVELOPE, MODE_IQ):
+            return int(length_mm / ENVELOPE_STEP_MM)
+        if mode == MODE_SPARSE:
+            return self._registers[0x40] * (int(length_mm / SPARSE_STEP_MM) + 1)
+        if mode == MODE_POWER_BINS:
+            return 5
+        return 0
+
+    def _frame_buffer(self):
+        mode = self._registers[0x02]
+        data_length = self._data_length()
+
+        if mode == MODE_IQ:
+            return struct.pack(f'<{2 * data_length}h',
+                               *(random.randint(-2000, 2000) for _ in range(2 * data_length)))
+        if mode == MODE_DISTANCE:
+            return b''.join(struct.pack('<Hf', random.randint(100, 4000), 0.2 + 0.1 * peak)
+                            for peak in range(self._registers[0xB0]))
+        if mode == MODE_PRESENCE:
+            return struct.pack('<bff', 1, 1.5, 0.8)
+        return struct.pack(f'<{data_length}H', *(random.randint(0, 4000) for _ in range(data_length)))
+
+    def _result_info(self):
+        mode = self._registers[0x02]
+        if mode == MODE_DISTANCE:
+            self._registers[0xB0] = random.randint(0, 4)
+            return {0xB0: self._registers[0xB0]}
+        if mode == MODE_PRESENCE:
+            return {0xB0: 1, 0xB1: 1500, 0xB2: 800}
+        return {0xB0: 0}
+
+    def _stream_payload(self):
+        result_info = bytearray()
+        for addr, value in self._result_info().items():
+            result_info.append(addr)
+            result_info.extend(value.to_bytes(4, byteorder='little'))
+
+        buffer = self._frame_buffer()
+
+        payload = bytearray([0xFD])
+        payload.extend(len(result_info).to_bytes(2, byteorder='little'))
+        payload.extend(result_info)
+        payload.append(0xFE)
+        payload.extend(len(buffer).to_bytes(2, byteorder='little'))
+        payload.extend(buffer)
+        return payload
+
+    def _measure(self):
+        while self._running:
+            next_frame = self._next_frame
+            update_rate = self._registers[0x23] / 1000
+
+            if next_frame is None or update_rate <= 0:
+                time.sleep(0.01)
+                continue
+
+            now = time.monotonic()
+            if now < next_frame:
+                time.sleep(min(next_frame - now, 0.01))
+                continue
+
+            period = 1 / update_rate
+            late = now - next_frame
+            if late > period:
+                # The previous frame still occupied the link when this one was due
+                missed = int(late / period)
+                self.stats.frames_overrun += missed
+                self._set_status(STATUS_OVERRUN_ERROR)
+                next_frame += missed * period
+
+            self._next_frame = next_frame + period
+
+            if self._registers[0x05] == 1:
+                self._send(STREAM_PACKET, self._stream_payload())
+                self.stats.frames_sent += 1
+            else:
+                self._result_info()
+                self._set_status(STATUS_DATA_READY)
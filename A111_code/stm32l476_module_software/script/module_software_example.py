@@ -11,6 +11,22 @@
 """
 This is a simple example how to communicate with the module software
 over the UART interface.
+
+Status changes are polled from the status register (0x06).
+
+With --status-notification the client instead waits for status packets
+pushed by the module. This is not part of the protocol of the module
+software in this package and the module will not answer; it is meant for
+a module software extended with a status notification register (0x0C),
+where writing 1 enables packets of type 0xFB with the same payload as a
+status register read response. The client falls back to polling if the
+register cannot be read back as 1.
+
+The link always starts at 115200 baud. The client then reads the maximum
+baudrate of the module (0x12) and asks it to switch by writing the UART
+baudrate register (0x07). The module answers at the old rate and switches
+afterwards. A link check verifies the new rate and the client falls back to
+lower rates, and finally to 115200, if it fails.
 """
 import argparse
 import struct
@@ -26,27 +42,53 @@ class ModuleError(Exception):
     """
 
 
+STATUS_REGISTER = 0x06
+BAUDRATE_REGISTER = 0x07
+STATUS_NOTIFICATION_REGISTER = 0x0C
+PRODUCT_ID_REGISTER = 0x10
+MAX_BAUDRATE_REGISTER = 0x12
+STATUS_NOTIFICATION_PACKET = 0xFB
+
+DEFAULT_BAUDRATE = 115200
+BAUDRATES = [3000000, 2000000, 1000000, 921600, 460800, 230400, DEFAULT_BAUDRATE]
+LINK_CHECK_READS = 10
+
+# A register read request and its response, start and stop bits included
+REGISTER_READ_BITS = (6 + 10) * 10
+
+
 class ModuleCommunication:
     """
     Simple class to communicate with the module software
     """
     def __init__(self, port, rtscts):
-        self._port = serial.Serial(port, 115200, rtscts=rtscts,
+        self._port = serial.Serial(port, DEFAULT_BAUDRATE, rtscts=rtscts,
                                    exclusive=True, timeout=2)
+        self._status_notification = False
+        self._status = None
 
     def read_packet_type(self, packet_type):
         """
         Read any packet of packet_type. Any packages received with
-        another type is discarded.
+        another type is discarded, except status notifications which
+        update the cached status.
         """
         while True:
             header, payload = self._read_packet()
             if header[3] == packet_type:
                 break
+            if header[3] == STATUS_NOTIFICATION_PACKET:
+                self._update_status(payload)
         return header, payload
 
+    def _update_status(self, payload):
+        assert payload[0] == STATUS_REGISTER
+        self._status = int.from_bytes(payload[1:5], byteorder='little', signed=False)
+
     def _read_packet(self):
         header = self._port.read(4)
+        if len(header) < 4:
+            raise TimeoutError()
         length = int.from_bytes(header[1:3], byteorder='little')
 
         data = self._port.read(length + 1)
@@ -64,6 +106,9 @@ class ModuleCommunication:
         data.extend(value.to_bytes(4, byteorder='little', signed=False))
         data.append(0xcd)
         self._port.write(data)
+        if addr == 0x03:
+            # The main control register changes the status, forget the cached one
+            self._status = None
         _header, payload = self.read_packet_type(0xF5)
         assert payload[0] == addr
 
@@ -94,6 +139,115 @@ class ModuleCommunication:
         assert payload[0] == 0xE8
         return payload[1:]
 
+    def enable_status_notification(self):
+        """
+        Ask the module to push status notifications instead of being polled.
+        Returns False if the module does not support status notifications.
+        """
+        try:
+            self.register_write(STATUS_NOTIFICATION_REGISTER, 1)
+            enabled = self.register_read(STATUS_NOTIFICATION_REGISTER)
+        except TimeoutError:
+            enabled = 0
+
+        self._status_notification = enabled == 1
+        return self._status_notification
+
+    def set_status_notification(self, enable):
+        """
+        Enable or disable status notifications, returns True if they are in use
+        """
+        if enable:
+            return self.enable_status_notification()
+
+        self.register_write(STATUS_NOTIFICATION_REGISTER, 0)
+        self._status_notification = False
+        return False
+
+    def reset_input(self):
+        """
+        Drop any received data not yet read, e.g. after a link error
+        """
+        self._port.reset_input_buffer()
+
+    def _set_baudrate(self, baudrate):
+        """
+        Change the module baudrate and follow with the local port
+        """
+        self.register_write(BAUDRATE_REGISTER, baudrate)
+        # The module switches after the response has been sent
+        self._port.flush()
+        self._port.baudrate = baudrate
+        time.sleep(0.05)
+        self._port.reset_input_buffer()
+
+    def link_check(self, reads=LINK_CHECK_READS):
+        """
+        Verify the link by reading the product id and the software version.
+        Returns False on any timeout or corrupt packet.
+        """
+        timeout = self._port.timeout
+        self._port.timeout = 0.5
+        try:
+            product_id = self.register_read(PRODUCT_ID_REGISTER)
+            for _ in range(reads - 1):
+                if self.register_read(PRODUCT_ID_REGISTER) != product_id:
+                    return False
+            self.buffer_read(0)
+        except (AssertionError, IndexError, TimeoutError):
+            self._port.reset_input_buffer()
+            return False
+        finally:
+            self._port.timeout = timeout
+
+        return True
+
+    def negotiate_baudrate(self, wanted_baudrate=None):
+        """
+        Switch both sides to the highest common baudrate, limited by
+        wanted_baudrate if given. Returns the baudrate in use.
+        """
+        current = self._port.baudrate
+        max_baudrate = self.register_read(MAX_BAUDRATE_REGISTER)
+
+        if wanted_baudrate is not None:
+            max_baudrate = min(max_baudrate, wanted_baudrate)
+
+        candidates = [rate for rate in BAUDRATES if current < rate <= max_baudrate]
+        if max_baudrate not in BAUDRATES and max_baudrate > current:
+            candidates.insert(0, max_baudrate)
+
+        for baudrate in candidates:
+            try:
+                self._set_baudrate(baudrate)
+            except (AssertionError, IndexError, TimeoutError):
+                self.recover_baudrate(baudrate, current)
+                continue
+
+            if self.link_check():
+                return baudrate
+
+            self.recover_baudrate(baudrate, current)
+
+        return current
+
+    def recover_baudrate(self, failed, fallback):
+        """
+        Get back to the fallback baudrate after a failed switch. The module
+        may be at either rate depending on where the switch failed.
+        """
+        for baudrate in (failed, fallback):
+            self._port.baudrate = baudrate
+            self._port.reset_input_buffer()
+            try:
+                self._set_baudrate(fallback)
+            except (AssertionError, IndexError, TimeoutError):
+                self._port.baudrate = fallback
+            if self.link_check(reads=2):
+                return
+
+        raise ModuleError(f"Lost the link while switching to {failed} baud")
+
     def read_stream(self):
         """
         Read a stream of data
@@ -116,27 +270,72 @@ class ModuleCommunication:
         """
         Wait for wanted_bits bits to be set in status register
         """
+        if self._status_notification:
+            self._wait_status_notification(wanted_bits, max_time)
+            return
+
         start = time.monotonic()
 
         while True:
-            status = self.register_read(0x6)
+            status = self.register_read(STATUS_REGISTER)
             self._check_timeout(start, max_time)
             self._check_error(status)
 
             if status & wanted_bits == wanted_bits:
                 return
-            time.sleep(0.1)
+            # Leave the link idle for as long as a read takes, half of it is used for polling
+            time.sleep(REGISTER_READ_BITS / self._port.baudrate)
+
+    def _wait_status_notification(self, wanted_bits, max_time):
+        """
+        Block on status notifications until wanted_bits are set
+        """
+        start = time.monotonic()
+
+        if self._status is None:
+            # Nothing pushed since the last main control write, get a starting point
+            self._status = self.register_read(STATUS_REGISTER)
+
+        timeout = self._port.timeout
+        try:
+            while True:
+                self._check_error(self._status)
+
+                if self._status & wanted_bits == wanted_bits:
+                    return
+
+                remaining = max_time - (time.monotonic() - start)
+                if remaining <= 0:
+                    break
+
+                # Do not block on the port for longer than the time left
+                self._port.timeout = min(timeout, remaining)
+                try:
+                    _header, payload = self.read_packet_type(STATUS_NOTIFICATION_PACKET)
+                except TimeoutError:
+                    break
+                self._update_status(payload)
+        finally:
+            self._port.timeout = timeout
+
+        # A notification may have been lost, read the status register before giving up
+        self._status = self.register_read(STATUS_REGISTER)
+        self._check_error(self._status)
+
+        if self._status & wanted_bits != wanted_bits:
+            raise TimeoutError(f'Status bits 0x{wanted_bits:08X} not set within {max_time} s, '
+                               f'status: 0x{self._status:08X}')
 
     def wait_start(self):
         """
-        Poll status register until created and activated
+        Wait until created and activated
         """
         ACTIVATED_AND_CREATED = 0x3
         self._wait_status_set(ACTIVATED_AND_CREATED, 3)
 
     def wait_for_data(self, max_time):
         """
-        Poll status register until data is ready
+        Wait until data is ready
         """
         DATA_READY = 0x00000100
         self._wait_status_set(DATA_READY, max_time)
@@ -233,7 +432,8 @@ def _streaming_mode_distance(com, duration):
         print('', end='', flush=True)
 
 
-def module_software_test(port, flowcontrol, mode, streaming, duration):
+def module_software_test(port, flowcontrol, mode, streaming, duration,
+                         status_notification=False, baudrate=None):
     """
     A simple example demonstrating how to use the distance detector
     """
@@ -246,6 +446,16 @@ def module_software_test(port, flowcontrol, mode, streaming, duration):
     # Give some time to stop (status register could be polled too)
     time.sleep(0.5)
 
+    if baudrate != DEFAULT_BAUDRATE:
+        used_baudrate = com.negotiate_baudrate(baudrate)
+        print(f'Using {used_baudrate} baud')
+
+    if status_notification:
+        if com.enable_status_notification():
+            print('Using status notifications')
+        else:
+            print('Status notifications not supported, polling status register')
+
     # Clear any errors and status
     com.register_write(0x3, 4)
 
@@ -292,6 +502,39 @@ def module_software_test(port, flowcontrol, mode, streaming, duration):
     com.register_write(0x03, 0)
 
 
+def baudrate_test(port, flowcontrol, reads=1000):
+    """
+    Switch to every baudrate up to the module maximum and count link errors
+    and register read round trips per second
+    """
+    com = ModuleCommunication(port, flowcontrol)
+    com.register_write(0x03, 0)
+    time.sleep(0.5)
+
+    max_baudrate = com.register_read(MAX_BAUDRATE_REGISTER)
+    print(f'Module max baudrate: {max_baudrate}')
+
+    for baudrate in sorted(set(BAUDRATES + [max_baudrate])):
+        if baudrate <= DEFAULT_BAUDRATE:
+            continue
+
+        used = com.negotiate_baudrate(baudrate)
+        if used == baudrate:
+            errors = 0
+            start = time.monotonic()
+            for _ in range(reads):
+                if not com.link_check(reads=1):
+                    errors += 1
+            elapsed = time.monotonic() - start
+            print(f'{baudrate:>8} baud: {errors} errors in {reads} checks, '
+                  f'{reads / elapsed:.0f} checks/s')
+        else:
+            print(f'{baudrate:>8} baud: link check failed')
+
+        if used != DEFAULT_BAUDRATE:
+            com.recover_baudrate(used, DEFAULT_BAUDRATE)
+
+
 def main():
     """
     Main entry function
@@ -307,9 +550,23 @@ def main():
                         help='Use UART streaming protocol')
     parser.add_argument('--mode', choices=['presence', 'distance'],
                         help='Mode to use', default="distance")
+    parser.add_argument('--status-notification', action='store_true',
+                        help='Wait for status notification packets instead of polling the status '
+                             'register. Needs a module software with status notifications')
+    parser.add_argument('--baudrate', type=int,
+                        help='Highest baudrate to negotiate, default is the module maximum. '
+                             f'Use {DEFAULT_BAUDRATE} to skip the negotiation')
+    parser.add_argument('--baudrate-test', action='store_true',
+                        help='Measure which baudrates give an error free link and exit')
 
     args = parser.parse_args()
-    module_software_test(args.port, not args.no_rtscts, args.mode, args.streaming, args.duration)
+
+    if args.baudrate_test:
+        baudrate_test(args.port, not args.no_rtscts)
+        return
+
+    module_software_test(args.port, not args.no_rtscts, args.mode, args.streaming, args.duration,
+                         args.status_notification, args.baudrate)
 
 
 if __name__ == "__main__":